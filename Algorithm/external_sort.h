@@ -0,0 +1,306 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include "sort.h"
+#include <stdio.h>
+#include <stdint.h>
+
+// External merge sort for files of fixed-size records that do not fit in memory:
+// 1. Run formation: the input is read in chunks of memory_budget bytes, each
+//    chunk is sorted with quicksort() and spilled to a temporary file
+//    (tmpfile(), removed automatically when closed).
+// 2. Merge: up to `fan-in` runs are merged at once through a loser tree, so
+//    each output record costs about log2(k) comparisons. If there are more
+//    runs than the fan-in allows, groups of runs are first merged into
+//    longer runs (extra passes).
+// All file I/O is done in large blocks: the memory budget is split into one
+// input buffer per run plus an output buffer, every buffer is at least
+// EXTERNAL_SORT_MIN_BUFFER bytes, and temporary files are unbuffered so
+// that blocks go straight to the OS, whose read-ahead prefetches the next
+// block of each sequential run.
+// The sort is not stable. An input that fits in one run is sorted in
+// memory and written out without temporary files.
+
+#define EXTERNAL_SORT_DEFAULT_MEMORY ((size_t)256 << 20)
+#define EXTERNAL_SORT_MIN_BUFFER ((size_t)256 << 10)
+
+typedef struct {
+    size_t record_size;                             // Bytes per record
+    int (*compar)(const void*, const void*);        // qsort-style comparator
+    size_t memory_budget;                           // Bytes; 0 = EXTERNAL_SORT_DEFAULT_MEMORY
+} ExternalSortConfig;
+
+typedef struct {
+    uint64_t records;           // Records sorted
+    size_t runs;                // Initial runs written
+    int merge_passes;           // Passes over the data after run formation
+    uint64_t bytes_read;        // Including temporary files
+    uint64_t bytes_written;     // Including temporary files
+} ExternalSortStats;
+
+// A sorted run in a temporary file
+typedef struct {
+    FILE *file;
+    uint64_t records;
+} ExternalSortRun;
+
+// Buffered reader over one run during a merge
+typedef struct {
+    FILE *file;
+    char *buf;
+    size_t capacity;            // Records the buffer holds
+    size_t len;                 // Records currently in the buffer
+    size_t pos;                 // Next record in the buffer
+    uint64_t remaining;         // Records still in the file
+} ExternalSortReader;
+
+typedef struct {
+    const ExternalSortConfig *config;
+    ExternalSortReader *readers;
+    size_t *tree;               // tree[0] = winner, tree[1..k) = losers
+    size_t k;
+    bool io_error;
+    ExternalSortStats *stats;
+} ExternalSortMerge;
+
+static inline bool external_sort_write(FILE *out, const void *buf, size_t bytes, ExternalSortStats *stats) {
+    if (bytes && fwrite(buf, 1, bytes, out) != bytes) return false;
+    stats->bytes_written += bytes;
+    return true;
+}
+
+static inline bool external_sort_reader_fill(ExternalSortReader *r, size_t size, ExternalSortStats *stats) {
+    size_t want = r->capacity;
+    if (want > r->remaining) want = (size_t)r->remaining;
+    r->pos = 0;
+    r->len = 0;
+    if (want == 0) return true;
+    if (fread(r->buf, size, want, r->file) != want) return false;
+    r->len = want;
+    r->remaining -= want;
+    stats->bytes_read += (uint64_t)want * size;
+    return true;
+}
+
+static inline bool external_sort_reader_done(const ExternalSortReader *r) {
+    return r->pos == r->len && r->remaining == 0;
+}
+
+// Exhausted runs lose against everything; ties go to the lower run index
+static inline bool external_sort_less(const ExternalSortMerge *m, size_t i, size_t j) {
+    const ExternalSortReader *a = &m->readers[i];
+    const ExternalSortReader *b = &m->readers[j];
+    if (external_sort_reader_done(a)) return false;
+    if (external_sort_reader_done(b)) return true;
+    size_t size = m->config->record_size;
+    int c = m->config->compar(a->buf + a->pos * size, b->buf + b->pos * size);
+    return c < 0 || (c == 0 && i < j);
+}
+
+// Plays the subtree rooted at `node` (leaves are k..2k-1), stores the loser
+// of every match and returns the winner
+static inline size_t external_sort_build(ExternalSortMerge *m, size_t node) {
+    if (node >= m->k) return node - m->k;
+    size_t left = external_sort_build(m, 2 * node);
+    size_t right = external_sort_build(m, 2 * node + 1);
+    if (external_sort_less(m, right, left)) {
+        m->tree[node] = left;
+        return right;
+    }
+    m->tree[node] = right;
+    return left;
+}
+
+// Replays the matches on the path of run w after its head record changed
+static inline void external_sort_replay(ExternalSortMerge *m, size_t w) {
+    for (size_t node = (w + m->k) / 2; node > 0; node /= 2) {
+        if (external_sort_less(m, m->tree[node], w)) {
+            size_t t = m->tree[node];
+            m->tree[node] = w;
+            w = t;
+        }
+    }
+    m->tree[0] = w;
+}
+
+// Merges runs[0..k) into out using `buffer_bytes` per input buffer and for
+// the output buffer. The runs are read from their beginning.
+static inline bool external_sort_merge(ExternalSortRun *runs, size_t k, FILE *out, size_t buffer_bytes,
+                                       const ExternalSortConfig *config, ExternalSortStats *stats) {
+    size_t size = config->record_size;
+    size_t per_buffer = buffer_bytes / size;
+    if (per_buffer == 0) per_buffer = 1;
+
+    ExternalSortMerge m = { config, NULL, NULL, k, false, stats };
+    m.readers = (ExternalSortReader*)calloc(k, sizeof(ExternalSortReader));
+    m.tree = (size_t*)malloc((k > 1 ? k : 2) * sizeof(size_t));
+    char *out_buf = (char*)malloc(per_buffer * size);
+    bool ok = m.readers && m.tree && out_buf;
+    uint64_t total = 0;
+    for (size_t i = 0; ok && i < k; i++) {
+        ExternalSortReader *r = &m.readers[i];
+        r->file = runs[i].file;
+        r->remaining = runs[i].records;
+        r->capacity = per_buffer;
+        total += runs[i].records;
+        r->buf = (char*)malloc(per_buffer * size);
+        ok = r->buf && fseek(r->file, 0, SEEK_SET) == 0 && external_sort_reader_fill(r, size, stats);
+    }
+
+    if (ok) {
+        m.tree[0] = k > 1 ? external_sort_build(&m, 1) : 0;
+        size_t out_len = 0;
+        for (uint64_t t = 0; t < total; t++) {
+            size_t w = m.tree[0];
+            ExternalSortReader *r = &m.readers[w];
+            memcpy(out_buf + out_len * size, r->buf + r->pos * size, size);
+            if (++out_len == per_buffer) {
+                if (!external_sort_write(out, out_buf, out_len * size, stats)) {
+                    ok = false;
+                    break;
+                }
+                out_len = 0;
+            }
+            if (++r->pos == r->len && !external_sort_reader_fill(r, size, stats)) {
+                ok = false;
+                break;
+            }
+            external_sort_replay(&m, w);
+        }
+        ok = ok && external_sort_write(out, out_buf, out_len * size, stats);
+    }
+
+    if (m.readers) {
+        for (size_t i = 0; i < k; i++) free(m.readers[i].buf);
+    }
+    free(m.readers);
+    free(m.tree);
+    free(out_buf);
+    return ok;
+}
+
+static inline void external_sort_close_runs(ExternalSortRun *runs, size_t from, size_t to) {
+    for (size_t i = from; i < to; i++) {
+        if (runs[i].file) fclose(runs[i].file);
+        runs[i].file = NULL;
+    }
+}
+
+// Sorts the records of `in` (read to its end) into `out`. Returns false on
+// allocation or I/O failure, or if the input is not a whole number of
+// records. `stats` may be NULL.
+static inline bool external_sort(FILE *in, FILE *out, const ExternalSortConfig *config, ExternalSortStats *stats) {
+    ExternalSortStats local;
+    if (!stats) stats = &local;
+    memset(stats, 0, sizeof(*stats));
+    size_t size = config->record_size;
+    size_t budget = config->memory_budget ? config->memory_budget : EXTERNAL_SORT_DEFAULT_MEMORY;
+    if (size == 0 || !config->compar) return false;
+    size_t run_records = budget / size;
+    if (run_records == 0) run_records = 1;
+
+    char *buf = (char*)malloc(run_records * size);
+    if (!buf) return false;
+    ExternalSortRun *runs = NULL;
+    size_t num_runs = 0, runs_capacity = 0;
+    bool ok = true;
+
+    // Run formation
+    for (;;) {
+        size_t got = fread(buf, 1, run_records * size, in);
+        if (ferror(in) || got % size != 0) {
+            ok = false;
+            break;
+        }
+        size_t n = got / size;
+        stats->bytes_read += got;
+        stats->records += n;
+        if (n == 0) break;
+        quicksort(buf, n, size, config->compar);
+
+        if (num_runs == 0 && n < run_records) {
+            // Everything fit in memory
+            ok = external_sort_write(out, buf, got, stats);
+            free(buf);
+            stats->runs = 1;
+            return ok && fflush(out) == 0;
+        }
+        if (num_runs == runs_capacity) {
+            size_t cap = runs_capacity ? 2 * runs_capacity : 16;
+            ExternalSortRun *grown = (ExternalSortRun*)realloc(runs, cap * sizeof(ExternalSortRun));
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            runs = grown;
+            runs_capacity = cap;
+        }
+        FILE *f = tmpfile();
+        if (!f) {
+            ok = false;
+            break;
+        }
+        setvbuf(f, NULL, _IONBF, 0);
+        runs[num_runs].file = f;
+        runs[num_runs].records = n;
+        num_runs++;
+        if (!external_sort_write(f, buf, got, stats)) {
+            ok = false;
+            break;
+        }
+        if (n < run_records) break;
+    }
+    free(buf);
+    stats->runs = num_runs;
+
+    // Fan-in: as many runs as fit with one buffer each (plus the output)
+    size_t fan_in = budget / EXTERNAL_SORT_MIN_BUFFER;
+    fan_in = fan_in > 3 ? fan_in - 1 : 2;
+
+    // Intermediate passes until one final merge suffices
+    while (ok && num_runs > fan_in) {
+        size_t merged = 0, start;
+        for (start = 0; ok && start < num_runs; start += fan_in) {
+            size_t k = num_runs - start < fan_in ? num_runs - start : fan_in;
+            ExternalSortRun next = { tmpfile(), 0 };
+            for (size_t i = start; i < start + k; i++) next.records += runs[i].records;
+            ok = next.file != NULL;
+            if (ok) {
+                setvbuf(next.file, NULL, _IONBF, 0);
+                ok = external_sort_merge(runs + start, k, next.file, budget / (k + 1), config, stats);
+            }
+            external_sort_close_runs(runs, start, start + k);
+            runs[merged++] = next;
+        }
+        if (start < num_runs) external_sort_close_runs(runs, start, num_runs);
+        num_runs = merged;
+        stats->merge_passes++;
+    }
+
+    if (ok && num_runs > 0) {
+        ok = external_sort_merge(runs, num_runs, out, budget / (num_runs + 1), config, stats);
+        stats->merge_passes++;
+    }
+    external_sort_close_runs(runs, 0, num_runs);
+    free(runs);
+    return ok && fflush(out) == 0;
+}
+
+// external_sort() on paths; the output file is created or truncated
+static inline bool external_sort_file(const char *input_path, const char *output_path,
+                                      const ExternalSortConfig *config, ExternalSortStats *stats) {
+    FILE *in = fopen(input_path, "rb");
+    if (!in) return false;
+    FILE *out = fopen(output_path, "wb");
+    if (!out) {
+        fclose(in);
+        return false;
+    }
+    setvbuf(in, NULL, _IONBF, 0);
+    setvbuf(out, NULL, _IONBF, 0);
+    bool ok = external_sort(in, out, config, stats);
+    fclose(in);
+    return fclose(out) == 0 && ok;
+}
+
+#endif // EXTERNAL_SORT_H
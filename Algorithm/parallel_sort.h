@@ -0,0 +1,116 @@
+#ifndef PARALLEL_SORT_H
+#define PARALLEL_SORT_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sort.h"
+#include "task_scheduler.h"
+
+// Subarrays smaller than this are sorted sequentially by quicksort()
+#define PARALLEL_SORT_CUTOFF 4096
+
+typedef struct {
+    TaskScheduler *sched;
+    TaskGroup *group;
+    void *base;
+    size_t nmemb;
+    size_t size;
+    int (*compar)(const void*, const void*);
+    int bad_allowed;
+    bool leftmost;
+} ParallelSortJob;
+
+static void parallel_quicksort_task(void *arg);
+
+// Partitions one range and spawns the smaller side as a new task while the
+// current task keeps working on the larger side. Uses the same pivot choice,
+// equal-key handling and bad-partition budget as quicksort() in sort.h; once
+// the budget runs out the range is finished sequentially.
+static void parallel_quicksort_range(TaskScheduler *sched, TaskGroup *group,
+                                     char *base, size_t nmemb, size_t size,
+                                     int (*compar)(const void*, const void*),
+                                     int bad_allowed, bool leftmost) {
+    while (nmemb > PARALLEL_SORT_CUTOFF && bad_allowed > 0) {
+        sort_choose_pivot(base, nmemb, size, compar);
+        if (!leftmost && compar(base - size, base) >= 0) {
+            size_t p = sort_partition_left(base, nmemb, size, compar);
+            base += (p + 1) * size;
+            nmemb -= p + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        size_t pivot_index = sort_partition_right(base, nmemb, size, compar, &already_partitioned);
+        char *right = base + (pivot_index + 1) * size;
+        size_t right_n = nmemb - pivot_index - 1;
+        if (pivot_index < nmemb / 8 || right_n < nmemb / 8) {
+            bad_allowed--;
+            sort_break_patterns(base, pivot_index, size);
+            sort_break_patterns(right, right_n, size);
+        }
+
+        char *small = base, *large = right;
+        size_t small_n = pivot_index, large_n = right_n;
+        bool small_leftmost = leftmost, large_leftmost = false;
+        if (small_n > large_n) {
+            small = right; small_n = right_n; small_leftmost = false;
+            large = base;  large_n = pivot_index; large_leftmost = leftmost;
+        }
+
+        ParallelSortJob *job = (ParallelSortJob*)malloc(sizeof(ParallelSortJob));
+        if (job) {
+            job->sched = sched;
+            job->group = group;
+            job->base = small;
+            job->nmemb = small_n;
+            job->size = size;
+            job->compar = compar;
+            job->bad_allowed = bad_allowed;
+            job->leftmost = small_leftmost;
+            task_spawn(sched, group, parallel_quicksort_task, job);
+        } else {
+            sort_loop(small, small_n, size, compar, bad_allowed > 0 ? bad_allowed : 1, small_leftmost);
+        }
+        base = large;
+        nmemb = large_n;
+        leftmost = large_leftmost;
+    }
+    if (nmemb > 1) sort_loop(base, nmemb, size, compar, bad_allowed > 0 ? bad_allowed : 1, leftmost);
+}
+
+static void parallel_quicksort_task(void *arg) {
+    ParallelSortJob job = *(ParallelSortJob*)arg;
+    free(arg);
+    parallel_quicksort_range(job.sched, job.group, (char*)job.base,
+                             job.nmemb, job.size, job.compar, job.bad_allowed, job.leftmost);
+}
+
+// Sorts like quicksort() but spreads the recursion over the scheduler's
+// workers. The calling thread helps until the whole array is sorted.
+// Floats compared with sort_compare_f32 are turned into int32 keys first, so
+// that, like int32 keys, their leaves are sorted by the SIMD kernels.
+static void parallel_quicksort(TaskScheduler *sched, void *base, size_t nmemb, size_t size,
+                               int (*compar)(const void*, const void*)) {
+    if (sched == NULL || nmemb <= PARALLEL_SORT_CUTOFF) {
+        quicksort(base, nmemb, size, compar);
+        return;
+    }
+    bool f32 = size == sizeof(float) && compar == sort_compare_f32;
+    if (f32) {
+        simd_sort_f32_keys((char*)base, nmemb);
+        compar = sort_compare_i32;
+    }
+    TaskGroup group;
+    task_group_init(&group);
+    parallel_quicksort_range(sched, &group, (char*)base, nmemb, size, compar,
+                             sort_log2(nmemb) + 1, true);
+    task_sync(sched, &group);
+    if (f32) simd_sort_f32_keys((char*)base, nmemb);
+}
+
+#define PARALLEL_SORT_ARRAY(sched, arr, compar) \
+    parallel_quicksort((sched), (arr), sizeof(arr)/sizeof((arr)[0]), sizeof((arr)[0]), (compar))
+
+#endif // PARALLEL_SORT_H
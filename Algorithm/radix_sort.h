@@ -0,0 +1,283 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+// Radix sorts for fixed-width keys and C strings. No comparator is called:
+// - LSD sorts (u32/u64/i64/f32/f64 and records by key) use 8-bit digits. All
+//   digit histograms are built in a single read pass before any scatter, and
+//   a pass whose digit is the same for every key is skipped entirely, so
+//   e.g. u64 keys below 2^24 take 3 passes instead of 8. They are stable.
+// - radix_sort_strings is an MSD sort that buckets on one character at a
+//   time and switches to insertion sort for small buckets.
+// Each function allocates an n-element scratch buffer and returns false if
+// that allocation fails (the input is then left untouched).
+
+#define RADIX_SORT_DIGITS 256
+#define RADIX_SORT_STRING_CUTOFF 32
+
+// Stable LSD pass over keys that need `bytes` digits. `keys`/`vals` are the
+// arrays being sorted, `tmp_keys`/`tmp_vals` the scratch of the same length;
+// vals may be NULL. Keys must agree on every byte above `bytes`. Returns
+// true if the result ended up in the scratch.
+static inline bool radix_lsd_u64(uint64_t *keys, uint64_t *tmp_keys, uint32_t *vals, uint32_t *tmp_vals,
+                                 size_t n, int bytes) {
+    size_t hist[8][RADIX_SORT_DIGITS];
+    memset(hist, 0, (size_t)bytes * sizeof(hist[0]));
+    for (size_t i = 0; i < n; i++) {
+        uint64_t k = keys[i];
+        for (int d = 0; d < bytes; d++) hist[d][(k >> (8 * d)) & 0xff]++;
+    }
+    bool swapped = false;
+    for (int d = 0; d < bytes; d++) {
+        size_t *h = hist[d];
+        if (h[(keys[0] >> (8 * d)) & 0xff] == n) continue;   // Constant digit: skip
+        size_t sum = 0;
+        for (int b = 0; b < RADIX_SORT_DIGITS; b++) {
+            size_t c = h[b];
+            h[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            size_t pos = h[(keys[i] >> (8 * d)) & 0xff]++;
+            tmp_keys[pos] = keys[i];
+            if (vals) tmp_vals[pos] = vals[i];
+        }
+        uint64_t *t = keys; keys = tmp_keys; tmp_keys = t;
+        uint32_t *v = vals; vals = tmp_vals; tmp_vals = v;
+        swapped = !swapped;
+    }
+    return swapped;
+}
+
+// 32-bit version of radix_lsd_u64 without payload
+static inline bool radix_lsd_u32(uint32_t *keys, uint32_t *tmp, size_t n) {
+    size_t hist[4][RADIX_SORT_DIGITS];
+    memset(hist, 0, sizeof(hist));
+    for (size_t i = 0; i < n; i++) {
+        uint32_t k = keys[i];
+        hist[0][k & 0xff]++;
+        hist[1][(k >> 8) & 0xff]++;
+        hist[2][(k >> 16) & 0xff]++;
+        hist[3][k >> 24]++;
+    }
+    bool swapped = false;
+    for (int d = 0; d < 4; d++) {
+        size_t *h = hist[d];
+        if (h[(keys[0] >> (8 * d)) & 0xff] == n) continue;   // Constant digit: skip
+        size_t sum = 0;
+        for (int b = 0; b < RADIX_SORT_DIGITS; b++) {
+            size_t c = h[b];
+            h[b] = sum;
+            sum += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            uint32_t k = keys[i];
+            tmp[h[(k >> (8 * d)) & 0xff]++] = k;
+        }
+        uint32_t *t = keys; keys = tmp; tmp = t;
+        swapped = !swapped;
+    }
+    return swapped;
+}
+
+static inline bool radix_sort_u32(uint32_t *a, size_t n) {
+    if (n < 2) return true;
+    uint32_t *tmp = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (!tmp) return false;
+    if (radix_lsd_u32(a, tmp, n)) memcpy(a, tmp, n * sizeof(uint32_t));
+    free(tmp);
+    return true;
+}
+
+// Number of low-order bytes in which the keys differ; the bytes above are
+// the same for every key and need no histogram at all
+static inline int radix_u64_bytes(const uint64_t *a, size_t n) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; i++) bits |= a[i] ^ a[0];
+    int bytes = 0;
+    while (bits) { bits >>= 8; bytes++; }
+    return bytes;
+}
+
+static inline bool radix_sort_u64(uint64_t *a, size_t n) {
+    if (n < 2) return true;
+    uint64_t *tmp = (uint64_t*)malloc(n * sizeof(uint64_t));
+    if (!tmp) return false;
+    if (radix_lsd_u64(a, tmp, NULL, NULL, n, radix_u64_bytes(a, n))) {
+        memcpy(a, tmp, n * sizeof(uint64_t));
+    }
+    free(tmp);
+    return true;
+}
+
+// Signed keys: flipping the sign bit maps two's complement order to unsigned order
+static inline bool radix_sort_i64(int64_t *a, size_t n) {
+    if (n < 2) return true;
+    uint64_t *u = (uint64_t*)a;
+    for (size_t i = 0; i < n; i++) u[i] ^= (uint64_t)1 << 63;
+    bool ok = radix_sort_u64(u, n);
+    for (size_t i = 0; i < n; i++) u[i] ^= (uint64_t)1 << 63;
+    return ok;
+}
+
+// IEEE-754 keys: negative values have all bits flipped, positive values only
+// the sign bit, which turns float order into unsigned order. -0.0 sorts
+// before +0.0; NaNs go to the front or back according to their sign bit.
+static inline uint32_t radix_f32_to_key(uint32_t bits) {
+    return (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+}
+
+static inline uint32_t radix_key_to_f32(uint32_t key) {
+    return (key & 0x80000000u) ? key ^ 0x80000000u : ~key;
+}
+
+static inline uint64_t radix_f64_to_key(uint64_t bits) {
+    return (bits >> 63) ? ~bits : bits ^ ((uint64_t)1 << 63);
+}
+
+static inline uint64_t radix_key_to_f64(uint64_t key) {
+    return (key >> 63) ? key ^ ((uint64_t)1 << 63) : ~key;
+}
+
+static inline bool radix_sort_f32(float *a, size_t n) {
+    if (n < 2) return true;
+    uint32_t *tmp = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (!tmp) return false;
+    uint32_t *u = (uint32_t*)malloc(n * sizeof(uint32_t));
+    if (!u) {
+        free(tmp);
+        return false;
+    }
+    memcpy(u, a, n * sizeof(float));
+    for (size_t i = 0; i < n; i++) u[i] = radix_f32_to_key(u[i]);
+    uint32_t *sorted = radix_lsd_u32(u, tmp, n) ? tmp : u;
+    for (size_t i = 0; i < n; i++) sorted[i] = radix_key_to_f32(sorted[i]);
+    memcpy(a, sorted, n * sizeof(float));
+    free(u);
+    free(tmp);
+    return true;
+}
+
+static inline bool radix_sort_f64(double *a, size_t n) {
+    if (n < 2) return true;
+    uint64_t *u = (uint64_t*)malloc(n * sizeof(uint64_t));
+    if (!u) return false;
+    memcpy(u, a, n * sizeof(double));
+    for (size_t i = 0; i < n; i++) u[i] = radix_f64_to_key(u[i]);
+    bool ok = radix_sort_u64(u, n);
+    if (ok) {
+        for (size_t i = 0; i < n; i++) u[i] = radix_key_to_f64(u[i]);
+        memcpy(a, u, n * sizeof(double));
+    }
+    free(u);
+    return ok;
+}
+
+// Sorts records of `size` bytes by an unsigned 64-bit key. `key` is called
+// once per record (not once per comparison); the (key, index) pairs are
+// radix sorted and the records are then moved once into place. Stable.
+// Signed or floating-point keys can be mapped with the same transforms as
+// radix_sort_i64/f64 (e.g. radix_f64_to_key) inside the extractor.
+static inline bool radix_sort_by_key(void *base, size_t nmemb, size_t size,
+                                     uint64_t (*key)(const void*)) {
+    if (nmemb < 2 || size == 0) return true;
+    if (nmemb > UINT32_MAX) return false;
+    uint64_t *keys = (uint64_t*)malloc(2 * nmemb * sizeof(uint64_t));
+    uint32_t *idx = (uint32_t*)malloc(2 * nmemb * sizeof(uint32_t));
+    char *out = (char*)malloc(nmemb * size);
+    if (!keys || !idx || !out) {
+        free(keys);
+        free(idx);
+        free(out);
+        return false;
+    }
+    const char *src = (const char*)base;
+    for (size_t i = 0; i < nmemb; i++) {
+        keys[i] = key(src + i * size);
+        idx[i] = (uint32_t)i;
+    }
+    uint32_t *order = idx;
+    if (radix_lsd_u64(keys, keys + nmemb, idx, idx + nmemb, nmemb, radix_u64_bytes(keys, nmemb))) {
+        order = idx + nmemb;
+    }
+    for (size_t i = 0; i < nmemb; i++) memcpy(out + i * size, src + (size_t)order[i] * size, size);
+    memcpy(base, out, nmemb * size);
+    free(keys);
+    free(idx);
+    free(out);
+    return true;
+}
+
+/* ---- MSD radix sort for C strings ---- */
+
+// Character at position d, 0 past the end
+static inline int radix_char_at(const char *s, size_t d) {
+    return (unsigned char)s[d];
+}
+
+static inline void radix_string_insertion(char **a, size_t n, size_t d) {
+    for (size_t i = 1; i < n; i++) {
+        char *s = a[i];
+        size_t j = i;
+        while (j > 0 && strcmp(a[j - 1] + d, s + d) > 0) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = s;
+    }
+}
+
+// Sorts a[0..n), all of which share their first d characters. Recurses on
+// every bucket but the largest, which is handled by the loop, so the
+// recursion depth stays O(log n) even for long common prefixes.
+static inline void radix_msd_strings(char **a, char **aux, size_t n, size_t d) {
+    size_t count[RADIX_SORT_DIGITS + 1];
+    while (n > RADIX_SORT_STRING_CUTOFF) {
+        memset(count, 0, sizeof(count));
+        for (size_t i = 0; i < n; i++) count[radix_char_at(a[i], d) + 1]++;
+        // All strings share this character: step to the next one without copying
+        int only = radix_char_at(a[0], d);
+        if (count[only + 1] == n) {
+            if (only == 0) return;                 // All strings are equal
+            d++;
+            continue;
+        }
+        for (int b = 0; b < RADIX_SORT_DIGITS; b++) count[b + 1] += count[b];
+        size_t start[RADIX_SORT_DIGITS];
+        for (int b = 0; b < RADIX_SORT_DIGITS; b++) start[b] = count[b];
+        for (size_t i = 0; i < n; i++) aux[count[radix_char_at(a[i], d)]++] = a[i];
+        memcpy(a, aux, n * sizeof(char*));
+
+        // Bucket 0 holds strings that ended at d: already in order
+        int largest = 1;
+        for (int b = 2; b < RADIX_SORT_DIGITS; b++) {
+            if (count[b] - start[b] > count[largest] - start[largest]) largest = b;
+        }
+        for (int b = 1; b < RADIX_SORT_DIGITS; b++) {
+            if (b != largest && count[b] - start[b] > 1) {
+                radix_msd_strings(a + start[b], aux, count[b] - start[b], d + 1);
+            }
+        }
+        a += start[largest];
+        n = count[largest] - start[largest];
+        d++;
+    }
+    radix_string_insertion(a, n, d);
+}
+
+// Sorts an array of NUL-terminated strings in strcmp (byte) order
+static inline bool radix_sort_strings(char **a, size_t n) {
+    if (n < 2) return true;
+    char **aux = (char**)malloc(n * sizeof(char*));
+    if (!aux) return false;
+    radix_msd_strings(a, aux, n, 0);
+    free(aux);
+    return true;
+}
+
+#endif // RADIX_SORT_H
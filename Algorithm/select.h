@@ -0,0 +1,234 @@
+#ifndef SELECT_H
+#define SELECT_H
+
+#include "sort.h"
+#include "simd_sort.h"
+#include <stdint.h>
+#include <math.h>
+
+// Selection without a full sort:
+// - nth_element(): introselect on the pivot choice and partitions of sort.h,
+//   continuing only into the side that holds the wanted position. Expected
+//   O(n); after log2(n) unbalanced partitions the range is heapsorted, so
+//   the worst case is O(n log n).
+// - partial_sort(): nth_element() then quicksort() of the first k elements,
+//   O(n + k log k).
+// - TopK: streaming accumulator for the k largest float keys seen, in a
+//   k-element min-heap whose root is the current admission threshold.
+//   topk_push_array() compares 8 (AVX2) or 4 (SSE4.1) keys at a time with
+//   the threshold and only touches the heap for keys that beat it, so a
+//   stream of n keys costs O(n) plus O(log k) per admitted key, in O(k) memory.
+
+// Partially sorts base[0..nmemb) so that base[nth] is the element a full sort
+// would put there, with no greater element before it and no smaller one
+// after it. Does nothing if nth >= nmemb.
+static inline void nth_element(void *base, size_t nmemb, size_t nth, size_t size,
+                               int (*compar)(const void*, const void*)) {
+    if (nth >= nmemb || size == 0) return;
+    char *a = (char*)base;
+    int bad_allowed = sort_log2(nmemb) + 1;
+    bool leftmost = true;
+    for (;;) {
+        if (nmemb < SORT_INSERTION_THRESHOLD) {
+            sort_insertion(a, nmemb, size, compar);
+            return;
+        }
+        sort_choose_pivot(a, nmemb, size, compar);
+
+        // Pivot equal to the predecessor: a[0..p] all equal the pivot
+        if (!leftmost && !SORT_LESS(a - size, a)) {
+            size_t p = sort_partition_left(a, nmemb, size, compar);
+            if (nth <= p) return;
+            a = SORT_AT(a, p + 1, size);
+            nth -= p + 1;
+            nmemb -= p + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        size_t p = sort_partition_right(a, nmemb, size, compar, &already_partitioned);
+        if (nth == p) return;
+        size_t left_n = p, right_n = nmemb - p - 1;
+        if (left_n < nmemb / 8 || right_n < nmemb / 8) {
+            if (--bad_allowed == 0) {
+                sort_heapsort(a, nmemb, size, compar);
+                return;
+            }
+            sort_break_patterns(a, left_n, size);
+            sort_break_patterns(SORT_AT(a, p + 1, size), right_n, size);
+        }
+        if (nth < p) {
+            nmemb = left_n;
+        } else {
+            a = SORT_AT(a, p + 1, size);
+            nth -= p + 1;
+            nmemb = right_n;
+            leftmost = false;
+        }
+    }
+}
+
+// Puts the k smallest elements, sorted, in base[0..k); the order of the
+// rest is unspecified
+static inline void partial_sort(void *base, size_t nmemb, size_t k, size_t size,
+                                int (*compar)(const void*, const void*)) {
+    if (k == 0 || size == 0) return;
+    if (k < nmemb) nth_element(base, nmemb, k - 1, size, compar);
+    else k = nmemb;
+    quicksort(base, k, size, compar);
+}
+
+/* ---- Streaming top-K ---- */
+
+typedef struct {
+    float key;
+    uint64_t id;                // Caller's identifier, e.g. the stream position
+} TopKItem;
+
+typedef struct {
+    TopKItem *heap;             // Min-heap on key, heap[0] = k-th largest so far
+    size_t k;
+    size_t count;
+} TopK;
+
+// Returns NULL if k is 0 or allocation fails
+static inline TopK *topk_create(size_t k) {
+    if (k == 0) return NULL;
+    TopK *tk = (TopK*)malloc(sizeof(TopK));
+    if (!tk) return NULL;
+    tk->heap = (TopKItem*)malloc(k * sizeof(TopKItem));
+    if (!tk->heap) {
+        free(tk);
+        return NULL;
+    }
+    tk->k = k;
+    tk->count = 0;
+    return tk;
+}
+
+static inline void topk_free(TopK *tk) {
+    if (!tk) return;
+    free(tk->heap);
+    free(tk);
+}
+
+static inline void topk_clear(TopK *tk) {
+    tk->count = 0;
+}
+
+static inline size_t topk_size(const TopK *tk) {
+    return tk->count;
+}
+
+// Smallest key still kept once k keys have been seen; keys must be greater
+// to get in. -inf while fewer than k keys are held.
+static inline float topk_threshold(const TopK *tk) {
+    return tk->count < tk->k ? -INFINITY : tk->heap[0].key;
+}
+
+static inline void topk_sift_down(TopKItem *h, size_t n, size_t i, TopKItem item) {
+    size_t child;
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n && h[child + 1].key < h[child].key) child++;
+        if (!(h[child].key < item.key)) break;
+        h[i] = h[child];
+        i = child;
+    }
+    h[i] = item;
+}
+
+// Offers one key; returns true if it is kept. NaN keys are never kept, and
+// on ties with the threshold the earlier key stays.
+static inline bool topk_push(TopK *tk, float key, uint64_t id) {
+    if (key != key) return false;
+    TopKItem item = { key, id };
+    if (tk->count < tk->k) {
+        size_t i = tk->count++;
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!(item.key < tk->heap[parent].key)) break;
+            tk->heap[i] = tk->heap[parent];
+            i = parent;
+        }
+        tk->heap[i] = item;
+        return true;
+    }
+    if (!(key > tk->heap[0].key)) return false;
+    topk_sift_down(tk->heap, tk->count, 0, item);
+    return true;
+}
+
+#ifdef SIMD_SORT_X86
+
+// Offers keys[0..n) (ids first_id, first_id + 1, ...) to a full TopK,
+// skipping vectors in which no key beats the threshold
+static inline SIMD_SORT_TARGET_AVX2 size_t topk_push_avx2(TopK *tk, const float *keys, size_t n,
+                                                          uint64_t first_id) {
+    size_t i = 0;
+    __m256 threshold = _mm256_set1_ps(tk->heap[0].key);
+    for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(keys + i);
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(v, threshold, _CMP_GT_OQ));
+        if (!mask) continue;
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            topk_push(tk, keys[i + lane], first_id + i + lane);
+        }
+        threshold = _mm256_set1_ps(tk->heap[0].key);
+    }
+    return i;
+}
+
+static inline SIMD_SORT_TARGET_SSE41 size_t topk_push_sse(TopK *tk, const float *keys, size_t n,
+                                                          uint64_t first_id) {
+    size_t i = 0;
+    __m128 threshold = _mm_set1_ps(tk->heap[0].key);
+    for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(keys + i);
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_cmpgt_ps(v, threshold));
+        if (!mask) continue;
+        while (mask) {
+            int lane = __builtin_ctz(mask);
+            mask &= mask - 1;
+            topk_push(tk, keys[i + lane], first_id + i + lane);
+        }
+        threshold = _mm_set1_ps(tk->heap[0].key);
+    }
+    return i;
+}
+
+#endif // SIMD_SORT_X86
+
+// Offers keys[0..n) with ids first_id, first_id + 1, ...
+static inline void topk_push_array(TopK *tk, const float *keys, size_t n, uint64_t first_id) {
+    size_t i = 0;
+    while (i < n && tk->count < tk->k) {
+        topk_push(tk, keys[i], first_id + i);
+        i++;
+    }
+#ifdef SIMD_SORT_X86
+    if (i < n) {
+        SimdSortIsa isa = simd_sort_detect();
+        if (isa == SIMD_SORT_ISA_AVX2) i += topk_push_avx2(tk, keys + i, n - i, first_id + i);
+        else if (isa == SIMD_SORT_ISA_SSE41) i += topk_push_sse(tk, keys + i, n - i, first_id + i);
+    }
+#endif
+    for (; i < n; i++) {
+        if (keys[i] > tk->heap[0].key) topk_push(tk, keys[i], first_id + i);
+    }
+}
+
+// Writes the kept items to out[0..size) in descending key order and
+// empties the accumulator; returns the number written
+static inline size_t topk_extract(TopK *tk, TopKItem *out) {
+    size_t n = tk->count;
+    for (size_t end = n; end > 0; end--) {
+        out[end - 1] = tk->heap[0];
+        topk_sift_down(tk->heap, end - 1, 0, tk->heap[end - 1]);
+    }
+    tk->count = 0;
+    return n;
+}
+
+#endif // SELECT_H
@@ -0,0 +1,346 @@
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <stdatomic.h>
+
+#include "graph.h"
+#include "indexed_priority_queue.h"
+#include "radix_heap.h"
+
+// Shortest paths over a WeightedGraph (graph.h) with non-negative integer
+// weights. Every relaxation reads a target and its weight from one
+// WeightedArc, so a vertex's arcs are one sequential scan.
+// - sssp_dijkstra(): Dijkstra on an IndexedPriorityQueue with decrease-key,
+//   O((n + m) log n). Keys are ipq_key_t (double by default), exact for
+//   distances below 2^53.
+// - sssp_dijkstra_radix(): Dijkstra on a RadixHeap with lazy deletion,
+//   O(m + n log C) for distances up to C; distances must fit in 32 bits.
+// - sssp_delta_stepping(): delta-stepping (Meyer and Sanders, J. Algorithms
+//   2003) on a TaskScheduler. Vertices wait in buckets of width delta; all
+//   vertices of the lowest non-empty bucket are relaxed in parallel, with a
+//   compare-and-swap on their targets' distances, until the bucket stays
+//   empty. Each worker keeps its own buckets, so new entries need no
+//   synchronization; the next frontier is gathered from all workers.
+// - sssp_astar(): point-to-point A* with a caller-supplied lower bound on the
+//   remaining distance; without one it is Dijkstra that stops at the target.
+// Unreachable vertices get distance SSSP_INFINITY and parent GRAPH_NO_VERTEX.
+
+#define SSSP_INFINITY UINT64_MAX
+
+// Frontier vertices per delta-stepping task
+#define SSSP_DELTA_GRAIN 1024
+
+// Lower bound on the distance from v to target, for A*. It must never
+// overestimate; a consistent bound (h(u) <= w(u, v) + h(v) for every arc)
+// settles every vertex at most once.
+typedef uint64_t (*SsspHeuristic)(uint32_t v, uint32_t target, void *ctx);
+
+static inline void sssp_init(uint32_t n, uint32_t source, uint64_t *distance, uint32_t *parent) {
+    for (uint32_t v = 0; v < n; v++) distance[v] = SSSP_INFINITY;
+    distance[source] = 0;
+    if (parent) {
+        for (uint32_t v = 0; v < n; v++) parent[v] = GRAPH_NO_VERTEX;
+        parent[source] = source;
+    }
+}
+
+// Distances from source into distance[0..n) and, if parent is not NULL, a
+// shortest-path tree (source is its own parent). Returns false if source is
+// out of range or memory runs out.
+static inline bool sssp_dijkstra(const WeightedGraph *g, uint32_t source, uint64_t *distance, uint32_t *parent) {
+    uint32_t n = g->num_vertices;
+    if (source >= n || n > INT_MAX) return false;
+    IndexedPriorityQueue *pq = ipq_create((int)n);
+    if (!pq) return false;
+    sssp_init(n, source, distance, parent);
+
+    ipq_push(pq, (int)source, 0);
+    int id;
+    ipq_key_t key;
+    while (ipq_pop(pq, &id, &key)) {
+        uint32_t u = (uint32_t)id;
+        uint64_t d = distance[u];
+        const WeightedArc *arc = g->arcs + g->offsets[u];
+        const WeightedArc *end = g->arcs + g->offsets[u + 1];
+        for (; arc < end; arc++) {
+            uint64_t nd = d + arc->weight;
+            if (nd < distance[arc->target]) {
+                distance[arc->target] = nd;
+                if (parent) parent[arc->target] = u;
+                ipq_push_or_decrease(pq, (int)arc->target, (ipq_key_t)nd);
+            }
+        }
+    }
+    ipq_free(pq);
+    return true;
+}
+
+// Same as sssp_dijkstra() with a radix heap. Also returns false if a
+// distance reaches 2^32; the outputs are then incomplete.
+static inline bool sssp_dijkstra_radix(const WeightedGraph *g, uint32_t source, uint64_t *distance,
+                                       uint32_t *parent) {
+    uint32_t n = g->num_vertices;
+    if (source >= n || n > INT_MAX) return false;
+    RadixHeap *pq = rh_create();
+    if (!pq) return false;
+    sssp_init(n, source, distance, parent);
+
+    bool ok = rh_push(pq, 0, (int)source);
+    uint32_t key;
+    int id;
+    while (ok && rh_pop(pq, &key, &id)) {
+        uint32_t u = (uint32_t)id;
+        if (key != distance[u]) continue;       // Stale duplicate
+        const WeightedArc *arc = g->arcs + g->offsets[u];
+        const WeightedArc *end = g->arcs + g->offsets[u + 1];
+        for (; arc < end; arc++) {
+            uint64_t nd = (uint64_t)key + arc->weight;
+            if (nd < distance[arc->target]) {
+                if (nd > UINT32_MAX || !rh_push(pq, (uint32_t)nd, (int)arc->target)) {
+                    ok = false;
+                    break;
+                }
+                distance[arc->target] = nd;
+                if (parent) parent[arc->target] = u;
+            }
+        }
+    }
+    rh_free(pq);
+    return ok;
+}
+
+/* ---- Delta-stepping ---- */
+
+typedef struct {
+    uint32_t *items;
+    size_t count;
+    size_t capacity;
+} SsspBin;
+
+// Buckets of one worker, indexed by distance / delta
+typedef struct {
+    SsspBin *bins;
+    size_t num_bins;
+} SsspBins;
+
+typedef struct {
+    const WeightedGraph *g;
+    TaskScheduler *sched;
+    _Atomic uint64_t *dist;
+    uint64_t *out;
+    uint64_t delta;
+    size_t current;             // Bucket being relaxed
+    const uint32_t *frontier;
+    SsspBins *local;            // Slot 0 for the calling thread, 1 + id for each worker
+    atomic_bool failed;
+} SsspDelta;
+
+static inline SsspBins *sssp_local_bins(SsspDelta *d) {
+    TaskWorker *w = ts_current_worker;
+    return &d->local[w != NULL && w->scheduler == d->sched ? (size_t)w->id + 1 : 0];
+}
+
+static inline bool sssp_bin_push(SsspBins *lb, size_t bin, uint32_t v) {
+    if (bin >= lb->num_bins) {
+        size_t num = lb->num_bins * 2 > bin + 1 ? lb->num_bins * 2 : bin + 1;
+        if (num < 16) num = 16;
+        SsspBin *bins = (SsspBin*)realloc(lb->bins, num * sizeof(SsspBin));
+        if (!bins) return false;
+        memset(bins + lb->num_bins, 0, (num - lb->num_bins) * sizeof(SsspBin));
+        lb->bins = bins;
+        lb->num_bins = num;
+    }
+    SsspBin *b = &lb->bins[bin];
+    if (b->count == b->capacity) {
+        size_t capacity = b->capacity ? b->capacity * 2 : 64;
+        uint32_t *items = (uint32_t*)realloc(b->items, capacity * sizeof(uint32_t));
+        if (!items) return false;
+        b->items = items;
+        b->capacity = capacity;
+    }
+    b->items[b->count++] = v;
+    return true;
+}
+
+static inline void sssp_delta_init(void *arg, size_t begin, size_t end) {
+    SsspDelta *d = (SsspDelta*)arg;
+    for (size_t v = begin; v < end; v++) atomic_store_explicit(&d->dist[v], SSSP_INFINITY, memory_order_relaxed);
+}
+
+static inline void sssp_delta_store(void *arg, size_t begin, size_t end) {
+    SsspDelta *d = (SsspDelta*)arg;
+    for (size_t v = begin; v < end; v++) d->out[v] = atomic_load_explicit(&d->dist[v], memory_order_relaxed);
+}
+
+static inline void sssp_delta_relax(void *arg, size_t begin, size_t end) {
+    SsspDelta *d = (SsspDelta*)arg;
+    const WeightedGraph *g = d->g;
+    SsspBins *lb = sssp_local_bins(d);
+    uint64_t low = d->current * d->delta;
+    for (size_t i = begin; i < end; i++) {
+        uint32_t u = d->frontier[i];
+        uint64_t du = atomic_load_explicit(&d->dist[u], memory_order_relaxed);
+        if (du < low) continue;                 // Settled in an earlier bucket
+        const WeightedArc *arc = g->arcs + g->offsets[u];
+        const WeightedArc *arc_end = g->arcs + g->offsets[u + 1];
+        for (; arc < arc_end; arc++) {
+            uint64_t nd = du + arc->weight;
+            uint64_t old = atomic_load_explicit(&d->dist[arc->target], memory_order_relaxed);
+            while (nd < old) {
+                if (atomic_compare_exchange_weak_explicit(&d->dist[arc->target], &old, nd,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                    if (!sssp_bin_push(lb, (size_t)(nd / d->delta), arc->target)) {
+                        atomic_store_explicit(&d->failed, true, memory_order_relaxed);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Distances from source into distance[0..n) with bucket width delta (0 picks
+// the average arc weight). Larger deltas mean fewer, larger rounds and more
+// wasted relaxations. Runs sequentially when sched is NULL. Returns false if
+// source is out of range or memory runs out.
+static inline bool sssp_delta_stepping(const WeightedGraph *g, uint32_t source, uint64_t delta,
+                                       uint64_t *distance, TaskScheduler *sched) {
+    uint32_t n = g->num_vertices;
+    if (source >= n) return false;
+    if (delta == 0) {
+        uint64_t total = 0;
+        for (uint64_t i = 0; i < g->num_arcs; i++) total += g->arcs[i].weight;
+        delta = g->num_arcs ? total / g->num_arcs : 1;
+        if (delta == 0) delta = 1;
+    }
+
+    SsspDelta d;
+    d.g = g;
+    d.sched = sched;
+    d.out = distance;
+    d.delta = delta;
+    atomic_init(&d.failed, false);
+    size_t slots = sched ? (size_t)task_scheduler_num_workers(sched) + 1 : 1;
+    size_t frontier_capacity = 1024;
+    uint32_t *frontier = (uint32_t*)malloc(frontier_capacity * sizeof(uint32_t));
+    d.dist = (_Atomic uint64_t*)malloc((size_t)n * sizeof(_Atomic uint64_t));
+    d.local = (SsspBins*)calloc(slots, sizeof(SsspBins));
+    bool ok = frontier && d.dist && d.local;
+
+    if (ok) {
+        graph_parallel_for(sched, n, SSSP_DELTA_GRAIN * 64, sssp_delta_init, &d);
+        atomic_store_explicit(&d.dist[source], 0, memory_order_relaxed);
+        frontier[0] = source;
+        size_t frontier_size = 1;
+        d.current = 0;
+        for (;;) {
+            d.frontier = frontier;
+            graph_parallel_for(sched, frontier_size, SSSP_DELTA_GRAIN, sssp_delta_relax, &d);
+            if (atomic_load(&d.failed)) {
+                ok = false;
+                break;
+            }
+
+            // Lowest non-empty bucket of any worker; relaxing never adds below the current one
+            size_t next = SIZE_MAX;
+            for (size_t s = 0; s < slots; s++) {
+                for (size_t b = d.current; b < d.local[s].num_bins && b < next; b++) {
+                    if (d.local[s].bins[b].count) {
+                        next = b;
+                        break;
+                    }
+                }
+            }
+            if (next == SIZE_MAX) break;
+
+            size_t total = 0;
+            for (size_t s = 0; s < slots; s++) {
+                if (next < d.local[s].num_bins) total += d.local[s].bins[next].count;
+            }
+            if (total > frontier_capacity) {
+                while (frontier_capacity < total) frontier_capacity *= 2;
+                uint32_t *grown = (uint32_t*)realloc(frontier, frontier_capacity * sizeof(uint32_t));
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                frontier = grown;
+            }
+            frontier_size = 0;
+            for (size_t s = 0; s < slots; s++) {
+                if (next >= d.local[s].num_bins || d.local[s].bins[next].count == 0) continue;
+                SsspBin *b = &d.local[s].bins[next];
+                memcpy(frontier + frontier_size, b->items, b->count * sizeof(uint32_t));
+                frontier_size += b->count;
+                b->count = 0;
+            }
+            d.current = next;
+        }
+        if (ok) graph_parallel_for(sched, n, SSSP_DELTA_GRAIN * 64, sssp_delta_store, &d);
+    }
+
+    if (d.local) {
+        for (size_t s = 0; s < slots; s++) {
+            for (size_t b = 0; b < d.local[s].num_bins; b++) free(d.local[s].bins[b].items);
+            free(d.local[s].bins);
+        }
+    }
+    free(d.local);
+    free((void*)d.dist);
+    free(frontier);
+    return ok;
+}
+
+/* ---- A* ---- */
+
+// Shortest path from source to target. Stores its length in *length
+// (SSSP_INFINITY if target is unreachable) and, if parent is not NULL, fills
+// parent[0..n) so that following parent from target leads back to source
+// (vertices not on a found path may hold stale or GRAPH_NO_VERTEX entries).
+// A NULL heuristic means 0, i.e. Dijkstra that stops at the target. Returns
+// false if an endpoint is out of range or memory runs out.
+static inline bool sssp_astar(const WeightedGraph *g, uint32_t source, uint32_t target,
+                              SsspHeuristic heuristic, void *ctx, uint64_t *length, uint32_t *parent) {
+    uint32_t n = g->num_vertices;
+    if (source >= n || target >= n || n > INT_MAX) return false;
+    uint64_t *best = (uint64_t*)malloc((size_t)n * sizeof(uint64_t));
+    IndexedPriorityQueue *pq = ipq_create((int)n);
+    if (!best || !pq) {
+        free(best);
+        ipq_free(pq);
+        return false;
+    }
+    sssp_init(n, source, best, parent);
+
+    ipq_push(pq, (int)source, (ipq_key_t)(heuristic ? heuristic(source, target, ctx) : 0));
+    int id;
+    ipq_key_t key;
+    while (ipq_pop(pq, &id, &key)) {
+        uint32_t u = (uint32_t)id;
+        if (u == target) break;
+        uint64_t d = best[u];
+        const WeightedArc *arc = g->arcs + g->offsets[u];
+        const WeightedArc *end = g->arcs + g->offsets[u + 1];
+        for (; arc < end; arc++) {
+            uint64_t nd = d + arc->weight;
+            if (nd < best[arc->target]) {
+                best[arc->target] = nd;
+                if (parent) parent[arc->target] = u;
+                uint64_t f = nd + (heuristic ? heuristic(arc->target, target, ctx) : 0);
+                // Reopens a settled vertex if an inconsistent heuristic found a shorter path to it
+                ipq_push_or_decrease(pq, (int)arc->target, (ipq_key_t)f);
+            }
+        }
+    }
+    *length = best[target];
+    free(best);
+    ipq_free(pq);
+    return true;
+}
+
+#endif // SHORTEST_PATH_H
@@ -0,0 +1,483 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include "sort.h"
+#include <stdint.h>
+
+// In-place sorts for int32_t and float arrays built from SIMD kernels:
+// - blocks of up to SIMD_SORT_BLOCK elements are padded to 8/16/32/64 and
+//   sorted with bitonic networks held entirely in vector registers
+// - larger ranges are split by a vectorized partition: each vector of keys
+//   is compared with the pivot and its lanes are permuted (through a
+//   lookup table) so that the left-going keys are stored on the left end
+//   and the right-going keys on the right end, without branches
+// - pivot choice, pattern breaking and the heapsort fallback are the ones
+//   of sort.h, so the worst case stays O(n log n)
+// AVX2 is used when the CPU has it, otherwise SSE4.1, otherwise (or on
+// non-x86 targets, or with SIMD_SORT_SCALAR_ONLY defined) a SORT_DEFINE
+// sort. The choice is made at run time, no -mavx2 flag is needed.
+//
+// sort.h includes this header and uses it as its engine for primitive keys:
+// sort_loop hands int32 keys compared with sort_compare_i32 to
+// simd_sort_loop_i32, quicksort() hands floats compared with
+// sort_compare_f32 to simd_sort_f32, and SORT_DEFINE_I32/SORT_DEFINE_F32
+// call them directly.
+//
+// Floats are sorted by IEEE-754 total order: -NaN < -inf < ... < -0.0 <
+// +0.0 < ... < +inf < +NaN. Internally each float is mapped to an int32
+// key with the same order, so the integer kernels serve both types.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(SIMD_SORT_SCALAR_ONLY)
+#define SIMD_SORT_X86 1
+#include <immintrin.h>
+#define SIMD_SORT_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_SORT_TARGET_SSE41 __attribute__((target("sse4.1")))
+#endif
+
+#define SIMD_SORT_BLOCK 64
+
+typedef enum {
+    SIMD_SORT_ISA_SCALAR,
+    SIMD_SORT_ISA_SSE41,
+    SIMD_SORT_ISA_AVX2
+} SimdSortIsa;
+
+// Best instruction set available on this CPU
+static inline SimdSortIsa simd_sort_detect(void) {
+#ifdef SIMD_SORT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_SORT_ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SIMD_SORT_ISA_SSE41;
+#endif
+    return SIMD_SORT_ISA_SCALAR;
+}
+
+// Maps float bits to an int32 with the same order (total order above):
+// negative floats get their magnitude bits flipped. The map is its own inverse.
+static inline int32_t simd_sort_f32_key(int32_t bits) {
+    return (int32_t)((uint32_t)bits ^ ((uint32_t)-(int32_t)(bits < 0) >> 1));
+}
+
+static inline int32_t simd_sort_f32_bits(float f) {
+    int32_t bits;
+    memcpy(&bits, &f, sizeof bits);
+    return simd_sort_f32_key(bits);
+}
+
+#define SIMD_SORT_F32_LESS(a, b) (simd_sort_f32_bits(a) < simd_sort_f32_bits(b))
+
+SORT_DEFINE(simd_sort_scalar_i32, int32_t, SORT_NATURAL_LESS)
+SORT_DEFINE(simd_sort_scalar_f32, float, SIMD_SORT_F32_LESS)
+
+// Keys are accessed through memcpy (and unaligned vector loads), so the
+// same code can work on float storage holding int32 keys.
+static inline int32_t simd_sort_get(const char *base, size_t i) {
+    int32_t v;
+    memcpy(&v, base + i * sizeof(int32_t), sizeof v);
+    return v;
+}
+
+static inline void simd_sort_set(char *base, size_t i, int32_t v) {
+    memcpy(base + i * sizeof(int32_t), &v, sizeof v);
+}
+
+// Maps float bits to keys and back in place (simd_sort_f32_key is an involution)
+static inline void simd_sort_f32_keys(char *base, size_t n) {
+    for (size_t i = 0; i < n; i++) simd_sort_set(base, i, simd_sort_f32_key(simd_sort_get(base, i)));
+}
+
+#ifdef SIMD_SORT_X86
+
+static inline int simd_sort_compare(const void *a, const void *b) {
+    int32_t x, y;
+    memcpy(&x, a, sizeof x);
+    memcpy(&y, b, sizeof y);
+    return (x > y) - (x < y);
+}
+
+static inline int32_t simd_sort_median3(int32_t a, int32_t b, int32_t c) {
+    if (a > b) { int32_t t = a; a = b; b = t; }
+    if (b > c) b = c;
+    return a > b ? a : b;
+}
+
+// Median of 3, or ninther for large ranges; the keys are not moved
+static inline int32_t simd_sort_pivot(const char *base, size_t n) {
+    size_t mid = n / 2;
+    if (n > SORT_NINTHER_THRESHOLD) {
+        int32_t a = simd_sort_median3(simd_sort_get(base, 0), simd_sort_get(base, mid),
+                                      simd_sort_get(base, n - 1));
+        int32_t b = simd_sort_median3(simd_sort_get(base, 1), simd_sort_get(base, mid - 1),
+                                      simd_sort_get(base, n - 2));
+        int32_t c = simd_sort_median3(simd_sort_get(base, 2), simd_sort_get(base, mid + 1),
+                                      simd_sort_get(base, n - 3));
+        return simd_sort_median3(a, b, c);
+    }
+    return simd_sort_median3(simd_sort_get(base, 0), simd_sort_get(base, mid), simd_sort_get(base, n - 1));
+}
+
+// Final step of both vector partitions: the keys still held in `rest` are
+// written one by one into the free gap [lw, rw), which has exactly `count`
+// slots. Returns the split point.
+static inline size_t simd_sort_partition_rest(char *base, size_t lw, size_t rw, const int32_t *rest,
+                                              size_t count, int32_t pivot, bool le) {
+    for (size_t i = 0; i < count; i++) {
+        int32_t x = rest[i];
+        bool right = le ? x > pivot : x >= pivot;
+        if (right) simd_sort_set(base, --rw, x);
+        else simd_sort_set(base, lw++, x);
+    }
+    return lw;
+}
+
+/* ---- AVX2: 8 lanes ---- */
+
+// For every mask of right-going lanes, the lane order that puts the
+// left-going lanes first, one lane index per nibble
+static const uint32_t simd_sort_avx2_perm[256] = {
+    0x76543210, 0x07654321, 0x17654320, 0x10765432, 0x27654310, 0x20765431, 0x21765430, 0x21076543,
+    0x37654210, 0x30765421, 0x31765420, 0x31076542, 0x32765410, 0x32076541, 0x32176540, 0x32107654,
+    0x47653210, 0x40765321, 0x41765320, 0x41076532, 0x42765310, 0x42076531, 0x42176530, 0x42107653,
+    0x43765210, 0x43076521, 0x43176520, 0x43107652, 0x43276510, 0x43207651, 0x43217650, 0x43210765,
+    0x57643210, 0x50764321, 0x51764320, 0x51076432, 0x52764310, 0x52076431, 0x52176430, 0x52107643,
+    0x53764210, 0x53076421, 0x53176420, 0x53107642, 0x53276410, 0x53207641, 0x53217640, 0x53210764,
+    0x54763210, 0x54076321, 0x54176320, 0x54107632, 0x54276310, 0x54207631, 0x54217630, 0x54210763,
+    0x54376210, 0x54307621, 0x54317620, 0x54310762, 0x54327610, 0x54320761, 0x54321760, 0x54321076,
+    0x67543210, 0x60754321, 0x61754320, 0x61075432, 0x62754310, 0x62075431, 0x62175430, 0x62107543,
+    0x63754210, 0x63075421, 0x63175420, 0x63107542, 0x63275410, 0x63207541, 0x63217540, 0x63210754,
+    0x64753210, 0x64075321, 0x64175320, 0x64107532, 0x64275310, 0x64207531, 0x64217530, 0x64210753,
+    0x64375210, 0x64307521, 0x64317520, 0x64310752, 0x64327510, 0x64320751, 0x64321750, 0x64321075,
+    0x65743210, 0x65074321, 0x65174320, 0x65107432, 0x65274310, 0x65207431, 0x65217430, 0x65210743,
+    0x65374210, 0x65307421, 0x65317420, 0x65310742, 0x65327410, 0x65320741, 0x65321740, 0x65321074,
+    0x65473210, 0x65407321, 0x65417320, 0x65410732, 0x65427310, 0x65420731, 0x65421730, 0x65421073,
+    0x65437210, 0x65430721, 0x65431720, 0x65431072, 0x65432710, 0x65432071, 0x65432170, 0x65432107,
+    0x76543210, 0x70654321, 0x71654320, 0x71065432, 0x72654310, 0x72065431, 0x72165430, 0x72106543,
+    0x73654210, 0x73065421, 0x73165420, 0x73106542, 0x73265410, 0x73206541, 0x73216540, 0x73210654,
+    0x74653210, 0x74065321, 0x74165320, 0x74106532, 0x74265310, 0x74206531, 0x74216530, 0x74210653,
+    0x74365210, 0x74306521, 0x74316520, 0x74310652, 0x74326510, 0x74320651, 0x74321650, 0x74321065,
+    0x75643210, 0x75064321, 0x75164320, 0x75106432, 0x75264310, 0x75206431, 0x75216430, 0x75210643,
+    0x75364210, 0x75306421, 0x75316420, 0x75310642, 0x75326410, 0x75320641, 0x75321640, 0x75321064,
+    0x75463210, 0x75406321, 0x75416320, 0x75410632, 0x75426310, 0x75420631, 0x75421630, 0x75421063,
+    0x75436210, 0x75430621, 0x75431620, 0x75431062, 0x75432610, 0x75432061, 0x75432160, 0x75432106,
+    0x76543210, 0x76054321, 0x76154320, 0x76105432, 0x76254310, 0x76205431, 0x76215430, 0x76210543,
+    0x76354210, 0x76305421, 0x76315420, 0x76310542, 0x76325410, 0x76320541, 0x76321540, 0x76321054,
+    0x76453210, 0x76405321, 0x76415320, 0x76410532, 0x76425310, 0x76420531, 0x76421530, 0x76421053,
+    0x76435210, 0x76430521, 0x76431520, 0x76431052, 0x76432510, 0x76432051, 0x76432150, 0x76432105,
+    0x76543210, 0x76504321, 0x76514320, 0x76510432, 0x76524310, 0x76520431, 0x76521430, 0x76521043,
+    0x76534210, 0x76530421, 0x76531420, 0x76531042, 0x76532410, 0x76532041, 0x76532140, 0x76532104,
+    0x76543210, 0x76540321, 0x76541320, 0x76541032, 0x76542310, 0x76542031, 0x76542130, 0x76542103,
+    0x76543210, 0x76543021, 0x76543120, 0x76543102, 0x76543210, 0x76543201, 0x76543210, 0x76543210,
+};
+
+// One compare-exchange layer: lanes in `mask` take the max of themselves and
+// their partner in p, the others the min
+#define SIMD_AVX2_STEP(v, p, mask) _mm256_blend_epi32(_mm256_min_epi32((v), (p)), _mm256_max_epi32((v), (p)), (mask))
+
+// Sorts the 8 lanes of v (bitonic network, 6 layers)
+static inline SIMD_SORT_TARGET_AVX2 __m256i simd_avx2_sort8(__m256i v) {
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0x66);
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0x4E), 0x3C);
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0x5A);
+    v = SIMD_AVX2_STEP(v, _mm256_permute2x128_si256(v, v, 1), 0xF0);
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0x4E), 0xCC);
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0xAA);
+    return v;
+}
+
+// Sorts a bitonic vector
+static inline SIMD_SORT_TARGET_AVX2 __m256i simd_avx2_clean8(__m256i v) {
+    v = SIMD_AVX2_STEP(v, _mm256_permute2x128_si256(v, v, 1), 0xF0);
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0x4E), 0xCC);
+    v = SIMD_AVX2_STEP(v, _mm256_shuffle_epi32(v, 0xB1), 0xAA);
+    return v;
+}
+
+// Sorts buf[0..8k) for k = 1, 2, 4 or 8: every vector is sorted, then runs
+// are merged pairwise (second run reversed, half-cleaners across vectors,
+// then within each vector)
+static inline SIMD_SORT_TARGET_AVX2 void simd_avx2_sort_block(int32_t *buf, size_t k) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i v[8];
+    for (size_t i = 0; i < k; i++) v[i] = simd_avx2_sort8(_mm256_loadu_si256((const __m256i*)(buf + 8 * i)));
+    for (size_t w = 1; w < k; w *= 2) {
+        for (size_t s = 0; s < k; s += 2 * w) {
+            for (size_t i = 0; i < w / 2; i++) {
+                __m256i t = v[s + w + i];
+                v[s + w + i] = v[s + 2 * w - 1 - i];
+                v[s + 2 * w - 1 - i] = t;
+            }
+            for (size_t i = 0; i < w; i++) v[s + w + i] = _mm256_permutevar8x32_epi32(v[s + w + i], reverse);
+            for (size_t d = w; d > 0; d /= 2) {
+                for (size_t i = s; i < s + 2 * w; i++) {
+                    if ((i - s) & d) continue;
+                    __m256i lo = _mm256_min_epi32(v[i], v[i + d]);
+                    v[i + d] = _mm256_max_epi32(v[i], v[i + d]);
+                    v[i] = lo;
+                }
+            }
+            for (size_t i = s; i < s + 2 * w; i++) v[i] = simd_avx2_clean8(v[i]);
+        }
+    }
+    for (size_t i = 0; i < k; i++) _mm256_storeu_si256((__m256i*)(buf + 8 * i), v[i]);
+}
+
+// Sorts base[0..n), n <= SIMD_SORT_BLOCK, padded with INT32_MAX
+static inline SIMD_SORT_TARGET_AVX2 void simd_avx2_sort_small(char *base, size_t n) {
+    int32_t buf[SIMD_SORT_BLOCK];
+    size_t k = 1;
+    while (8 * k < n) k *= 2;
+    memcpy(buf, base, n * sizeof(int32_t));
+    for (size_t i = n; i < 8 * k; i++) buf[i] = INT32_MAX;
+    simd_avx2_sort_block(buf, k);
+    memcpy(base, buf, n * sizeof(int32_t));
+}
+
+// Partitions base[0..n), n >= 16, into keys < pivot (<= pivot if le) and the
+// rest; returns the number of left keys. The first and last vectors are
+// held back so that every vector store lands in already-read space; each
+// step reads from the end with less free space.
+static inline SIMD_SORT_TARGET_AVX2 size_t simd_avx2_partition(char *base, size_t n, int32_t pivot, bool le) {
+    const __m256i pv = _mm256_set1_epi32(pivot);
+    const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+    const __m256i nibble = _mm256_set1_epi32(0xF);
+    int32_t rest[24];
+    _mm256_storeu_si256((__m256i*)rest, _mm256_loadu_si256((const __m256i*)base));
+    _mm256_storeu_si256((__m256i*)(rest + 8), _mm256_loadu_si256((const __m256i*)(base + 4 * (n - 8))));
+    size_t l = 8, r = n - 8, lw = 0, rw = n;
+    while (r - l >= 8) {
+        __m256i v;
+        if (l - lw <= rw - r) {
+            v = _mm256_loadu_si256((const __m256i*)(base + 4 * l));
+            l += 8;
+        } else {
+            r -= 8;
+            v = _mm256_loadu_si256((const __m256i*)(base + 4 * r));
+        }
+        __m256i right = le ? _mm256_cmpgt_epi32(v, pv)
+                           : _mm256_xor_si256(_mm256_cmpgt_epi32(pv, v), _mm256_set1_epi32(-1));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(right));
+        __m256i perm = _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)simd_sort_avx2_perm[mask]), shifts),
+                                        nibble);
+        v = _mm256_permutevar8x32_epi32(v, perm);
+        size_t count_right = (size_t)__builtin_popcount(mask);
+        _mm256_storeu_si256((__m256i*)(base + 4 * lw), v);
+        _mm256_storeu_si256((__m256i*)(base + 4 * (rw - 8)), v);
+        lw += 8 - count_right;
+        rw -= count_right;
+    }
+    memcpy(rest + 16, base + 4 * l, (r - l) * sizeof(int32_t));
+    return simd_sort_partition_rest(base, lw, rw, rest, 16 + (r - l), pivot, le);
+}
+
+/* ---- SSE4.1: 4 lanes ---- */
+
+// Byte shuffles for _mm_shuffle_epi8, same layout as simd_sort_avx2_perm
+static const uint8_t simd_sort_sse_perm[16][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3 },
+    {  0,  1,  2,  3,  8,  9, 10, 11, 12, 13, 14, 15,  4,  5,  6,  7 },
+    {  8,  9, 10, 11, 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7 },
+    {  0,  1,  2,  3,  4,  5,  6,  7, 12, 13, 14, 15,  8,  9, 10, 11 },
+    {  4,  5,  6,  7, 12, 13, 14, 15,  0,  1,  2,  3,  8,  9, 10, 11 },
+    {  0,  1,  2,  3, 12, 13, 14, 15,  4,  5,  6,  7,  8,  9, 10, 11 },
+    { 12, 13, 14, 15,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  4,  5,  6,  7,  8,  9, 10, 11,  0,  1,  2,  3, 12, 13, 14, 15 },
+    {  0,  1,  2,  3,  8,  9, 10, 11,  4,  5,  6,  7, 12, 13, 14, 15 },
+    {  8,  9, 10, 11,  0,  1,  2,  3,  4,  5,  6,  7, 12, 13, 14, 15 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  4,  5,  6,  7,  0,  1,  2,  3,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+};
+
+#define SIMD_SSE_STEP(v, p, mask) \
+    _mm_castps_si128(_mm_blend_ps(_mm_castsi128_ps(_mm_min_epi32((v), (p))), \
+                                  _mm_castsi128_ps(_mm_max_epi32((v), (p))), (mask)))
+
+static inline SIMD_SORT_TARGET_SSE41 __m128i simd_sse_sort4(__m128i v) {
+    v = SIMD_SSE_STEP(v, _mm_shuffle_epi32(v, 0xB1), 0x6);
+    v = SIMD_SSE_STEP(v, _mm_shuffle_epi32(v, 0x4E), 0xC);
+    v = SIMD_SSE_STEP(v, _mm_shuffle_epi32(v, 0xB1), 0xA);
+    return v;
+}
+
+static inline SIMD_SORT_TARGET_SSE41 __m128i simd_sse_clean4(__m128i v) {
+    v = SIMD_SSE_STEP(v, _mm_shuffle_epi32(v, 0x4E), 0xC);
+    v = SIMD_SSE_STEP(v, _mm_shuffle_epi32(v, 0xB1), 0xA);
+    return v;
+}
+
+// Sorts buf[0..4k) for k = 1, 2, 4, 8 or 16 (see simd_avx2_sort_block)
+static inline SIMD_SORT_TARGET_SSE41 void simd_sse_sort_block(int32_t *buf, size_t k) {
+    __m128i v[16];
+    for (size_t i = 0; i < k; i++) v[i] = simd_sse_sort4(_mm_loadu_si128((const __m128i*)(buf + 4 * i)));
+    for (size_t w = 1; w < k; w *= 2) {
+        for (size_t s = 0; s < k; s += 2 * w) {
+            for (size_t i = 0; i < w / 2; i++) {
+                __m128i t = v[s + w + i];
+                v[s + w + i] = v[s + 2 * w - 1 - i];
+                v[s + 2 * w - 1 - i] = t;
+            }
+            for (size_t i = 0; i < w; i++) v[s + w + i] = _mm_shuffle_epi32(v[s + w + i], 0x1B);
+            for (size_t d = w; d > 0; d /= 2) {
+                for (size_t i = s; i < s + 2 * w; i++) {
+                    if ((i - s) & d) continue;
+                    __m128i lo = _mm_min_epi32(v[i], v[i + d]);
+                    v[i + d] = _mm_max_epi32(v[i], v[i + d]);
+                    v[i] = lo;
+                }
+            }
+            for (size_t i = s; i < s + 2 * w; i++) v[i] = simd_sse_clean4(v[i]);
+        }
+    }
+    for (size_t i = 0; i < k; i++) _mm_storeu_si128((__m128i*)(buf + 4 * i), v[i]);
+}
+
+static inline SIMD_SORT_TARGET_SSE41 void simd_sse_sort_small(char *base, size_t n) {
+    int32_t buf[SIMD_SORT_BLOCK];
+    size_t k = 1;
+    while (4 * k < n) k *= 2;
+    memcpy(buf, base, n * sizeof(int32_t));
+    for (size_t i = n; i < 4 * k; i++) buf[i] = INT32_MAX;
+    simd_sse_sort_block(buf, k);
+    memcpy(base, buf, n * sizeof(int32_t));
+}
+
+// Same as simd_avx2_partition with 4 lanes; n >= 8
+static inline SIMD_SORT_TARGET_SSE41 size_t simd_sse_partition(char *base, size_t n, int32_t pivot, bool le) {
+    const __m128i pv = _mm_set1_epi32(pivot);
+    int32_t rest[12];
+    _mm_storeu_si128((__m128i*)rest, _mm_loadu_si128((const __m128i*)base));
+    _mm_storeu_si128((__m128i*)(rest + 4), _mm_loadu_si128((const __m128i*)(base + 4 * (n - 4))));
+    size_t l = 4, r = n - 4, lw = 0, rw = n;
+    while (r - l >= 4) {
+        __m128i v;
+        if (l - lw <= rw - r) {
+            v = _mm_loadu_si128((const __m128i*)(base + 4 * l));
+            l += 4;
+        } else {
+            r -= 4;
+            v = _mm_loadu_si128((const __m128i*)(base + 4 * r));
+        }
+        __m128i right = le ? _mm_cmpgt_epi32(v, pv)
+                           : _mm_xor_si128(_mm_cmpgt_epi32(pv, v), _mm_set1_epi32(-1));
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(right));
+        v = _mm_shuffle_epi8(v, _mm_loadu_si128((const __m128i*)simd_sort_sse_perm[mask]));
+        size_t count_right = (size_t)__builtin_popcount(mask);
+        _mm_storeu_si128((__m128i*)(base + 4 * lw), v);
+        _mm_storeu_si128((__m128i*)(base + 4 * (rw - 4)), v);
+        lw += 4 - count_right;
+        rw -= count_right;
+    }
+    memcpy(rest + 8, base + 4 * l, (r - l) * sizeof(int32_t));
+    return simd_sort_partition_rest(base, lw, rw, rest, 8 + (r - l), pivot, le);
+}
+
+/* ---- Driver ---- */
+
+// Quicksort over int32 keys in the shape of sort_loop: a range whose
+// predecessor equals the pivot only needs its keys > pivot sorted, and
+// unbalanced splits lead to pattern breaking and finally heapsort.
+static inline void simd_sort_loop(char *base, size_t n, int bad_allowed, bool leftmost, SimdSortIsa isa) {
+    for (;;) {
+        if (n <= SIMD_SORT_BLOCK) {
+            if (isa == SIMD_SORT_ISA_AVX2) simd_avx2_sort_small(base, n);
+            else simd_sse_sort_small(base, n);
+            return;
+        }
+        int32_t pivot = simd_sort_pivot(base, n);
+        bool equal_run = !leftmost && simd_sort_get(base - sizeof(int32_t), 0) >= pivot;
+        size_t split = isa == SIMD_SORT_ISA_AVX2 ? simd_avx2_partition(base, n, pivot, equal_run)
+                                                 : simd_sse_partition(base, n, pivot, equal_run);
+        if (!equal_run && split == 0) {
+            // Pivot is the minimum: peel off its copies instead
+            equal_run = true;
+            split = isa == SIMD_SORT_ISA_AVX2 ? simd_avx2_partition(base, n, pivot, true)
+                                              : simd_sse_partition(base, n, pivot, true);
+        }
+        if (equal_run) {
+            // Everything left of split equals the pivot and is in place
+            base += split * sizeof(int32_t);
+            n -= split;
+            leftmost = false;
+            continue;
+        }
+
+        char *right = base + split * sizeof(int32_t);
+        size_t left_n = split, right_n = n - split;
+        if (left_n < n / 8 || right_n < n / 8) {
+            if (--bad_allowed == 0) {
+                sort_heapsort(base, n, sizeof(int32_t), simd_sort_compare);
+                return;
+            }
+            sort_break_patterns(base, left_n, sizeof(int32_t));
+            sort_break_patterns(right, right_n, sizeof(int32_t));
+        }
+        if (left_n < right_n) {
+            simd_sort_loop(base, left_n, bad_allowed, leftmost, isa);
+            base = right;
+            n = right_n;
+            leftmost = false;
+        } else {
+            simd_sort_loop(right, right_n, bad_allowed, false, isa);
+            n = left_n;
+        }
+    }
+}
+
+#endif // SIMD_SORT_X86
+
+// sort_loop for int32 keys in natural order (same contract): the SIMD
+// quicksort when the CPU has SSE4.1 or AVX2, otherwise the SORT_DEFINE loop
+static inline void simd_sort_loop_i32(int32_t *a, size_t n, int bad_allowed, bool leftmost) {
+#ifdef SIMD_SORT_X86
+    SimdSortIsa isa = simd_sort_detect();
+    if (isa != SIMD_SORT_ISA_SCALAR) {
+        simd_sort_loop((char*)a, n, bad_allowed, leftmost, isa);
+        return;
+    }
+#endif
+    simd_sort_scalar_i32_loop(a, n, bad_allowed, leftmost);
+}
+
+// Sorts with the given instruction set, lowered to what the CPU supports;
+// mainly for benchmarks and tests
+static inline void simd_sort_i32_isa(int32_t *a, size_t n, SimdSortIsa isa) {
+    if (n < 2) return;
+    SimdSortIsa best = simd_sort_detect();
+    if (isa > best) isa = best;
+#ifdef SIMD_SORT_X86
+    if (isa != SIMD_SORT_ISA_SCALAR) {
+        simd_sort_loop((char*)a, n, sort_log2(n) + 1, true, isa);
+        return;
+    }
+#endif
+    simd_sort_scalar_i32_sort(a, n);
+}
+
+static inline void simd_sort_f32_isa(float *a, size_t n, SimdSortIsa isa) {
+    if (n < 2) return;
+    SimdSortIsa best = simd_sort_detect();
+    if (isa > best) isa = best;
+#ifdef SIMD_SORT_X86
+    if (isa != SIMD_SORT_ISA_SCALAR) {
+        simd_sort_f32_keys((char*)a, n);
+        simd_sort_loop((char*)a, n, sort_log2(n) + 1, true, isa);
+        simd_sort_f32_keys((char*)a, n);
+        return;
+    }
+#endif
+    simd_sort_scalar_f32_sort(a, n);
+}
+
+static inline void simd_sort_i32(int32_t *a, size_t n) {
+    simd_sort_i32_isa(a, n, SIMD_SORT_ISA_AVX2);
+}
+
+static inline void simd_sort_f32(float *a, size_t n) {
+    simd_sort_f32_isa(a, n, SIMD_SORT_ISA_AVX2);
+}
+
+#endif // SIMD_SORT_H
@@ -3,50 +3,580 @@
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 
-static void swap(void *a, void *b, size_t size) {
-    char *p = a;
-    char *q = b;
+// Pattern-defeating quicksort (Orson Peters, pdqsort) for qsort-style arrays:
+// - median-of-3 pivot, ninther above SORT_NINTHER_THRESHOLD elements
+// - Hoare-style partition; runs of keys equal to the pivot are split off in
+//   one pass, so inputs with many duplicates take O(n log k) for k distinct keys
+// - insertion sort below SORT_INSERTION_THRESHOLD elements
+// - a partition that leaves both sides in place is followed by a bounded
+//   insertion sort, which finishes sorted and nearly sorted inputs in O(n)
+// - unbalanced partitions shuffle a few elements; after log2(n) of them the
+//   range is heapsorted, so the worst case is O(n log n)
+// - recursion only on the smaller side, so stack depth is O(log n)
+// - int32 keys compared with sort_compare_i32, and float keys compared with
+//   sort_compare_f32, are sorted by the SIMD kernels of simd_sort.h (the
+//   typed scalar sort there in SIMD_SORT_SCALAR_ONLY builds)
+
+#define SORT_INSERTION_THRESHOLD 24
+#define SORT_NINTHER_THRESHOLD 128
+#define SORT_PARTIAL_INSERTION_LIMIT 8
+
+typedef int (*sort_compar_t)(const void*, const void*);
+
+// Defined in simd_sort.h, which is included at the end of this file
+static inline int32_t simd_sort_f32_key(int32_t bits);
+static inline void simd_sort_loop_i32(int32_t *a, size_t n, int bad_allowed, bool leftmost);
+static inline void simd_sort_f32(float *a, size_t n);
+
+// Ascending order of int32_t keys
+static inline int sort_compare_i32(const void *a, const void *b) {
+    int32_t x, y;
+    memcpy(&x, a, sizeof x);
+    memcpy(&y, b, sizeof y);
+    return (x > y) - (x < y);
+}
+
+// Ascending IEEE-754 total order of float keys, as in simd_sort.h:
+// -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN
+static inline int sort_compare_f32(const void *a, const void *b) {
+    int32_t x, y;
+    memcpy(&x, a, sizeof x);
+    memcpy(&y, b, sizeof y);
+    x = simd_sort_f32_key(x);
+    y = simd_sort_f32_key(y);
+    return (x > y) - (x < y);
+}
+
+// Swaps two elements; 4- and 8-byte elements are moved as single words and
+// larger ones in 64-byte blocks.
+static inline void swap(void *a, void *b, size_t size) {
+    char *p = (char*)a;
+    char *q = (char*)b;
+    if (size == sizeof(uint32_t)) {
+        uint32_t t, u;
+        memcpy(&t, p, sizeof t); memcpy(&u, q, sizeof u);
+        memcpy(p, &u, sizeof u); memcpy(q, &t, sizeof t);
+        return;
+    }
+    if (size == sizeof(uint64_t)) {
+        uint64_t t, u;
+        memcpy(&t, p, sizeof t); memcpy(&u, q, sizeof u);
+        memcpy(p, &u, sizeof u); memcpy(q, &t, sizeof t);
+        return;
+    }
+    char tmp[64];
+    while (size >= sizeof(tmp)) {
+        memcpy(tmp, p, sizeof(tmp));
+        memcpy(p, q, sizeof(tmp));
+        memcpy(q, tmp, sizeof(tmp));
+        p += sizeof(tmp);
+        q += sizeof(tmp);
+        size -= sizeof(tmp);
+    }
+    while (size >= sizeof(uint64_t)) {
+        uint64_t t, u;
+        memcpy(&t, p, sizeof t); memcpy(&u, q, sizeof u);
+        memcpy(p, &u, sizeof u); memcpy(q, &t, sizeof t);
+        p += sizeof(uint64_t);
+        q += sizeof(uint64_t);
+        size -= sizeof(uint64_t);
+    }
     while (size--) {
-        char tmp = *p;
+        char t = *p;
         *p++ = *q;
-        *q++ = tmp;
+        *q++ = t;
+    }
+}
+
+#define SORT_AT(base, i, size) ((char*)(base) + (size_t)(i) * (size))
+#define SORT_LESS(a, b) (compar((a), (b)) < 0)
+
+static inline void sort_insertion(char *base, size_t nmemb, size_t size, sort_compar_t compar) {
+    for (size_t i = 1; i < nmemb; i++) {
+        size_t j = i;
+        while (j > 0 && SORT_LESS(SORT_AT(base, j, size), SORT_AT(base, j - 1, size))) {
+            swap(SORT_AT(base, j, size), SORT_AT(base, j - 1, size), size);
+            j--;
+        }
+    }
+}
+
+// Insertion sort that gives up after SORT_PARTIAL_INSERTION_LIMIT element
+// moves; returns true if the range ended up sorted.
+static inline bool sort_partial_insertion(char *base, size_t nmemb, size_t size, sort_compar_t compar) {
+    size_t moves = 0;
+    for (size_t i = 1; i < nmemb; i++) {
+        size_t j = i;
+        while (j > 0 && SORT_LESS(SORT_AT(base, j, size), SORT_AT(base, j - 1, size))) {
+            swap(SORT_AT(base, j, size), SORT_AT(base, j - 1, size), size);
+            j--;
+        }
+        moves += i - j;
+        if (moves > SORT_PARTIAL_INSERTION_LIMIT) return false;
+    }
+    return true;
+}
+
+static inline void sort_sift_down(char *base, size_t root, size_t nmemb, size_t size, sort_compar_t compar) {
+    size_t child;
+    while ((child = 2 * root + 1) < nmemb) {
+        if (child + 1 < nmemb && SORT_LESS(SORT_AT(base, child, size), SORT_AT(base, child + 1, size))) child++;
+        if (!SORT_LESS(SORT_AT(base, root, size), SORT_AT(base, child, size))) return;
+        swap(SORT_AT(base, root, size), SORT_AT(base, child, size), size);
+        root = child;
+    }
+}
+
+static inline void sort_heapsort(char *base, size_t nmemb, size_t size, sort_compar_t compar) {
+    if (nmemb < 2) return;
+    for (size_t i = nmemb / 2; i-- > 0;) sort_sift_down(base, i, nmemb, size, compar);
+    for (size_t end = nmemb - 1; end > 0; end--) {
+        swap(base, SORT_AT(base, end, size), size);
+        sort_sift_down(base, 0, end, size, compar);
+    }
+}
+
+// Orders three elements so that *a <= *b <= *c
+static inline void sort_sort3(char *a, char *b, char *c, size_t size, sort_compar_t compar) {
+    if (SORT_LESS(b, a)) swap(a, b, size);
+    if (SORT_LESS(c, b)) swap(b, c, size);
+    if (SORT_LESS(b, a)) swap(a, b, size);
+}
+
+// Moves the pivot (median of 3, or ninther for large ranges) to base[0]
+static inline void sort_choose_pivot(char *base, size_t nmemb, size_t size, sort_compar_t compar) {
+    size_t mid = nmemb / 2;
+    char *first = base, *m = SORT_AT(base, mid, size), *last = SORT_AT(base, nmemb - 1, size);
+    if (nmemb > SORT_NINTHER_THRESHOLD) {
+        sort_sort3(first, m, last, size, compar);
+        sort_sort3(first + size, m - size, last - size, size, compar);
+        sort_sort3(first + 2 * size, m + size, last - 2 * size, size, compar);
+        sort_sort3(m - size, m, m + size, size, compar);
+        swap(first, m, size);
+    } else {
+        sort_sort3(m, first, last, size, compar);
+    }
+}
+
+// Partitions around the pivot at base[0]: elements < pivot end up left of the
+// returned index, elements >= pivot right of it, the pivot at it. Needs an
+// element >= pivot after base[0] (guaranteed by sort_choose_pivot).
+// *already_partitioned is set if no element had to move.
+static inline size_t sort_partition_right(char *base, size_t nmemb, size_t size,
+                                          sort_compar_t compar, bool *already_partitioned) {
+    char *pivot = base;
+    char *first = base;
+    char *last = SORT_AT(base, nmemb, size);
+
+    do { first += size; } while (SORT_LESS(first, pivot));
+    if (first - size == base) {
+        while (first < last) {
+            last -= size;
+            if (SORT_LESS(last, pivot)) break;
+        }
+    } else {
+        do { last -= size; } while (!SORT_LESS(last, pivot));
+    }
+    *already_partitioned = first >= last;
+
+    while (first < last) {
+        swap(first, last, size);
+        do { first += size; } while (SORT_LESS(first, pivot));
+        do { last -= size; } while (!SORT_LESS(last, pivot));
+    }
+    char *pivot_pos = first - size;
+    swap(base, pivot_pos, size);
+    return (size_t)(pivot_pos - base) / size;
+}
+
+// Partitions around the pivot at base[0] with elements <= pivot on the left.
+// Used when the pivot equals the element just before the range: everything
+// left of the returned index is then equal to the pivot and already in place.
+static inline size_t sort_partition_left(char *base, size_t nmemb, size_t size, sort_compar_t compar) {
+    char *pivot = base;
+    char *first = base;
+    char *last = SORT_AT(base, nmemb, size);
+
+    do { last -= size; } while (SORT_LESS(pivot, last));
+    if (last + size == SORT_AT(base, nmemb, size)) {
+        while (first < last) {
+            first += size;
+            if (SORT_LESS(pivot, first)) break;
+        }
+    } else {
+        do { first += size; } while (!SORT_LESS(pivot, first));
+    }
+
+    while (first < last) {
+        swap(first, last, size);
+        do { last -= size; } while (SORT_LESS(pivot, last));
+        do { first += size; } while (!SORT_LESS(pivot, first));
     }
+    swap(base, last, size);
+    return (size_t)(last - base) / size;
 }
 
-static size_t partition(void *base, size_t nmemb, size_t size,
-                        int (*compar)(const void*, const void*)) {
-    char *base_ptr = (char*)base;
-    size_t pivot_index = nmemb / 2;
-    char *pivot = base_ptr + pivot_index * size;
-    
-    swap(pivot, base_ptr + (nmemb - 1) * size, size);
-    pivot = base_ptr + (nmemb - 1) * size;
+// Swaps a few elements of an unbalanced side to break up adversarial patterns
+static inline void sort_break_patterns(char *base, size_t nmemb, size_t size) {
+    if (nmemb < SORT_INSERTION_THRESHOLD) return;
+    size_t q = nmemb / 4;
+    swap(base, SORT_AT(base, q, size), size);
+    swap(SORT_AT(base, nmemb - 1, size), SORT_AT(base, nmemb - q, size), size);
+    if (nmemb > SORT_NINTHER_THRESHOLD) {
+        swap(SORT_AT(base, 1, size), SORT_AT(base, q + 1, size), size);
+        swap(SORT_AT(base, 2, size), SORT_AT(base, q + 2, size), size);
+        swap(SORT_AT(base, nmemb - 2, size), SORT_AT(base, nmemb - q + 1, size), size);
+        swap(SORT_AT(base, nmemb - 3, size), SORT_AT(base, nmemb - q + 2, size), size);
+    }
+}
+
+static inline int sort_log2(size_t n) {
+    int log = 0;
+    while (n >>= 1) log++;
+    return log;
+}
+
+// Sorts base[0..nmemb). `leftmost` is false when base[-1] exists and is <=
+// every element of the range; `bad_allowed` counts unbalanced partitions
+// left before switching to heapsort.
+static inline void sort_loop(char *base, size_t nmemb, size_t size, sort_compar_t compar,
+                             int bad_allowed, bool leftmost) {
+    if (size == sizeof(int32_t) && compar == sort_compare_i32) {
+        simd_sort_loop_i32((int32_t*)base, nmemb, bad_allowed, leftmost);
+        return;
+    }
+    for (;;) {
+        if (nmemb < SORT_INSERTION_THRESHOLD) {
+            sort_insertion(base, nmemb, size, compar);
+            return;
+        }
+        sort_choose_pivot(base, nmemb, size, compar);
+
+        // Pivot equal to the predecessor: split off the run of equal keys
+        if (!leftmost && !SORT_LESS(base - size, base)) {
+            size_t p = sort_partition_left(base, nmemb, size, compar);
+            base = SORT_AT(base, p + 1, size);
+            nmemb -= p + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        size_t p = sort_partition_right(base, nmemb, size, compar, &already_partitioned);
+        char *right = SORT_AT(base, p + 1, size);
+        size_t left_n = p, right_n = nmemb - p - 1;
 
-    size_t store_index = 0;
-    for (size_t i = 0; i < nmemb - 1; ++i) {
-        if (compar(base_ptr + i * size, pivot) <= 0) {
-            swap(base_ptr + i * size, base_ptr + store_index * size, size);
-            store_index++;
+        if (left_n < nmemb / 8 || right_n < nmemb / 8) {
+            if (--bad_allowed == 0) {
+                sort_heapsort(base, nmemb, size, compar);
+                return;
+            }
+            sort_break_patterns(base, left_n, size);
+            sort_break_patterns(right, right_n, size);
+        } else if (already_partitioned &&
+                   sort_partial_insertion(base, left_n, size, compar) &&
+                   sort_partial_insertion(right, right_n, size, compar)) {
+            return;
+        }
+
+        // Recurse into the smaller side, loop on the larger one
+        if (left_n < right_n) {
+            sort_loop(base, left_n, size, compar, bad_allowed, leftmost);
+            base = right;
+            nmemb = right_n;
+            leftmost = false;
+        } else {
+            sort_loop(right, right_n, size, compar, bad_allowed, false);
+            nmemb = left_n;
         }
     }
-    swap(base_ptr + store_index * size, pivot, size);
-    return store_index;
 }
 
-static void quicksort(void *base, size_t nmemb, size_t size,
-                     int (*compar)(const void*, const void*)) {
-    if (nmemb <= 1) return;
-    
-    size_t pivot_index = partition(base, nmemb, size, compar);
-    char *base_ptr = (char*)base;
-    
-    quicksort(base_ptr, pivot_index, size, compar);
-    quicksort(base_ptr + (pivot_index + 1) * size,
-             nmemb - pivot_index - 1, size, compar);
+// Partitions around a median-of-3/ninther pivot and returns its final index:
+// elements before it are < pivot, elements after it are >= pivot. Arrays
+// with fewer than 3 elements are sorted instead.
+static inline size_t partition(void *base, size_t nmemb, size_t size,
+                               int (*compar)(const void*, const void*)) {
+    if (nmemb < 3) {
+        sort_insertion((char*)base, nmemb, size, compar);
+        return 0;
+    }
+    bool already_partitioned;
+    sort_choose_pivot((char*)base, nmemb, size, compar);
+    return sort_partition_right((char*)base, nmemb, size, compar, &already_partitioned);
+}
+
+static inline void quicksort(void *base, size_t nmemb, size_t size,
+                             int (*compar)(const void*, const void*)) {
+    if (nmemb <= 1 || size == 0) return;
+    if (size == sizeof(float) && compar == sort_compare_f32) {
+        simd_sort_f32((float*)base, nmemb);
+        return;
+    }
+    sort_loop((char*)base, nmemb, size, compar, sort_log2(nmemb) + 1, true);
 }
 
 #define SORT_ARRAY(arr, compar) \
     quicksort((arr), sizeof(arr)/sizeof((arr)[0]), sizeof((arr)[0]), (compar))
 
+// SORT_DEFINE(name, T, less) generates sorts specialized for element type T:
+//   void name_sort(T *a, size_t n)         - the pdqsort above, unstable
+//   bool name_stable_sort(T *a, size_t n)  - merge sort, stable; false if its
+//                                            n-element buffer cannot be allocated
+// `less(x, y)` is a macro or function on two T values, so comparisons are
+// inlined and elements are moved as T instead of through swap()'s byte loop.
+// E.g. SORT_DEFINE(int_array, int, SORT_NATURAL_LESS), then int_array_sort(a, n).
+
+#define SORT_NATURAL_LESS(a, b) ((a) < (b))
+#define SORT_STABLE_RUN 32
+
+#define SORT_DEFINE(name, T, less)                                                        \
+                                                                                          \
+/* Insertion sort that shifts a hole instead of swapping */                               \
+static inline void name##_insertion(T *a, size_t n) {                                     \
+    for (size_t i = 1; i < n; i++) {                                                      \
+        T x = a[i];                                                                       \
+        size_t j = i;                                                                     \
+        while (j > 0 && less(x, a[j - 1])) {                                              \
+            a[j] = a[j - 1];                                                              \
+            j--;                                                                          \
+        }                                                                                 \
+        a[j] = x;                                                                         \
+    }                                                                                     \
+}                                                                                         \
+                                                                                          \
+/* Gives up after SORT_PARTIAL_INSERTION_LIMIT moves; true if sorted */                   \
+static inline bool name##_partial_insertion(T *a, size_t n) {                             \
+    size_t moves = 0;                                                                     \
+    for (size_t i = 1; i < n; i++) {                                                      \
+        T x = a[i];                                                                       \
+        size_t j = i;                                                                     \
+        while (j > 0 && less(x, a[j - 1])) {                                              \
+            a[j] = a[j - 1];                                                              \
+            j--;                                                                          \
+        }                                                                                 \
+        a[j] = x;                                                                         \
+        moves += i - j;                                                                   \
+        if (moves > SORT_PARTIAL_INSERTION_LIMIT) return false;                           \
+    }                                                                                     \
+    return true;                                                                          \
+}                                                                                         \
+                                                                                          \
+static inline void name##_sift_down(T *a, size_t root, size_t n) {                        \
+    T x = a[root];                                                                        \
+    size_t child;                                                                         \
+    while ((child = 2 * root + 1) < n) {                                                  \
+        if (child + 1 < n && less(a[child], a[child + 1])) child++;                       \
+        if (!less(x, a[child])) break;                                                    \
+        a[root] = a[child];                                                               \
+        root = child;                                                                     \
+    }                                                                                     \
+    a[root] = x;                                                                          \
+}                                                                                         \
+                                                                                          \
+static inline void name##_heapsort(T *a, size_t n) {                                      \
+    if (n < 2) return;                                                                    \
+    for (size_t i = n / 2; i-- > 0;) name##_sift_down(a, i, n);                           \
+    for (size_t end = n - 1; end > 0; end--) {                                            \
+        T t = a[0]; a[0] = a[end]; a[end] = t;                                            \
+        name##_sift_down(a, 0, end);                                                      \
+    }                                                                                     \
+}                                                                                         \
+                                                                                          \
+static inline void name##_swap(T *a, T *b) {                                              \
+    T t = *a; *a = *b; *b = t;                                                            \
+}                                                                                         \
+                                                                                          \
+static inline void name##_sort3(T *a, T *b, T *c) {                                       \
+    if (less(*b, *a)) name##_swap(a, b);                                                  \
+    if (less(*c, *b)) name##_swap(b, c);                                                  \
+    if (less(*b, *a)) name##_swap(a, b);                                                  \
+}                                                                                         \
+                                                                                          \
+static inline void name##_choose_pivot(T *a, size_t n) {                                  \
+    size_t mid = n / 2;                                                                   \
+    if (n > SORT_NINTHER_THRESHOLD) {                                                     \
+        name##_sort3(a, a + mid, a + n - 1);                                              \
+        name##_sort3(a + 1, a + mid - 1, a + n - 2);                                      \
+        name##_sort3(a + 2, a + mid + 1, a + n - 3);                                      \
+        name##_sort3(a + mid - 1, a + mid, a + mid + 1);                                  \
+        name##_swap(a, a + mid);                                                          \
+    } else {                                                                              \
+        name##_sort3(a + mid, a, a + n - 1);                                              \
+    }                                                                                     \
+}                                                                                         \
+                                                                                          \
+/* Same contract as sort_partition_right; the pivot is held in a local */                 \
+static inline size_t name##_partition_right(T *a, size_t n, bool *already_partitioned) {  \
+    T pivot = a[0];                                                                       \
+    size_t first = 0, last = n;                                                           \
+    while (less(a[++first], pivot));                                                      \
+    if (first == 1) {                                                                     \
+        while (first < last && !less(a[--last], pivot));                                  \
+    } else {                                                                              \
+        while (!less(a[--last], pivot));                                                  \
+    }                                                                                     \
+    *already_partitioned = first >= last;                                                 \
+    while (first < last) {                                                                \
+        name##_swap(a + first, a + last);                                                 \
+        while (less(a[++first], pivot));                                                  \
+        while (!less(a[--last], pivot));                                                  \
+    }                                                                                     \
+    size_t p = first - 1;                                                                 \
+    a[0] = a[p];                                                                          \
+    a[p] = pivot;                                                                         \
+    return p;                                                                             \
+}                                                                                         \
+                                                                                          \
+/* Same contract as sort_partition_left */                                                \
+static inline size_t name##_partition_left(T *a, size_t n) {                              \
+    T pivot = a[0];                                                                       \
+    size_t first = 0, last = n;                                                           \
+    while (less(pivot, a[--last]));                                                       \
+    if (last + 1 == n) {                                                                  \
+        while (first < last && !less(pivot, a[++first]));                                 \
+    } else {                                                                              \
+        while (!less(pivot, a[++first]));                                                 \
+    }                                                                                     \
+    while (first < last) {                                                                \
+        name##_swap(a + first, a + last);                                                 \
+        while (less(pivot, a[--last]));                                                   \
+        while (!less(pivot, a[++first]));                                                 \
+    }                                                                                     \
+    a[0] = a[last];                                                                       \
+    a[last] = pivot;                                                                      \
+    return last;                                                                          \
+}                                                                                         \
+                                                                                          \
+static inline void name##_break_patterns(T *a, size_t n) {                                \
+    if (n < SORT_INSERTION_THRESHOLD) return;                                             \
+    size_t q = n / 4;                                                                     \
+    name##_swap(a, a + q);                                                                \
+    name##_swap(a + n - 1, a + n - q);                                                    \
+    if (n > SORT_NINTHER_THRESHOLD) {                                                     \
+        name##_swap(a + 1, a + q + 1);                                                    \
+        name##_swap(a + 2, a + q + 2);                                                    \
+        name##_swap(a + n - 2, a + n - q + 1);                                            \
+        name##_swap(a + n - 3, a + n - q + 2);                                            \
+    }                                                                                     \
+}                                                                                         \
+                                                                                          \
+/* Typed copy of sort_loop */                                                             \
+static inline void name##_loop(T *a, size_t n, int bad_allowed, bool leftmost) {          \
+    for (;;) {                                                                            \
+        if (n < SORT_INSERTION_THRESHOLD) {                                               \
+            name##_insertion(a, n);                                                       \
+            return;                                                                       \
+        }                                                                                 \
+        name##_choose_pivot(a, n);                                                        \
+        if (!leftmost && !less(a[-1], a[0])) {                                            \
+            size_t p = name##_partition_left(a, n);                                       \
+            a += p + 1;                                                                   \
+            n -= p + 1;                                                                   \
+            continue;                                                                     \
+        }                                                                                 \
+        bool already_partitioned;                                                         \
+        size_t p = name##_partition_right(a, n, &already_partitioned);                    \
+        T *right = a + p + 1;                                                             \
+        size_t left_n = p, right_n = n - p - 1;                                           \
+        if (left_n < n / 8 || right_n < n / 8) {                                          \
+            if (--bad_allowed == 0) {                                                     \
+                name##_heapsort(a, n);                                                    \
+                return;                                                                   \
+            }                                                                             \
+            name##_break_patterns(a, left_n);                                             \
+            name##_break_patterns(right, right_n);                                        \
+        } else if (already_partitioned &&                                                 \
+                   name##_partial_insertion(a, left_n) &&                                 \
+                   name##_partial_insertion(right, right_n)) {                            \
+            return;                                                                       \
+        }                                                                                 \
+        if (left_n < right_n) {                                                           \
+            name##_loop(a, left_n, bad_allowed, leftmost);                                \
+            a = right;                                                                    \
+            n = right_n;                                                                  \
+            leftmost = false;                                                             \
+        } else {                                                                          \
+            name##_loop(right, right_n, bad_allowed, false);                              \
+            n = left_n;                                                                   \
+        }                                                                                 \
+    }                                                                                     \
+}                                                                                         \
+                                                                                          \
+/* Unstable introsort of a[0..n) */                                                       \
+static inline void name##_sort(T *a, size_t n) {                                          \
+    if (n > 1) name##_loop(a, n, sort_log2(n) + 1, true);                                 \
+}                                                                                         \
+                                                                                          \
+/* Merges src[lo..mid) and src[mid..hi) into dst[lo..hi), left first on ties */           \
+static inline void name##_merge(const T *src, T *dst, size_t lo, size_t mid, size_t hi) { \
+    size_t i = lo, j = mid, k = lo;                                                       \
+    while (i < mid && j < hi) dst[k++] = less(src[j], src[i]) ? src[j++] : src[i++];      \
+    while (i < mid) dst[k++] = src[i++];                                                  \
+    while (j < hi) dst[k++] = src[j++];                                                   \
+}                                                                                         \
+                                                                                          \
+/* Stable merge sort of a[0..n): insertion-sorted runs of SORT_STABLE_RUN,                \
+   then bottom-up merges through an n-element buffer. Returns false (with a               \
+   untouched) if the buffer cannot be allocated. */                                       \
+static inline bool name##_stable_sort(T *a, size_t n) {                                   \
+    if (n < 2) return true;                                                               \
+    if (n <= SORT_STABLE_RUN) {                                                           \
+        name##_insertion(a, n);                                                           \
+        return true;                                                                      \
+    }                                                                                     \
+    T *buf = (T*)malloc(n * sizeof(T));                                                   \
+    if (!buf) return false;                                                               \
+    for (size_t lo = 0; lo < n; lo += SORT_STABLE_RUN) {                                  \
+        name##_insertion(a + lo, n - lo < SORT_STABLE_RUN ? n - lo : SORT_STABLE_RUN);    \
+    }                                                                                     \
+    T *src = a, *dst = buf;                                                               \
+    for (size_t width = SORT_STABLE_RUN; width < n; width *= 2) {                         \
+        for (size_t lo = 0; lo < n; lo += 2 * width) {                                    \
+            size_t mid = n - lo < width ? n : lo + width;                                 \
+            size_t hi = n - lo < 2 * width ? n : lo + 2 * width;                          \
+            if (mid == hi || !less(src[mid], src[mid - 1])) {                             \
+                memcpy(dst + lo, src + lo, (hi - lo) * sizeof(T));                        \
+            } else {                                                                      \
+                name##_merge(src, dst, lo, mid, hi);                                      \
+            }                                                                             \
+        }                                                                                 \
+        T *t = src; src = dst; dst = t;                                                   \
+    }                                                                                     \
+    if (src != a) memcpy(a, src, n * sizeof(T));                                          \
+    free(buf);                                                                            \
+    return true;                                                                          \
+}
+
+// SORT_DEFINE_I32(name) and SORT_DEFINE_F32(name) generate the same two
+// functions for int32_t in natural order and for float in IEEE-754 total
+// order (see sort_compare_f32), running on the SIMD kernels of simd_sort.h.
+// Equal keys of these types are indistinguishable, so name_stable_sort is
+// the same sort and never fails.
+
+#define SORT_DEFINE_I32(name)                                                             \
+static inline void name##_sort(int32_t *a, size_t n) {                                    \
+    if (n > 1) simd_sort_loop_i32(a, n, sort_log2(n) + 1, true);                          \
+}                                                                                         \
+                                                                                          \
+static inline bool name##_stable_sort(int32_t *a, size_t n) {                             \
+    name##_sort(a, n);                                                                    \
+    return true;                                                                          \
+}
+
+#define SORT_DEFINE_F32(name)                                                             \
+static inline void name##_sort(float *a, size_t n) {                                      \
+    simd_sort_f32(a, n);                                                                  \
+}                                                                                         \
+                                                                                          \
+static inline bool name##_stable_sort(float *a, size_t n) {                               \
+    simd_sort_f32(a, n);                                                                  \
+    return true;                                                                          \
+}
+
+#include "simd_sort.h"
+
 #endif // SORT_H
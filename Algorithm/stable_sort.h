@@ -0,0 +1,282 @@
+#ifndef STABLE_SORT_H
+#define STABLE_SORT_H
+
+#include "sort.h"
+
+// Adaptive stable merge sort for qsort-style arrays (Munro & Wild's
+// powersort, with TimSort's run detection and galloping merges):
+// - the input is scanned for natural runs; strictly descending runs are
+//   reversed, runs shorter than STABLE_SORT_MIN_RUN are extended with
+//   binary insertion sort
+// - runs are merged in the order given by their "power" (the depth of the
+//   boundary between two runs in a perfectly balanced merge tree), which
+//   is within a few percent of the optimal merge cost for any run lengths
+// - before a merge, the prefix of the left run and the suffix of the right
+//   run that are already in place are skipped by galloping (exponential
+//   then binary search); during a merge, once one side wins
+//   STABLE_SORT_MIN_GALLOP times in a row, blocks are copied at once
+// Sorted input costs n - 1 comparisons, and input that is sorted apart
+// from a few updates or an unsorted tail sorts in close to O(n).
+//
+// The merge buffer is borrowed from the caller: `scratch` must provide at
+// least STABLE_SORT_SCRATCH_SIZE(nmemb, size) bytes (half the array), or be
+// NULL to let stable_sort() allocate one.
+
+#define STABLE_SORT_MIN_RUN 32
+#define STABLE_SORT_MIN_GALLOP 7
+#define STABLE_SORT_MAX_PENDING 72
+#define STABLE_SORT_SCRATCH_SIZE(nmemb, size) (((nmemb) / 2 + 1) * (size))
+
+typedef struct {
+    size_t start;
+    size_t len;
+    int power;                  // Power of the boundary with the run above
+} StableSortRun;
+
+// Number of leading elements of a[0..n) that are < key (<= key if
+// `right`), found by exponential search from the front, or from the back
+// if `from_back`, then binary search
+static inline size_t stable_sort_gallop(const char *key, const char *a, size_t n, size_t size,
+                                        sort_compar_t compar, bool right, bool from_back) {
+#define STABLE_SORT_BEFORE(x) (right ? compar((x), key) <= 0 : compar((x), key) < 0)
+    size_t lo = 0, hi = n;
+    if (!from_back) {
+        for (size_t k = 1; k <= n; k *= 2) {
+            if (!STABLE_SORT_BEFORE(SORT_AT(a, k - 1, size))) {
+                hi = k - 1;
+                break;
+            }
+            lo = k;
+        }
+    } else {
+        for (size_t k = 1; k <= n; k *= 2) {
+            if (STABLE_SORT_BEFORE(SORT_AT(a, n - k, size))) {
+                lo = n - k + 1;
+                break;
+            }
+            hi = n - k;
+        }
+    }
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (STABLE_SORT_BEFORE(SORT_AT(a, mid, size))) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+#undef STABLE_SORT_BEFORE
+}
+
+static inline void stable_sort_reverse(char *base, size_t n, size_t size) {
+    for (size_t i = 0, j = n - 1; i < j; i++, j--) swap(SORT_AT(base, i, size), SORT_AT(base, j, size), size);
+}
+
+// Extends the sorted prefix base[0..sorted) to base[0..n) by binary
+// insertion; equal elements are inserted after existing ones. `tmp` holds
+// one element.
+static inline void stable_sort_binary_insertion(char *base, size_t sorted, size_t n, size_t size,
+                                                sort_compar_t compar, char *tmp) {
+    for (size_t i = sorted; i < n; i++) {
+        char *x = SORT_AT(base, i, size);
+        size_t pos = stable_sort_gallop(x, base, i, size, compar, true, true);
+        if (pos == i) continue;
+        memcpy(tmp, x, size);
+        memmove(SORT_AT(base, pos + 1, size), SORT_AT(base, pos, size), (i - pos) * size);
+        memcpy(SORT_AT(base, pos, size), tmp, size);
+    }
+}
+
+// Length of the natural run at base[0..n), made ascending
+static inline size_t stable_sort_count_run(char *base, size_t n, size_t size, sort_compar_t compar) {
+    if (n < 2) return n;
+    size_t len = 2;
+    if (compar(SORT_AT(base, 1, size), base) < 0) {
+        // Strictly descending, so that reversing keeps equal elements in order
+        while (len < n && compar(SORT_AT(base, len, size), SORT_AT(base, len - 1, size)) < 0) len++;
+        stable_sort_reverse(base, len, size);
+    } else {
+        while (len < n && compar(SORT_AT(base, len, size), SORT_AT(base, len - 1, size)) >= 0) len++;
+    }
+    return len;
+}
+
+// Merges base[0..n1) and base[n1..n1+n2) with n1 <= n2: the left run is
+// moved to tmp and merged from the front
+static inline void stable_sort_merge_lo(char *base, size_t n1, size_t n2, size_t size,
+                                        sort_compar_t compar, char *tmp) {
+    memcpy(tmp, base, n1 * size);
+    size_t i = 0, j = n1, end = n1 + n2, d = 0;     // tmp[i..n1), base[j..end), next write base[d]
+    while (i < n1 && j < end) {
+        size_t wins_left = 0, wins_right = 0;
+        while (wins_left < STABLE_SORT_MIN_GALLOP && wins_right < STABLE_SORT_MIN_GALLOP) {
+            if (compar(SORT_AT(base, j, size), SORT_AT(tmp, i, size)) < 0) {
+                memcpy(SORT_AT(base, d++, size), SORT_AT(base, j++, size), size);
+                wins_right++;
+                wins_left = 0;
+                if (j == end) goto done;
+            } else {
+                memcpy(SORT_AT(base, d++, size), SORT_AT(tmp, i++, size), size);
+                wins_left++;
+                wins_right = 0;
+                if (i == n1) goto done;
+            }
+        }
+        // Galloping: copy whole blocks while they stay long
+        size_t k_left, k_right;
+        do {
+            k_left = stable_sort_gallop(SORT_AT(base, j, size), SORT_AT(tmp, i, size), n1 - i, size,
+                                        compar, true, false);
+            memcpy(SORT_AT(base, d, size), SORT_AT(tmp, i, size), k_left * size);
+            d += k_left;
+            i += k_left;
+            if (i == n1) goto done;
+            memcpy(SORT_AT(base, d++, size), SORT_AT(base, j++, size), size);
+            if (j == end) goto done;
+
+            k_right = stable_sort_gallop(SORT_AT(tmp, i, size), SORT_AT(base, j, size), end - j, size,
+                                         compar, false, false);
+            memmove(SORT_AT(base, d, size), SORT_AT(base, j, size), k_right * size);
+            d += k_right;
+            j += k_right;
+            if (j == end) goto done;
+            memcpy(SORT_AT(base, d++, size), SORT_AT(tmp, i++, size), size);
+            if (i == n1) goto done;
+        } while (k_left >= STABLE_SORT_MIN_GALLOP || k_right >= STABLE_SORT_MIN_GALLOP);
+    }
+done:
+    // Leftover right elements are already in place
+    memcpy(SORT_AT(base, d, size), SORT_AT(tmp, i, size), (n1 - i) * size);
+}
+
+// Merges base[0..n1) and base[n1..n1+n2) with n2 < n1: the right run is
+// moved to tmp and merged from the back
+static inline void stable_sort_merge_hi(char *base, size_t n1, size_t n2, size_t size,
+                                        sort_compar_t compar, char *tmp) {
+    memcpy(tmp, SORT_AT(base, n1, size), n2 * size);
+    size_t nl = n1, nr = n2;                        // base[0..nl), tmp[0..nr), next write base[nl + nr - 1]
+    while (nl > 0 && nr > 0) {
+        size_t wins_left = 0, wins_right = 0;
+        while (wins_left < STABLE_SORT_MIN_GALLOP && wins_right < STABLE_SORT_MIN_GALLOP) {
+            if (compar(SORT_AT(tmp, nr - 1, size), SORT_AT(base, nl - 1, size)) < 0) {
+                memcpy(SORT_AT(base, nl + nr - 1, size), SORT_AT(base, nl - 1, size), size);
+                nl--;
+                wins_left++;
+                wins_right = 0;
+                if (nl == 0) goto done;
+            } else {
+                memcpy(SORT_AT(base, nl + nr - 1, size), SORT_AT(tmp, nr - 1, size), size);
+                nr--;
+                wins_right++;
+                wins_left = 0;
+                if (nr == 0) goto done;
+            }
+        }
+        size_t k_left, k_right;
+        do {
+            // Left elements greater than the last right element go to the back
+            k_left = nl - stable_sort_gallop(SORT_AT(tmp, nr - 1, size), base, nl, size, compar, true, true);
+            memmove(SORT_AT(base, nl + nr - k_left, size), SORT_AT(base, nl - k_left, size), k_left * size);
+            nl -= k_left;
+            if (nl == 0) goto done;
+            memcpy(SORT_AT(base, nl + nr - 1, size), SORT_AT(tmp, nr - 1, size), size);
+            nr--;
+            if (nr == 0) goto done;
+
+            // Right elements not less than the last left element follow
+            k_right = nr - stable_sort_gallop(SORT_AT(base, nl - 1, size), tmp, nr, size, compar, false, true);
+            memcpy(SORT_AT(base, nl + nr - k_right, size), SORT_AT(tmp, nr - k_right, size), k_right * size);
+            nr -= k_right;
+            if (nr == 0) goto done;
+            memcpy(SORT_AT(base, nl + nr - 1, size), SORT_AT(base, nl - 1, size), size);
+            nl--;
+            if (nl == 0) goto done;
+        } while (k_left >= STABLE_SORT_MIN_GALLOP || k_right >= STABLE_SORT_MIN_GALLOP);
+    }
+done:
+    // Leftover left elements are already in place
+    memcpy(base, tmp, nr * size);
+}
+
+// Merges the adjacent sorted runs base[0..n1) and base[n1..n1+n2)
+static inline void stable_sort_merge(char *base, size_t n1, size_t n2, size_t size,
+                                     sort_compar_t compar, char *tmp) {
+    // Left elements <= the first right element are already in place
+    size_t skip = stable_sort_gallop(SORT_AT(base, n1, size), base, n1, size, compar, true, false);
+    base = SORT_AT(base, skip, size);
+    n1 -= skip;
+    if (n1 == 0) return;
+    // So are right elements >= the last left element
+    n2 = stable_sort_gallop(SORT_AT(base, n1 - 1, size), SORT_AT(base, n1, size), n2, size, compar, false, true);
+    if (n2 == 0) return;
+    if (n1 <= n2) stable_sort_merge_lo(base, n1, n2, size, compar, tmp);
+    else stable_sort_merge_hi(base, n1, n2, size, compar, tmp);
+}
+
+// Depth of the boundary between runs [s1, s1+n1) and [s1+n1, s1+n1+n2) in
+// the balanced merge tree over [0, n): the first bit in which the binary
+// fractions of the two run midpoints differ
+static inline int stable_sort_power(size_t s1, size_t n1, size_t n2, size_t n) {
+    size_t a = 2 * s1 + n1;             // Twice the midpoints
+    size_t b = a + n1 + n2;
+    int power = 0;
+    for (;;) {
+        power++;
+        if (a >= n) {
+            a -= n;
+            b -= n;
+        } else if (b >= n) {
+            break;
+        }
+        a <<= 1;
+        b <<= 1;
+    }
+    return power;
+}
+
+// Stable sort of base[0..nmemb) (see above). Returns false only if scratch
+// is NULL and the buffer cannot be allocated.
+static inline bool stable_sort(void *base, size_t nmemb, size_t size,
+                               int (*compar)(const void*, const void*), void *scratch) {
+    if (nmemb < 2 || size == 0) return true;
+    char *a = (char*)base;
+    char *tmp = (char*)scratch;
+    if (!tmp) {
+        tmp = (char*)malloc(STABLE_SORT_SCRATCH_SIZE(nmemb, size));
+        if (!tmp) return false;
+    }
+
+    StableSortRun runs[STABLE_SORT_MAX_PENDING];
+    int top = -1;
+    for (size_t start = 0; start < nmemb;) {
+        size_t len = stable_sort_count_run(SORT_AT(a, start, size), nmemb - start, size, compar);
+        if (len < STABLE_SORT_MIN_RUN) {
+            size_t target = nmemb - start < STABLE_SORT_MIN_RUN ? nmemb - start : STABLE_SORT_MIN_RUN;
+            stable_sort_binary_insertion(SORT_AT(a, start, size), len, target, size, compar, tmp);
+            len = target;
+        }
+        if (top >= 0) {
+            int power = stable_sort_power(runs[top].start, runs[top].len, len, nmemb);
+            // Merge every pending boundary deeper than the new one
+            while (top >= 1 && runs[top - 1].power > power) {
+                stable_sort_merge(SORT_AT(a, runs[top - 1].start, size), runs[top - 1].len, runs[top].len,
+                                  size, compar, tmp);
+                runs[top - 1].len += runs[top].len;
+                top--;
+            }
+            runs[top].power = power;
+        }
+        top++;
+        runs[top].start = start;
+        runs[top].len = len;
+        start += len;
+    }
+    for (; top >= 1; top--) {
+        stable_sort_merge(SORT_AT(a, runs[top - 1].start, size), runs[top - 1].len, runs[top].len,
+                          size, compar, tmp);
+        runs[top - 1].len += runs[top].len;
+    }
+
+    if (!scratch) free(tmp);
+    return true;
+}
+
+#endif // STABLE_SORT_H
@@ -0,0 +1,297 @@
+/**
+ * @file array_stack.h
+ * @brief A contiguous, array-backed stack storing fixed-size elements inline
+ *
+ * Unlike the linked Stack in stack.h, elements are copied by value into one
+ * growable buffer, so push/pop never touch the allocator once the capacity
+ * is large enough. All operations report failure through their return value
+ * instead of terminating the process.
+ */
+
+ #ifndef ARRAY_STACK_H
+ #define ARRAY_STACK_H
+
+ #include <stdlib.h>
+ #include <string.h>
+ #include <stdbool.h>
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Capacity allocated on the first push when none was reserved
+ #define ARRAY_STACK_MIN_CAPACITY 16
+
+ /**
+  * @brief Array-backed stack structure
+  *
+  * Elements live contiguously in @c data; the top element is the one at
+  * index @c size - 1.
+  */
+ typedef struct {
+     void* data;           ///< Element storage
+     size_t size;          ///< Current number of elements
+     size_t capacity;      ///< Number of elements the buffer can hold
+     size_t element_size;  ///< Size of one element in bytes
+ } ArrayStack;
+
+ /* ====================== Basic Operations ====================== */
+
+ /**
+  * @brief Initializes an empty stack in caller-provided storage
+  *
+  * @param s Pointer to the stack
+  * @param element_size Size of one element in bytes (must be non-zero)
+  * @param initial_capacity Number of elements to preallocate (may be 0)
+  * @return true on success, false on invalid arguments or allocation failure
+  */
+ static inline bool array_stack_init(ArrayStack* s, size_t element_size, size_t initial_capacity) {
+     if (s == NULL || element_size == 0) return false;
+     s->data = NULL;
+     s->size = 0;
+     s->capacity = 0;
+     s->element_size = element_size;
+     if (initial_capacity > 0) {
+         s->data = malloc(element_size * initial_capacity);
+         if (s->data == NULL) return false;
+         s->capacity = initial_capacity;
+     }
+     return true;
+ }
+
+ /**
+  * @brief Releases the element buffer of a stack initialized in place
+  *
+  * @param s Pointer to the stack
+  */
+ static inline void array_stack_destroy(ArrayStack* s) {
+     if (s == NULL) return;
+     free(s->data);
+     s->data = NULL;
+     s->size = s->capacity = 0;
+ }
+
+ /**
+  * @brief Creates a new heap-allocated empty stack
+  *
+  * @param element_size Size of one element in bytes
+  * @param initial_capacity Number of elements to preallocate (may be 0)
+  * @return ArrayStack* Pointer to the stack, or NULL on failure
+  * @note The caller must call array_stack_free() to release memory
+  */
+ static inline ArrayStack* array_stack_create(size_t element_size, size_t initial_capacity) {
+     ArrayStack* s = (ArrayStack*)malloc(sizeof(ArrayStack));
+     if (s == NULL) return NULL;
+     if (!array_stack_init(s, element_size, initial_capacity)) {
+         free(s);
+         return NULL;
+     }
+     return s;
+ }
+
+ /**
+  * @brief Frees a stack created with array_stack_create()
+  *
+  * @param s Pointer to the stack (may be NULL)
+  */
+ static inline void array_stack_free(ArrayStack* s) {
+     array_stack_destroy(s);
+     free(s);
+ }
+
+ /**
+  * @brief Ensures room for at least @p capacity elements
+  *
+  * @param s Pointer to the stack
+  * @param capacity Required capacity in elements
+  * @return true on success, false on allocation failure or overflow
+  */
+ static inline bool array_stack_reserve(ArrayStack* s, size_t capacity) {
+     if (capacity <= s->capacity) return true;
+     if (capacity > (size_t)-1 / s->element_size) return false;
+
+     void* new_data = realloc(s->data, capacity * s->element_size);
+     if (new_data == NULL) return false;
+
+     s->data = new_data;
+     s->capacity = capacity;
+     return true;
+ }
+
+ /**
+  * @brief Internal: grows the buffer geometrically to fit @p needed elements
+  */
+ static inline bool array_stack_grow(ArrayStack* s, size_t needed) {
+     size_t new_capacity = s->capacity ? s->capacity : ARRAY_STACK_MIN_CAPACITY;
+     while (new_capacity < needed) {
+         if (new_capacity > (size_t)-1 / 2) {
+             new_capacity = needed;
+             break;
+         }
+         new_capacity *= 2;
+     }
+     return array_stack_reserve(s, new_capacity);
+ }
+
+ /**
+  * @brief Checks if the stack is empty
+  *
+  * @param s Pointer to the stack
+  * @return true if the stack holds no elements
+  */
+ static inline bool array_stack_isEmpty(const ArrayStack* s) {
+     return s->size == 0;
+ }
+
+ /**
+  * @brief Returns the current number of elements
+  *
+  * @param s Pointer to the stack
+  * @return size_t Number of elements in the stack
+  */
+ static inline size_t array_stack_size(const ArrayStack* s) {
+     return s->size;
+ }
+
+ /**
+  * @brief Pushes a copy of an element onto the stack
+  *
+  * @param s Pointer to the stack
+  * @param element Pointer to @c element_size bytes to copy
+  * @return true on success, false on allocation failure
+  */
+ static inline bool array_stack_push(ArrayStack* s, const void* element) {
+     if (s->size == s->capacity && !array_stack_grow(s, s->size + 1)) {
+         return false;
+     }
+     memcpy((char*)s->data + s->size * s->element_size, element, s->element_size);
+     s->size++;
+     return true;
+ }
+
+ /**
+  * @brief Pops the top element
+  *
+  * @param s Pointer to the stack
+  * @param out Receives a copy of the popped element (may be NULL)
+  * @return true on success, false if the stack is empty
+  */
+ static inline bool array_stack_pop(ArrayStack* s, void* out) {
+     if (s->size == 0) return false;
+     s->size--;
+     if (out != NULL) {
+         memcpy(out, (char*)s->data + s->size * s->element_size, s->element_size);
+     }
+     return true;
+ }
+
+ /**
+  * @brief Returns a pointer to the top element without removing it
+  *
+  * @param s Pointer to the stack
+  * @return void* Pointer into the stack buffer, or NULL if empty
+  * @warning The pointer is invalidated by any push that grows the buffer
+  */
+ static inline void* array_stack_top(const ArrayStack* s) {
+     if (s->size == 0) return NULL;
+     return (char*)s->data + (s->size - 1) * s->element_size;
+ }
+
+ /* ====================== Bulk Operations ====================== */
+
+ /**
+  * @brief Pushes @p count contiguous elements in one step
+  *
+  * The last element of @p elements ends up on top, exactly as if each had
+  * been pushed in order.
+  *
+  * @param s Pointer to the stack
+  * @param elements Pointer to @p count elements
+  * @param count Number of elements to push
+  * @return true on success, false on allocation failure (stack unchanged)
+  */
+ static inline bool array_stack_push_n(ArrayStack* s, const void* elements, size_t count) {
+     if (count == 0) return true;
+     if (count > (size_t)-1 - s->size) return false;
+     if (s->size + count > s->capacity && !array_stack_grow(s, s->size + count)) {
+         return false;
+     }
+     memcpy((char*)s->data + s->size * s->element_size, elements, count * s->element_size);
+     s->size += count;
+     return true;
+ }
+
+ /**
+  * @brief Pops up to @p count elements in one step
+  *
+  * Elements are written to @p out in pop order (former top first).
+  *
+  * @param s Pointer to the stack
+  * @param out Buffer of at least @p count elements (may be NULL to discard)
+  * @param count Maximum number of elements to pop
+  * @return size_t Number of elements actually popped
+  */
+ static inline size_t array_stack_pop_n(ArrayStack* s, void* out, size_t count) {
+     if (count > s->size) count = s->size;
+     if (count == 0) return 0;
+     if (out != NULL) {
+         const char* top = (const char*)s->data + (s->size - 1) * s->element_size;
+         char* dst = (char*)out;
+         for (size_t i = 0; i < count; i++) {
+             memcpy(dst, top - i * s->element_size, s->element_size);
+             dst += s->element_size;
+         }
+     }
+     s->size -= count;
+     return count;
+ }
+
+ /* ====================== Advanced Operations ====================== */
+
+ /**
+  * @brief Removes all elements, keeping the allocated capacity
+  *
+  * @param s Pointer to the stack
+  */
+ static inline void array_stack_clear(ArrayStack* s) {
+     s->size = 0;
+ }
+
+ /**
+  * @brief Releases unused capacity
+  *
+  * @param s Pointer to the stack
+  * @return true on success, false if the reallocation failed (stack unchanged)
+  */
+ static inline bool array_stack_shrink_to_fit(ArrayStack* s) {
+     if (s->size == s->capacity) return true;
+     if (s->size == 0) {
+         free(s->data);
+         s->data = NULL;
+         s->capacity = 0;
+         return true;
+     }
+     void* new_data = realloc(s->data, s->size * s->element_size);
+     if (new_data == NULL) return false;
+     s->data = new_data;
+     s->capacity = s->size;
+     return true;
+ }
+
+ /**
+  * @brief Swaps the contents of two stacks
+  *
+  * @param s1 Pointer to first stack
+  * @param s2 Pointer to second stack
+  */
+ static inline void array_stack_swap(ArrayStack* s1, ArrayStack* s2) {
+     ArrayStack tmp = *s1;
+     *s1 = *s2;
+     *s2 = tmp;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // ARRAY_STACK_H
@@ -0,0 +1,800 @@
+/**
+ * @file art.h
+ * @brief Adaptive radix tree: ordered map from C strings to void* values
+ *        with prefix scans and longest-prefix match
+ *
+ * After Leis, Kemper and Neumann, "The Adaptive Radix Tree: ARTful Indexing
+ * for Main-Memory Databases" (ICDE 2013). Each inner node branches on one
+ * key byte and comes in four sizes, replaced by the next size up or down as
+ * children come and go:
+ * - Node4 and Node16: sorted key bytes next to their child pointers; Node16
+ *   compares all 16 bytes at once with SSE2
+ * - Node48: a 256-entry byte index into 48 child slots
+ * - Node256: one child pointer per byte value
+ *
+ * Path compression stores the bytes that all keys below a node share in the
+ * node itself, in full, so keys with long common prefixes (URLs, file paths)
+ * store that prefix once. A leaf holds only the rest of its key after the
+ * path that leads to it, and operations rebuild whole keys from the path when
+ * they are needed. Leaves are tagged child pointers (lowest bit set).
+ *
+ * A key is its bytes plus the terminating NUL, so no key is a prefix of
+ * another, and keys come out in strcmp() order.
+ */
+
+ #ifndef ART_H
+ #define ART_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <string.h>
+
+ #if defined(__SSE2__) && !defined(ART_SCALAR_ONLY)
+ #define ART_SSE2 1
+ #include <emmintrin.h>
+ #endif
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Prefix bytes stored inside the node header; longer prefixes are allocated
+ #define ART_INLINE_PREFIX 8
+
+ typedef enum {
+     ART_NODE4,
+     ART_NODE16,
+     ART_NODE48,
+     ART_NODE256
+ } ArtNodeType;
+
+ /**
+  * @brief Common header of the inner nodes
+  */
+ typedef struct {
+     uint8_t type;                          ///< ArtNodeType
+     uint16_t num_children;
+     uint32_t prefix_len;
+     union {
+         uint8_t bytes[ART_INLINE_PREFIX];  ///< prefix_len <= ART_INLINE_PREFIX
+         uint8_t* heap;                     ///< Otherwise
+     } prefix;
+ } ArtNode;
+
+ typedef struct {
+     ArtNode header;
+     uint8_t keys[4];
+     ArtNode* children[4];
+ } ArtNode4;
+
+ typedef struct {
+     ArtNode header;
+     uint8_t keys[16];
+     ArtNode* children[16];
+ } ArtNode16;
+
+ typedef struct {
+     ArtNode header;
+     uint8_t index[256];                    ///< Slot + 1 of each byte's child, 0 if none
+     ArtNode* children[48];
+ } ArtNode48;
+
+ typedef struct {
+     ArtNode header;
+     ArtNode* children[256];
+ } ArtNode256;
+
+ /**
+  * @brief Leaf: the key bytes after its path (with the NUL) and the value
+  */
+ typedef struct {
+     void* value;
+     uint32_t len;
+     uint8_t suffix[];
+ } ArtLeaf;
+
+ /**
+  * @brief Adaptive radix tree structure
+  */
+ typedef struct {
+     ArtNode* root;                         ///< NULL, a tagged leaf or an inner node
+     size_t size;
+ } ArtTree;
+
+ /**
+  * @brief Visitor for ordered traversal; returning false stops it
+  */
+ typedef bool (*ArtVisit)(const char* key, void* value, void* ctx);
+
+ /* ---- Nodes and leaves ---- */
+
+ static inline bool art_is_leaf(const ArtNode* n) {
+     return ((uintptr_t)n & 1) != 0;
+ }
+
+ static inline ArtLeaf* art_leaf(const ArtNode* n) {
+     return (ArtLeaf*)((uintptr_t)n & ~(uintptr_t)1);
+ }
+
+ static inline ArtNode* art_tag_leaf(const ArtLeaf* l) {
+     return (ArtNode*)((uintptr_t)l | 1);
+ }
+
+ static inline ArtLeaf* art_leaf_create(const uint8_t* suffix, uint32_t len, void* value) {
+     ArtLeaf* l = (ArtLeaf*)malloc(sizeof(ArtLeaf) + len);
+     if (l == NULL) return NULL;
+     l->value = value;
+     l->len = len;
+     memcpy(l->suffix, suffix, len);
+     return l;
+ }
+
+ static inline const uint8_t* art_prefix(const ArtNode* n) {
+     return n->prefix_len <= ART_INLINE_PREFIX ? n->prefix.bytes : n->prefix.heap;
+ }
+
+ // Replaces the prefix with bytes[0..len), which may point into the current
+ // prefix. Only a prefix growing past ART_INLINE_PREFIX allocates, so
+ // shortening never fails.
+ static inline bool art_set_prefix(ArtNode* n, const uint8_t* bytes, uint32_t len) {
+     bool heap = n->prefix_len > ART_INLINE_PREFIX;
+     if (len <= ART_INLINE_PREFIX) {
+         uint8_t tmp[ART_INLINE_PREFIX];
+         memcpy(tmp, bytes, len);
+         if (heap) free(n->prefix.heap);
+         memcpy(n->prefix.bytes, tmp, len);
+     } else if (heap && len <= n->prefix_len) {
+         memmove(n->prefix.heap, bytes, len);
+     } else {
+         uint8_t* p = (uint8_t*)malloc(len);
+         if (p == NULL) return false;
+         memcpy(p, bytes, len);
+         if (heap) free(n->prefix.heap);
+         n->prefix.heap = p;
+     }
+     n->prefix_len = len;
+     return true;
+ }
+
+ static inline ArtNode* art_node_create(ArtNodeType type) {
+     static const size_t sizes[] = { sizeof(ArtNode4), sizeof(ArtNode16), sizeof(ArtNode48), sizeof(ArtNode256) };
+     ArtNode* n = (ArtNode*)calloc(1, sizes[type]);
+     if (n != NULL) n->type = (uint8_t)type;
+     return n;
+ }
+
+ static inline void art_node_free(ArtNode* n) {
+     if (art_is_leaf(n)) {
+         free(art_leaf(n));
+         return;
+     }
+     if (n->prefix_len > ART_INLINE_PREFIX) free(n->prefix.heap);
+     free(n);
+ }
+
+ // Position of byte c among the sorted keys of a Node16 (or -1)
+ static inline int art_node16_find(const ArtNode16* n, uint8_t c) {
+     unsigned valid = (1u << n->header.num_children) - 1;
+ #ifdef ART_SSE2
+     __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i*)n->keys));
+     unsigned mask = (unsigned)_mm_movemask_epi8(cmp) & valid;
+     return mask ? __builtin_ctz(mask) : -1;
+ #else
+     (void)valid;
+     for (int i = 0; i < n->header.num_children; i++) {
+         if (n->keys[i] == c) return i;
+     }
+     return -1;
+ #endif
+ }
+
+ // Number of Node16 keys below byte c, the insertion position
+ static inline int art_node16_lower(const ArtNode16* n, uint8_t c) {
+ #ifdef ART_SSE2
+     // Signed byte compare, so both sides are offset by 0x80
+     const __m128i bias = _mm_set1_epi8((char)0x80);
+     __m128i keys = _mm_xor_si128(_mm_loadu_si128((const __m128i*)n->keys), bias);
+     __m128i lt = _mm_cmplt_epi8(keys, _mm_xor_si128(_mm_set1_epi8((char)c), bias));
+     unsigned mask = (unsigned)_mm_movemask_epi8(lt) & ((1u << n->header.num_children) - 1);
+     return __builtin_popcount(mask);
+ #else
+     int i = 0;
+     while (i < n->header.num_children && n->keys[i] < c) i++;
+     return i;
+ #endif
+ }
+
+ // Slot holding the child for byte c, or NULL
+ static inline ArtNode** art_find_child(ArtNode* n, uint8_t c) {
+     switch (n->type) {
+     case ART_NODE4: {
+         ArtNode4* n4 = (ArtNode4*)n;
+         for (int i = 0; i < n->num_children; i++) {
+             if (n4->keys[i] == c) return &n4->children[i];
+         }
+         return NULL;
+     }
+     case ART_NODE16: {
+         ArtNode16* n16 = (ArtNode16*)n;
+         int i = art_node16_find(n16, c);
+         return i >= 0 ? &n16->children[i] : NULL;
+     }
+     case ART_NODE48: {
+         ArtNode48* n48 = (ArtNode48*)n;
+         return n48->index[c] ? &n48->children[n48->index[c] - 1] : NULL;
+     }
+     default: {
+         ArtNode256* n256 = (ArtNode256*)n;
+         return n256->children[c] != NULL ? &n256->children[c] : NULL;
+     }
+     }
+ }
+
+ /* ---- Creation ---- */
+
+ /**
+  * @brief Creates an empty tree
+  *
+  * @return ArtTree* The tree, or NULL on allocation failure
+  */
+ static inline ArtTree* art_create(void) {
+     return (ArtTree*)calloc(1, sizeof(ArtTree));
+ }
+
+ static inline void art_free_subtree(ArtNode* n) {
+     if (n == NULL) return;
+     if (!art_is_leaf(n)) {
+         switch (n->type) {
+         case ART_NODE4:
+             for (int i = 0; i < n->num_children; i++) art_free_subtree(((ArtNode4*)n)->children[i]);
+             break;
+         case ART_NODE16:
+             for (int i = 0; i < n->num_children; i++) art_free_subtree(((ArtNode16*)n)->children[i]);
+             break;
+         case ART_NODE48:
+             for (int i = 0; i < 48; i++) art_free_subtree(((ArtNode48*)n)->children[i]);
+             break;
+         default:
+             for (int i = 0; i < 256; i++) art_free_subtree(((ArtNode256*)n)->children[i]);
+             break;
+         }
+     }
+     art_node_free(n);
+ }
+
+ /**
+  * @brief Frees a tree and its keys (NULL is allowed); values are not freed
+  */
+ static inline void art_free(ArtTree* t) {
+     if (t == NULL) return;
+     art_free_subtree(t->root);
+     free(t);
+ }
+
+ static inline size_t art_size(const ArtTree* t) {
+     return t->size;
+ }
+
+ /* ---- Lookup ---- */
+
+ /**
+  * @brief Value stored under @p key, or NULL if absent
+  */
+ static inline void* art_get(const ArtTree* t, const char* key) {
+     const uint8_t* k = (const uint8_t*)key;
+     size_t len = strlen(key) + 1, depth = 0;
+     ArtNode* n = t->root;
+     while (n != NULL) {
+         if (art_is_leaf(n)) {
+             const ArtLeaf* l = art_leaf(n);
+             return l->len == len - depth && memcmp(l->suffix, k + depth, l->len) == 0 ? l->value : NULL;
+         }
+         // A prefix never contains the NUL, so a match stops before the end
+         if (n->prefix_len >= len - depth || memcmp(art_prefix(n), k + depth, n->prefix_len) != 0) return NULL;
+         depth += n->prefix_len;
+         ArtNode** child = art_find_child(n, k[depth]);
+         if (child == NULL) return NULL;
+         n = *child;
+         depth++;
+     }
+     return NULL;
+ }
+
+ static inline bool art_contains(const ArtTree* t, const char* key) {
+     const uint8_t* k = (const uint8_t*)key;
+     size_t len = strlen(key) + 1, depth = 0;
+     ArtNode* n = t->root;
+     while (n != NULL && !art_is_leaf(n)) {
+         if (n->prefix_len >= len - depth || memcmp(art_prefix(n), k + depth, n->prefix_len) != 0) return false;
+         depth += n->prefix_len;
+         ArtNode** child = art_find_child(n, k[depth]);
+         if (child == NULL) return false;
+         n = *child;
+         depth++;
+     }
+     if (n == NULL) return false;
+     const ArtLeaf* l = art_leaf(n);
+     return l->len == len - depth && memcmp(l->suffix, k + depth, l->len) == 0;
+ }
+
+ /**
+  * @brief Finds the longest key that is a prefix of @p query (or equal to it)
+  *
+  * @param length Receives that key's length in bytes (may be NULL)
+  * @param value Receives its value (may be NULL)
+  * @return bool Whether any key is a prefix of @p query
+  */
+ static inline bool art_longest_prefix(const ArtTree* t, const char* query, size_t* length, void** value) {
+     const uint8_t* q = (const uint8_t*)query;
+     size_t qlen = strlen(query), depth = 0;
+     bool found = false;
+     ArtNode* n = t->root;
+     while (n != NULL) {
+         if (art_is_leaf(n)) {
+             // The leaf's key without its NUL must be a prefix of the query
+             const ArtLeaf* l = art_leaf(n);
+             if (depth + l->len - 1 <= qlen && memcmp(l->suffix, q + depth, l->len - 1) == 0) {
+                 if (length != NULL) *length = depth + l->len - 1;
+                 if (value != NULL) *value = l->value;
+                 found = true;
+             }
+             break;
+         }
+         if (depth + n->prefix_len > qlen || memcmp(art_prefix(n), q + depth, n->prefix_len) != 0) break;
+         depth += n->prefix_len;
+         // A key that ends here hangs under the NUL byte
+         ArtNode** end = art_find_child(n, 0);
+         if (end != NULL) {
+             if (length != NULL) *length = depth;
+             if (value != NULL) *value = art_leaf(*end)->value;
+             found = true;
+         }
+         if (depth == qlen) break;
+         ArtNode** child = art_find_child(n, q[depth]);
+         if (child == NULL) break;
+         n = *child;
+         depth++;
+     }
+     return found;
+ }
+
+ /* ---- Insertion ---- */
+
+ static inline bool art_add_child(ArtNode** ref, ArtNode* n, uint8_t c, ArtNode* child);
+
+ // Replaces n by a node of the given type holding the same prefix and children
+ static inline ArtNode* art_node_resize(ArtNode** ref, ArtNode* n, ArtNodeType type) {
+     ArtNode* m = art_node_create(type);
+     if (m == NULL) return NULL;
+     m->num_children = n->num_children;
+     m->prefix_len = n->prefix_len;
+     m->prefix = n->prefix;
+     // Gather the children in byte order
+     uint8_t keys[256];
+     ArtNode* children[256];
+     int count = 0;
+     switch (n->type) {
+     case ART_NODE4:
+         memcpy(keys, ((ArtNode4*)n)->keys, n->num_children);
+         memcpy(children, ((ArtNode4*)n)->children, n->num_children * sizeof(ArtNode*));
+         count = n->num_children;
+         break;
+     case ART_NODE16:
+         memcpy(keys, ((ArtNode16*)n)->keys, n->num_children);
+         memcpy(children, ((ArtNode16*)n)->children, n->num_children * sizeof(ArtNode*));
+         count = n->num_children;
+         break;
+     case ART_NODE48:
+         for (int c = 0; c < 256; c++) {
+             if (((ArtNode48*)n)->index[c]) {
+                 keys[count] = (uint8_t)c;
+                 children[count++] = ((ArtNode48*)n)->children[((ArtNode48*)n)->index[c] - 1];
+             }
+         }
+         break;
+     default:
+         for (int c = 0; c < 256; c++) {
+             if (((ArtNode256*)n)->children[c] != NULL) {
+                 keys[count] = (uint8_t)c;
+                 children[count++] = ((ArtNode256*)n)->children[c];
+             }
+         }
+         break;
+     }
+     switch (type) {
+     case ART_NODE4:
+         memcpy(((ArtNode4*)m)->keys, keys, count);
+         memcpy(((ArtNode4*)m)->children, children, count * sizeof(ArtNode*));
+         break;
+     case ART_NODE16:
+         memcpy(((ArtNode16*)m)->keys, keys, count);
+         memcpy(((ArtNode16*)m)->children, children, count * sizeof(ArtNode*));
+         break;
+     case ART_NODE48:
+         for (int i = 0; i < count; i++) {
+             ((ArtNode48*)m)->index[keys[i]] = (uint8_t)(i + 1);
+             ((ArtNode48*)m)->children[i] = children[i];
+         }
+         break;
+     default:
+         for (int i = 0; i < count; i++) ((ArtNode256*)m)->children[keys[i]] = children[i];
+         break;
+     }
+     *ref = m;
+     free(n);                    // The prefix now belongs to m
+     return m;
+ }
+
+ // Adds child under byte c (not present yet), growing n if it is full
+ static inline bool art_add_child(ArtNode** ref, ArtNode* n, uint8_t c, ArtNode* child) {
+     switch (n->type) {
+     case ART_NODE4: {
+         if (n->num_children == 4) {
+             n = art_node_resize(ref, n, ART_NODE16);
+             return n != NULL && art_add_child(ref, n, c, child);
+         }
+         ArtNode4* n4 = (ArtNode4*)n;
+         int i = 0;
+         while (i < n->num_children && n4->keys[i] < c) i++;
+         memmove(n4->keys + i + 1, n4->keys + i, n->num_children - i);
+         memmove(n4->children + i + 1, n4->children + i, (n->num_children - i) * sizeof(ArtNode*));
+         n4->keys[i] = c;
+         n4->children[i] = child;
+         break;
+     }
+     case ART_NODE16: {
+         if (n->num_children == 16) {
+             n = art_node_resize(ref, n, ART_NODE48);
+             return n != NULL && art_add_child(ref, n, c, child);
+         }
+         ArtNode16* n16 = (ArtNode16*)n;
+         int i = art_node16_lower(n16, c);
+         memmove(n16->keys + i + 1, n16->keys + i, n->num_children - i);
+         memmove(n16->children + i + 1, n16->children + i, (n->num_children - i) * sizeof(ArtNode*));
+         n16->keys[i] = c;
+         n16->children[i] = child;
+         break;
+     }
+     case ART_NODE48: {
+         if (n->num_children == 48) {
+             n = art_node_resize(ref, n, ART_NODE256);
+             return n != NULL && art_add_child(ref, n, c, child);
+         }
+         ArtNode48* n48 = (ArtNode48*)n;
+         int slot = 0;
+         while (n48->children[slot] != NULL) slot++;
+         n48->children[slot] = child;
+         n48->index[c] = (uint8_t)(slot + 1);
+         break;
+     }
+     default:
+         ((ArtNode256*)n)->children[c] = child;
+         break;
+     }
+     n->num_children++;
+     return true;
+ }
+
+ /**
+  * @brief Inserts @p key (copied), or replaces its value if present
+  *
+  * @return bool false on allocation failure (the tree is unchanged)
+  */
+ static inline bool art_put(ArtTree* t, const char* key, void* value) {
+     const uint8_t* k = (const uint8_t*)key;
+     size_t len = strlen(key) + 1, depth = 0;
+     if (len > UINT32_MAX) return false;
+     ArtNode** ref = &t->root;
+     for (;;) {
+         ArtNode* n = *ref;
+         if (n == NULL) {
+             ArtLeaf* l = art_leaf_create(k, (uint32_t)len, value);
+             if (l == NULL) return false;
+             *ref = art_tag_leaf(l);
+             t->size++;
+             return true;
+         }
+
+         if (art_is_leaf(n)) {
+             ArtLeaf* l = art_leaf(n);
+             size_t rest = len - depth, common = 0;
+             if (l->len == rest && memcmp(l->suffix, k + depth, rest) == 0) {
+                 l->value = value;
+                 return true;
+             }
+             // Both keys end in a NUL, so they differ before either ends
+             while (l->suffix[common] == k[depth + common]) common++;
+             ArtNode* split = art_node_create(ART_NODE4);
+             ArtLeaf* added = art_leaf_create(k + depth + common + 1, (uint32_t)(rest - common - 1), value);
+             if (split == NULL || added == NULL || !art_set_prefix(split, k + depth, (uint32_t)common)) {
+                 free(split);
+                 free(added);
+                 return false;
+             }
+             uint8_t old_byte = l->suffix[common];
+             l->len -= (uint32_t)(common + 1);
+             memmove(l->suffix, l->suffix + common + 1, l->len);
+             art_add_child(&split, split, old_byte, n);
+             art_add_child(&split, split, k[depth + common], art_tag_leaf(added));
+             *ref = split;
+             t->size++;
+             return true;
+         }
+
+         const uint8_t* prefix = art_prefix(n);
+         uint32_t match = 0;
+         while (match < n->prefix_len && prefix[match] == k[depth + match]) match++;
+         if (match < n->prefix_len) {
+             // The key leaves the prefix: a Node4 takes the shared part
+             ArtNode* split = art_node_create(ART_NODE4);
+             ArtLeaf* added = art_leaf_create(k + depth + match + 1, (uint32_t)(len - depth - match - 1), value);
+             if (split == NULL || added == NULL || !art_set_prefix(split, prefix, match)) {
+                 free(split);
+                 free(added);
+                 return false;
+             }
+             uint8_t old_byte = prefix[match];
+             art_set_prefix(n, prefix + match + 1, n->prefix_len - match - 1);
+             art_add_child(&split, split, old_byte, n);
+             art_add_child(&split, split, k[depth + match], art_tag_leaf(added));
+             *ref = split;
+             t->size++;
+             return true;
+         }
+
+         depth += n->prefix_len;
+         ArtNode** child = art_find_child(n, k[depth]);
+         if (child != NULL) {
+             ref = child;
+             depth++;
+             continue;
+         }
+         ArtLeaf* added = art_leaf_create(k + depth + 1, (uint32_t)(len - depth - 1), value);
+         if (added == NULL || !art_add_child(ref, n, k[depth], art_tag_leaf(added))) {
+             free(added);
+             return false;
+         }
+         t->size++;
+         return true;
+     }
+ }
+
+ /* ---- Removal ---- */
+
+ // A Node4 left with one child is replaced by it, which takes the Node4's
+ // prefix and key byte in front of its own. Skipped if that allocation fails.
+ static inline void art_collapse(ArtNode** ref, ArtNode* n) {
+     ArtNode4* n4 = (ArtNode4*)n;
+     ArtNode* child = n4->children[0];
+     uint32_t head = n->prefix_len + 1;
+     if (art_is_leaf(child)) {
+         ArtLeaf* l = (ArtLeaf*)realloc(art_leaf(child), sizeof(ArtLeaf) + head + art_leaf(child)->len);
+         if (l == NULL) return;
+         memmove(l->suffix + head, l->suffix, l->len);
+         memcpy(l->suffix, art_prefix(n), n->prefix_len);
+         l->suffix[n->prefix_len] = n4->keys[0];
+         l->len += head;
+         child = art_tag_leaf(l);
+     } else {
+         uint32_t total = head + child->prefix_len;
+         uint8_t* joined = (uint8_t*)malloc(total);
+         if (joined == NULL) return;
+         memcpy(joined, art_prefix(n), n->prefix_len);
+         joined[n->prefix_len] = n4->keys[0];
+         memcpy(joined + head, art_prefix(child), child->prefix_len);
+         bool ok = art_set_prefix(child, joined, total);
+         free(joined);
+         if (!ok) return;
+     }
+     *ref = child;
+     art_node_free(n);
+ }
+
+ // Removes the child under byte c, shrinking n when it gets sparse
+ static inline void art_remove_child(ArtNode** ref, ArtNode* n, uint8_t c) {
+     switch (n->type) {
+     case ART_NODE4: {
+         ArtNode4* n4 = (ArtNode4*)n;
+         int i = 0;
+         while (n4->keys[i] != c) i++;
+         memmove(n4->keys + i, n4->keys + i + 1, n->num_children - i - 1);
+         memmove(n4->children + i, n4->children + i + 1, (n->num_children - i - 1) * sizeof(ArtNode*));
+         if (--n->num_children == 1) art_collapse(ref, n);
+         break;
+     }
+     case ART_NODE16: {
+         ArtNode16* n16 = (ArtNode16*)n;
+         int i = art_node16_find(n16, c);
+         memmove(n16->keys + i, n16->keys + i + 1, n->num_children - i - 1);
+         memmove(n16->children + i, n16->children + i + 1, (n->num_children - i - 1) * sizeof(ArtNode*));
+         if (--n->num_children == 3) art_node_resize(ref, n, ART_NODE4);
+         break;
+     }
+     case ART_NODE48: {
+         ArtNode48* n48 = (ArtNode48*)n;
+         n48->children[n48->index[c] - 1] = NULL;
+         n48->index[c] = 0;
+         if (--n->num_children == 12) art_node_resize(ref, n, ART_NODE16);
+         break;
+     }
+     default:
+         ((ArtNode256*)n)->children[c] = NULL;
+         if (--n->num_children == 37) art_node_resize(ref, n, ART_NODE48);
+         break;
+     }
+ }
+
+ /**
+  * @brief Removes @p key
+  *
+  * @return void* Its value, or NULL if absent
+  */
+ static inline void* art_remove(ArtTree* t, const char* key) {
+     const uint8_t* k = (const uint8_t*)key;
+     size_t len = strlen(key) + 1, depth = 0;
+     ArtNode** ref = &t->root;
+     ArtNode** parent_ref = NULL;
+     uint8_t byte = 0;
+     while (*ref != NULL && !art_is_leaf(*ref)) {
+         ArtNode* n = *ref;
+         if (n->prefix_len >= len - depth || memcmp(art_prefix(n), k + depth, n->prefix_len) != 0) return NULL;
+         depth += n->prefix_len;
+         ArtNode** child = art_find_child(n, k[depth]);
+         if (child == NULL) return NULL;
+         parent_ref = ref;
+         byte = k[depth];
+         ref = child;
+         depth++;
+     }
+     if (*ref == NULL) return NULL;
+     ArtLeaf* l = art_leaf(*ref);
+     if (l->len != len - depth || memcmp(l->suffix, k + depth, l->len) != 0) return NULL;
+     void* value = l->value;
+     free(l);
+     if (parent_ref == NULL) t->root = NULL;
+     else art_remove_child(parent_ref, *parent_ref, byte);
+     t->size--;
+     return value;
+ }
+
+ /* ---- Ordered traversal ---- */
+
+ typedef struct {
+     char* bytes;
+     size_t len;
+     size_t cap;
+     ArtVisit visit;
+     void* ctx;
+     size_t visited;
+     bool stop;
+ } ArtWalk;
+
+ static inline bool art_walk_append(ArtWalk* w, const uint8_t* bytes, size_t len) {
+     if (w->len + len > w->cap) {
+         size_t cap = w->cap ? w->cap : 64;
+         while (cap < w->len + len) cap *= 2;
+         char* p = (char*)realloc(w->bytes, cap);
+         if (p == NULL) {
+             w->stop = true;
+             return false;
+         }
+         w->bytes = p;
+         w->cap = cap;
+     }
+     if (len > 0) memcpy(w->bytes + w->len, bytes, len);
+     w->len += len;
+     return true;
+ }
+
+ // Visits the keys under n in order; w->bytes holds the path leading to n
+ static inline void art_walk(ArtWalk* w, ArtNode* n) {
+     size_t mark = w->len;
+     if (art_is_leaf(n)) {
+         const ArtLeaf* l = art_leaf(n);
+         if (art_walk_append(w, l->suffix, l->len)) {
+             w->visited++;
+             if (!w->visit(w->bytes, l->value, w->ctx)) w->stop = true;
+         }
+         w->len = mark;
+         return;
+     }
+     if (!art_walk_append(w, art_prefix(n), n->prefix_len)) return;
+     if (n->type == ART_NODE4 || n->type == ART_NODE16) {
+         // Sorted key bytes
+         const uint8_t* keys = n->type == ART_NODE4 ? ((ArtNode4*)n)->keys : ((ArtNode16*)n)->keys;
+         ArtNode** children = n->type == ART_NODE4 ? ((ArtNode4*)n)->children : ((ArtNode16*)n)->children;
+         for (int i = 0; i < n->num_children && !w->stop; i++) {
+             if (!art_walk_append(w, &keys[i], 1)) break;
+             art_walk(w, children[i]);
+             w->len--;
+         }
+     } else {
+         for (int c = 0; c < 256 && !w->stop; c++) {
+             ArtNode** child = art_find_child(n, (uint8_t)c);
+             if (child == NULL) continue;
+             uint8_t byte = (uint8_t)c;
+             if (!art_walk_append(w, &byte, 1)) break;
+             art_walk(w, *child);
+             w->len--;
+         }
+     }
+     w->len = mark;
+ }
+
+ /**
+  * @brief Calls visit(key, value, ctx) for every key in strcmp() order,
+  *        until it returns false
+  *
+  * @return size_t Number of keys visited
+  */
+ static inline size_t art_iterate(const ArtTree* t, ArtVisit visit, void* ctx) {
+     ArtWalk w = { NULL, 0, 0, visit, ctx, 0, false };
+     if (t->root != NULL) art_walk(&w, t->root);
+     free(w.bytes);
+     return w.visited;
+ }
+
+ /**
+  * @brief Calls visit(key, value, ctx) for every key that starts with
+  *        @p prefix, in strcmp() order, until it returns false
+  *
+  * @return size_t Number of keys visited
+  */
+ static inline size_t art_scan_prefix(const ArtTree* t, const char* prefix, ArtVisit visit, void* ctx) {
+     const uint8_t* p = (const uint8_t*)prefix;
+     size_t plen = strlen(prefix), depth = 0;
+     ArtWalk w = { NULL, 0, 0, visit, ctx, 0, false };
+     ArtNode* n = t->root;
+     while (n != NULL) {
+         if (depth == plen) {
+             art_walk(&w, n);
+             break;
+         }
+         if (art_is_leaf(n)) {
+             const ArtLeaf* l = art_leaf(n);
+             if (l->len > plen - depth && memcmp(l->suffix, p + depth, plen - depth) == 0) art_walk(&w, n);
+             break;
+         }
+         size_t check = n->prefix_len < plen - depth ? n->prefix_len : plen - depth;
+         if (memcmp(art_prefix(n), p + depth, check) != 0) break;
+         if (check < n->prefix_len || depth + check == plen) {
+             // The query prefix ends inside or right after this node's prefix
+             art_walk(&w, n);
+             break;
+         }
+         if (!art_walk_append(&w, art_prefix(n), n->prefix_len)) break;
+         depth += n->prefix_len;
+         ArtNode** child = art_find_child(n, p[depth]);
+         if (child == NULL || !art_walk_append(&w, p + depth, 1)) break;
+         n = *child;
+         depth++;
+     }
+     free(w.bytes);
+     return w.visited;
+ }
+
+ static inline size_t art_subtree_memory(const ArtNode* n) {
+     static const size_t sizes[] = { sizeof(ArtNode4), sizeof(ArtNode16), sizeof(ArtNode48), sizeof(ArtNode256) };
+     if (n == NULL) return 0;
+     if (art_is_leaf(n)) return sizeof(ArtLeaf) + art_leaf(n)->len;
+     size_t bytes = sizes[n->type] + (n->prefix_len > ART_INLINE_PREFIX ? n->prefix_len : 0);
+     for (int c = 0; c < 256; c++) {
+         ArtNode** child = art_find_child((ArtNode*)n, (uint8_t)c);
+         if (child != NULL) bytes += art_subtree_memory(*child);
+     }
+     return bytes;
+ }
+
+ /**
+  * @brief Bytes allocated for nodes, leaves and prefixes (without allocator overhead)
+  */
+ static inline size_t art_memory_usage(const ArtTree* t) {
+     return sizeof(ArtTree) + art_subtree_memory(t->root);
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // ART_H
@@ -0,0 +1,495 @@
+/**
+ * @file bitset.h
+ * @brief Dynamic bitset with word-parallel and AVX2 bulk operations,
+ *        find-next iteration and an optional rank/select index
+ *
+ * Bit i lives in bit (i % 64) of words[i / 64]. A set of small integers in
+ * [0, n) takes n / 8 bytes, against 4 bytes per entry for an int array or
+ * several dozen bytes per element for a HashSet, and tests or updates one
+ * bit with a shift and a mask.
+ *
+ * The word array is 32-byte aligned and padded to a multiple of four words,
+ * and every bit at or above num_bits is kept zero. Whole-set operations
+ * (and, or, xor, andnot, count) therefore run over full 256-bit vectors with
+ * no tail handling. They use AVX2 when the CPU has it, chosen at run time,
+ * so no -mavx2 flag is needed; counting falls back to the POPCNT
+ * instruction, then to portable code (always, with BITSET_SCALAR_ONLY).
+ *
+ * rank(i) (set bits below i) and select(k) (position of the k-th set bit)
+ * scan the words without an index. bitset_build_rank() adds one cumulative
+ * count per 512 bits (1/8 of the bitset's size), which makes rank O(1) and
+ * select O(log n). The index is not updated by later changes; build it
+ * again after modifying the bits.
+ */
+
+ #ifndef BITSET_H
+ #define BITSET_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <string.h>
+
+ #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && \
+     !defined(BITSET_SCALAR_ONLY)
+ #define BITSET_X86 1
+ #include <immintrin.h>
+ #define BITSET_TARGET_AVX2 __attribute__((target("avx2")))
+ #define BITSET_TARGET_POPCNT __attribute__((target("popcnt")))
+ #endif
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Returned by the find functions when there is no such bit
+ #define BITSET_NPOS SIZE_MAX
+ /// Bits per rank index entry (8 words)
+ #define BITSET_RANK_BLOCK 512
+
+ /**
+  * @brief Bitset structure
+  */
+ typedef struct {
+     uint64_t* words;          ///< num_words words, 32-byte aligned
+     size_t num_bits;          ///< Bits 0 .. num_bits - 1
+     size_t num_words;         ///< A multiple of 4, padding words are zero
+     uint64_t* rank_blocks;    ///< Set bits before each 512-bit block, or NULL
+ } Bitset;
+
+ /**
+  * @brief Iterates i over the set bits of @p bs in increasing order
+  */
+ #define BITSET_FOREACH(bs, i) \
+     for (size_t i = bitset_find_next((bs), 0); i != BITSET_NPOS; i = bitset_find_next((bs), i + 1))
+
+ static inline size_t bitset_words_for(size_t num_bits) {
+     size_t words = (num_bits + 63) / 64;
+     words = (words + 3) & ~(size_t)3;
+     return words > 0 ? words : 4;
+ }
+
+ static inline uint64_t* bitset_alloc_words(size_t num_words) {
+     uint64_t* words = (uint64_t*)aligned_alloc(32, num_words * sizeof(uint64_t));
+     if (words != NULL) memset(words, 0, num_words * sizeof(uint64_t));
+     return words;
+ }
+
+ // Clears the unused bits of the last partial word
+ static inline void bitset_trim(Bitset* bs) {
+     if (bs->num_bits & 63) bs->words[bs->num_bits / 64] &= ((uint64_t)1 << (bs->num_bits & 63)) - 1;
+ }
+
+ /**
+  * @brief Creates a bitset of @p num_bits zero bits
+  *
+  * @return Bitset* The bitset, or NULL on allocation failure
+  */
+ static inline Bitset* bitset_create(size_t num_bits) {
+     Bitset* bs = (Bitset*)malloc(sizeof(Bitset));
+     if (bs == NULL) return NULL;
+     bs->num_words = bitset_words_for(num_bits);
+     bs->num_bits = num_bits;
+     bs->rank_blocks = NULL;
+     bs->words = bitset_alloc_words(bs->num_words);
+     if (bs->words == NULL) {
+         free(bs);
+         return NULL;
+     }
+     return bs;
+ }
+
+ /**
+  * @brief Frees a bitset (NULL is allowed)
+  */
+ static inline void bitset_free(Bitset* bs) {
+     if (bs == NULL) return;
+     free(bs->words);
+     free(bs->rank_blocks);
+     free(bs);
+ }
+
+ /**
+  * @brief Changes the size to @p num_bits; new bits are zero
+  *
+  * Drops the rank index. On allocation failure the bitset is unchanged.
+  *
+  * @return bool false on allocation failure
+  */
+ static inline bool bitset_resize(Bitset* bs, size_t num_bits) {
+     size_t num_words = bitset_words_for(num_bits);
+     if (num_words != bs->num_words) {
+         uint64_t* words = bitset_alloc_words(num_words);
+         if (words == NULL) return false;
+         memcpy(words, bs->words, (num_words < bs->num_words ? num_words : bs->num_words) * sizeof(uint64_t));
+         free(bs->words);
+         bs->words = words;
+         bs->num_words = num_words;
+     }
+     size_t old_bits = bs->num_bits;
+     bs->num_bits = num_bits;
+     if (num_bits < old_bits) {
+         // Zero everything from the new end up to the old end
+         size_t first = (num_bits + 63) / 64, last = (old_bits + 63) / 64;
+         if (last > num_words) last = num_words;
+         if (first < last) memset(bs->words + first, 0, (last - first) * sizeof(uint64_t));
+         bitset_trim(bs);
+     }
+     free(bs->rank_blocks);
+     bs->rank_blocks = NULL;
+     return true;
+ }
+
+ static inline size_t bitset_size(const Bitset* bs) {
+     return bs->num_bits;
+ }
+
+ /* ---- Single bits (i must be below num_bits) ---- */
+
+ static inline bool bitset_test(const Bitset* bs, size_t i) {
+     return (bs->words[i >> 6] >> (i & 63)) & 1;
+ }
+
+ static inline void bitset_set(Bitset* bs, size_t i) {
+     bs->words[i >> 6] |= (uint64_t)1 << (i & 63);
+ }
+
+ static inline void bitset_clear(Bitset* bs, size_t i) {
+     bs->words[i >> 6] &= ~((uint64_t)1 << (i & 63));
+ }
+
+ static inline void bitset_flip(Bitset* bs, size_t i) {
+     bs->words[i >> 6] ^= (uint64_t)1 << (i & 63);
+ }
+
+ static inline void bitset_assign(Bitset* bs, size_t i, bool value) {
+     uint64_t bit = (uint64_t)1 << (i & 63);
+     bs->words[i >> 6] = (bs->words[i >> 6] & ~bit) | ((uint64_t)value << (i & 63));
+ }
+
+ /**
+  * @brief Sets bit @p i and returns its previous value (one word access,
+  *        the usual visited check of a graph search)
+  */
+ static inline bool bitset_test_and_set(Bitset* bs, size_t i) {
+     uint64_t bit = (uint64_t)1 << (i & 63);
+     uint64_t old = bs->words[i >> 6];
+     bs->words[i >> 6] = old | bit;
+     return (old & bit) != 0;
+ }
+
+ /* ---- Whole bitset ---- */
+
+ static inline void bitset_clear_all(Bitset* bs) {
+     memset(bs->words, 0, bs->num_words * sizeof(uint64_t));
+ }
+
+ static inline void bitset_set_all(Bitset* bs) {
+     size_t used = (bs->num_bits + 63) / 64;
+     memset(bs->words, 0xff, used * sizeof(uint64_t));
+     bitset_trim(bs);
+ }
+
+ static inline bool bitset_any(const Bitset* bs) {
+     for (size_t w = 0; w < bs->num_words; w++) {
+         if (bs->words[w]) return true;
+     }
+     return false;
+ }
+
+ static inline bool bitset_equal(const Bitset* a, const Bitset* b) {
+     return a->num_bits == b->num_bits && memcmp(a->words, b->words, a->num_words * sizeof(uint64_t)) == 0;
+ }
+
+ /**
+  * @brief Copies the bits of @p src into @p dst (same size)
+  *
+  * @return bool false if the sizes differ
+  */
+ static inline bool bitset_copy(Bitset* dst, const Bitset* src) {
+     if (dst->num_bits != src->num_bits) return false;
+     memcpy(dst->words, src->words, src->num_words * sizeof(uint64_t));
+     return true;
+ }
+
+ // Without -mpopcnt, __builtin_popcountll() becomes a libgcc call; the SWAR
+ // sum is a dozen inline instructions
+ static inline int bitset_popcount64(uint64_t x) {
+ #ifdef __POPCNT__
+     return __builtin_popcountll(x);
+ #else
+     x = x - ((x >> 1) & 0x5555555555555555ull);
+     x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+     x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+     return (int)((x * 0x0101010101010101ull) >> 56);
+ #endif
+ }
+
+ typedef enum {
+     BITSET_OP_AND,
+     BITSET_OP_OR,
+     BITSET_OP_XOR,
+     BITSET_OP_ANDNOT          ///< a & ~b
+ } BitsetOp;
+
+ static inline void bitset_apply_scalar(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t n, BitsetOp op) {
+     switch (op) {
+     case BITSET_OP_AND:    for (size_t i = 0; i < n; i++) dst[i] = a[i] & b[i]; break;
+     case BITSET_OP_OR:     for (size_t i = 0; i < n; i++) dst[i] = a[i] | b[i]; break;
+     case BITSET_OP_XOR:    for (size_t i = 0; i < n; i++) dst[i] = a[i] ^ b[i]; break;
+     case BITSET_OP_ANDNOT: for (size_t i = 0; i < n; i++) dst[i] = a[i] & ~b[i]; break;
+     }
+ }
+
+ // Popcount of a[i] (& b[i] if b is not NULL), portable
+ static inline uint64_t bitset_count_scalar(const uint64_t* a, const uint64_t* b, size_t n) {
+     uint64_t total = 0;
+     for (size_t i = 0; i < n; i++) total += (uint64_t)bitset_popcount64(b != NULL ? a[i] & b[i] : a[i]);
+     return total;
+ }
+
+ #ifdef BITSET_X86
+
+ static inline bool bitset_has_avx2(void) {
+     __builtin_cpu_init();
+     return __builtin_cpu_supports("avx2");
+ }
+
+ static inline bool bitset_has_popcnt(void) {
+     __builtin_cpu_init();
+     return __builtin_cpu_supports("popcnt");
+ }
+
+ static inline BITSET_TARGET_AVX2 void bitset_apply_avx2(uint64_t* dst, const uint64_t* a, const uint64_t* b,
+                                                         size_t n, BitsetOp op) {
+     for (size_t i = 0; i < n; i += 4) {
+         __m256i x = _mm256_load_si256((const __m256i*)(a + i));
+         __m256i y = _mm256_load_si256((const __m256i*)(b + i));
+         __m256i r;
+         switch (op) {
+         case BITSET_OP_AND:    r = _mm256_and_si256(x, y); break;
+         case BITSET_OP_OR:     r = _mm256_or_si256(x, y); break;
+         case BITSET_OP_XOR:    r = _mm256_xor_si256(x, y); break;
+         default:               r = _mm256_andnot_si256(y, x); break;
+         }
+         _mm256_store_si256((__m256i*)(dst + i), r);
+     }
+ }
+
+ // Nibble lookup popcount (Mula, Kurz and Lemire, "Faster Population Counts
+ // Using AVX2 Instructions", 2016): vpshufb counts the bits of every 4-bit
+ // half of the 32 bytes, vpsadbw sums the byte counts into 64-bit lanes
+ static inline BITSET_TARGET_AVX2 uint64_t bitset_count_avx2(const uint64_t* a, const uint64_t* b, size_t n) {
+     const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                             0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+     const __m256i low_mask = _mm256_set1_epi8(0x0f);
+     __m256i total = _mm256_setzero_si256();
+     size_t i = 0;
+     while (i < n) {
+         // Byte counters reach at most 8 per vector, so 31 vectors fit in a byte
+         size_t end = n - i > 31 * 4 ? i + 31 * 4 : n;
+         __m256i bytes = _mm256_setzero_si256();
+         for (; i < end; i += 4) {
+             __m256i v = _mm256_load_si256((const __m256i*)(a + i));
+             if (b != NULL) v = _mm256_and_si256(v, _mm256_load_si256((const __m256i*)(b + i)));
+             __m256i lo = _mm256_and_si256(v, low_mask);
+             __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+             bytes = _mm256_add_epi8(bytes, _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                                            _mm256_shuffle_epi8(lookup, hi)));
+         }
+         total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+     }
+     return (uint64_t)_mm256_extract_epi64(total, 0) + (uint64_t)_mm256_extract_epi64(total, 1) +
+            (uint64_t)_mm256_extract_epi64(total, 2) + (uint64_t)_mm256_extract_epi64(total, 3);
+ }
+
+ static inline BITSET_TARGET_POPCNT uint64_t bitset_count_popcnt(const uint64_t* a, const uint64_t* b, size_t n) {
+     uint64_t total = 0;
+     for (size_t i = 0; i < n; i++) total += (uint64_t)__builtin_popcountll(b != NULL ? a[i] & b[i] : a[i]);
+     return total;
+ }
+
+ #endif // BITSET_X86
+
+ static inline uint64_t bitset_count_words(const uint64_t* a, const uint64_t* b, size_t n) {
+ #ifdef BITSET_X86
+     if (bitset_has_avx2()) return bitset_count_avx2(a, b, n);
+     if (bitset_has_popcnt()) return bitset_count_popcnt(a, b, n);
+ #endif
+     return bitset_count_scalar(a, b, n);
+ }
+
+ /**
+  * @brief dst = a op b, word by word; @p dst may be @p a or @p b
+  *
+  * @return bool false if the three sizes differ
+  */
+ static inline bool bitset_apply(Bitset* dst, const Bitset* a, const Bitset* b, BitsetOp op) {
+     if (a->num_bits != b->num_bits || dst->num_bits != a->num_bits) return false;
+ #ifdef BITSET_X86
+     if (bitset_has_avx2()) {
+         bitset_apply_avx2(dst->words, a->words, b->words, a->num_words, op);
+         return true;
+     }
+ #endif
+     bitset_apply_scalar(dst->words, a->words, b->words, a->num_words, op);
+     return true;
+ }
+
+ static inline bool bitset_and(Bitset* dst, const Bitset* a, const Bitset* b) {
+     return bitset_apply(dst, a, b, BITSET_OP_AND);
+ }
+
+ static inline bool bitset_or(Bitset* dst, const Bitset* a, const Bitset* b) {
+     return bitset_apply(dst, a, b, BITSET_OP_OR);
+ }
+
+ static inline bool bitset_xor(Bitset* dst, const Bitset* a, const Bitset* b) {
+     return bitset_apply(dst, a, b, BITSET_OP_XOR);
+ }
+
+ /**
+  * @brief dst = a & ~b (set difference a \ b)
+  */
+ static inline bool bitset_andnot(Bitset* dst, const Bitset* a, const Bitset* b) {
+     return bitset_apply(dst, a, b, BITSET_OP_ANDNOT);
+ }
+
+ /**
+  * @brief Number of set bits
+  */
+ static inline uint64_t bitset_count(const Bitset* bs) {
+     return bitset_count_words(bs->words, NULL, bs->num_words);
+ }
+
+ /**
+  * @brief Size of the intersection of @p a and @p b, without building it
+  *
+  * @return uint64_t The count, or 0 if the sizes differ
+  */
+ static inline uint64_t bitset_count_and(const Bitset* a, const Bitset* b) {
+     if (a->num_bits != b->num_bits) return 0;
+     return bitset_count_words(a->words, b->words, a->num_words);
+ }
+
+ /* ---- Iteration ---- */
+
+ /**
+  * @brief First set bit at or after @p from, or BITSET_NPOS
+  */
+ static inline size_t bitset_find_next(const Bitset* bs, size_t from) {
+     if (from >= bs->num_bits) return BITSET_NPOS;
+     size_t w = from >> 6;
+     uint64_t word = bs->words[w] & (~(uint64_t)0 << (from & 63));
+     while (word == 0) {
+         if (++w >= bs->num_words) return BITSET_NPOS;
+         word = bs->words[w];
+     }
+     return w * 64 + (size_t)__builtin_ctzll(word);
+ }
+
+ /**
+  * @brief First clear bit at or after @p from, or BITSET_NPOS
+  */
+ static inline size_t bitset_find_next_zero(const Bitset* bs, size_t from) {
+     if (from >= bs->num_bits) return BITSET_NPOS;
+     size_t w = from >> 6;
+     uint64_t word = ~bs->words[w] & (~(uint64_t)0 << (from & 63));
+     while (word == 0) {
+         if (++w >= bs->num_words) return BITSET_NPOS;
+         word = ~bs->words[w];
+     }
+     size_t i = w * 64 + (size_t)__builtin_ctzll(word);
+     return i < bs->num_bits ? i : BITSET_NPOS;
+ }
+
+ static inline size_t bitset_find_first(const Bitset* bs) {
+     return bitset_find_next(bs, 0);
+ }
+
+ /* ---- Rank and select ---- */
+
+ /**
+  * @brief Builds (or rebuilds) the rank/select index
+  *
+  * @return bool false on allocation failure
+  */
+ static inline bool bitset_build_rank(Bitset* bs) {
+     size_t blocks = bs->num_words / 8 + 1;
+     uint64_t* rank = (uint64_t*)realloc(bs->rank_blocks, (blocks + 1) * sizeof(uint64_t));
+     if (rank == NULL) return false;
+     uint64_t total = 0;
+     for (size_t k = 0; k < blocks; k++) {
+         rank[k] = total;
+         size_t first = k * 8, last = first + 8 < bs->num_words ? first + 8 : bs->num_words;
+         for (size_t w = first; w < last; w++) total += (uint64_t)bitset_popcount64(bs->words[w]);
+     }
+     rank[blocks] = total;
+     bs->rank_blocks = rank;
+     return true;
+ }
+
+ /**
+  * @brief Number of set bits in [0, i); @p i may be up to num_bits
+  */
+ static inline uint64_t bitset_rank(const Bitset* bs, size_t i) {
+     if (i > bs->num_bits) i = bs->num_bits;
+     size_t w = i >> 6, first = 0;
+     uint64_t total = 0;
+     if (bs->rank_blocks != NULL) {
+         first = (i / BITSET_RANK_BLOCK) * 8;
+         total = bs->rank_blocks[i / BITSET_RANK_BLOCK];
+     }
+     for (size_t k = first; k < w; k++) total += (uint64_t)bitset_popcount64(bs->words[k]);
+     if (i & 63) total += (uint64_t)bitset_popcount64(bs->words[w] & (((uint64_t)1 << (i & 63)) - 1));
+     return total;
+ }
+
+ // Position of the k-th (0-based) set bit of a word that has more than k
+ static inline int bitset_select64(uint64_t word, uint64_t k) {
+     // Skip whole bytes, then single bits
+     int shift = 0;
+     for (;;) {
+         uint64_t in_byte = (uint64_t)bitset_popcount64(word & 0xff);
+         if (k < in_byte) break;
+         k -= in_byte;
+         word >>= 8;
+         shift += 8;
+     }
+     for (; k > 0; k--) word &= word - 1;
+     return shift + __builtin_ctzll(word);
+ }
+
+ /**
+  * @brief Position of the k-th set bit (k = 0 is the first), or BITSET_NPOS
+  *        if fewer than k + 1 bits are set
+  */
+ static inline size_t bitset_select(const Bitset* bs, uint64_t k) {
+     size_t w = 0;
+     if (bs->rank_blocks != NULL) {
+         // Last block whose starting rank is <= k
+         size_t blocks = bs->num_words / 8 + 1;
+         if (k >= bs->rank_blocks[blocks]) return BITSET_NPOS;
+         // Branch-free halving: the comparisons are unpredictable
+         size_t base = 0, len = blocks;
+         while (len > 1) {
+             size_t half = len / 2;
+             base = bs->rank_blocks[base + half] <= k ? base + half : base;
+             len -= half;
+         }
+         k -= bs->rank_blocks[base];
+         w = base * 8;
+     }
+     for (; w < bs->num_words; w++) {
+         uint64_t count = (uint64_t)bitset_popcount64(bs->words[w]);
+         if (k < count) return w * 64 + (size_t)bitset_select64(bs->words[w], k);
+         k -= count;
+     }
+     return BITSET_NPOS;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // BITSET_H
@@ -0,0 +1,664 @@
+/**
+ * @file btree.h
+ * @brief In-memory B+-tree ordered map from uint64_t keys to uint64_t values
+ *
+ * All entries live in the leaves, which are linked left to right, so a range
+ * scan is one descent followed by a walk over consecutive arrays. Inner
+ * nodes hold only separator keys and child pointers. Keys are stored inline
+ * in fixed-size arrays at the start of each node, and nodes are allocated on
+ * 64-byte boundaries: with the default 32 keys, a node's keys fill exactly
+ * four cache lines, and a lookup in a tree of 10^7 keys touches five nodes.
+ *
+ * The position of a key inside a node is found with AVX2, four 64-bit
+ * comparisons per instruction, when the CPU has it (checked at run time,
+ * as in simd_sort.h); otherwise with a binary search. Define
+ * BTREE_SCALAR_ONLY to always use the binary search.
+ *
+ * Nodes other than the root are kept at least half full. The exception is
+ * an insertion past the last key of a full rightmost leaf, which starts a
+ * new leaf instead of splitting, so ascending insertion fills leaves
+ * completely. btree_bulk_load() builds the tree bottom-up from sorted keys
+ * in O(n).
+ *
+ * Any insertion or removal invalidates iterators.
+ */
+
+ #ifndef BTREE_H
+ #define BTREE_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <string.h>
+
+ #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && \
+     !defined(BTREE_SCALAR_ONLY)
+ #define BTREE_X86 1
+ #include <immintrin.h>
+ #define BTREE_TARGET_AVX2 __attribute__((target("avx2")))
+ #endif
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Keys per inner node (a multiple of 4, at most 64)
+ #ifndef BTREE_INNER_KEYS
+ #define BTREE_INNER_KEYS 32
+ #endif
+ /// Keys per leaf (a multiple of 4, at most 64)
+ #ifndef BTREE_LEAF_KEYS
+ #define BTREE_LEAF_KEYS 32
+ #endif
+
+ #if BTREE_INNER_KEYS % 4 != 0 || BTREE_LEAF_KEYS % 4 != 0 || BTREE_INNER_KEYS > 64 || BTREE_LEAF_KEYS > 64
+ #error "BTREE_INNER_KEYS and BTREE_LEAF_KEYS must be multiples of 4, at most 64"
+ #endif
+
+ /// Maximum number of inner levels
+ #define BTREE_MAX_HEIGHT 32
+
+ /**
+  * @brief Leaf: sorted keys and their values
+  */
+ typedef struct BTreeLeaf {
+     uint64_t keys[BTREE_LEAF_KEYS];
+     uint64_t values[BTREE_LEAF_KEYS];
+     struct BTreeLeaf* next;               ///< Leaf to the right, or NULL
+     uint32_t count;
+ } BTreeLeaf;
+
+ /**
+  * @brief Inner node: keys under children[i] are < keys[i] <= keys under children[i + 1]
+  */
+ typedef struct {
+     uint64_t keys[BTREE_INNER_KEYS];
+     void* children[BTREE_INNER_KEYS + 1];
+     uint32_t count;                        ///< Keys; there are count + 1 children
+ } BTreeInner;
+
+ /**
+  * @brief B+-tree structure
+  */
+ typedef struct {
+     void* root;
+     uint32_t height;                       ///< Inner levels above the leaves, 0 if the root is a leaf
+     size_t size;
+     BTreeLeaf* first;                      ///< Leftmost leaf
+     bool simd;                             ///< AVX2 node search
+ } BTree;
+
+ /**
+  * @brief Position of an entry: leaf is NULL past the last entry
+  */
+ typedef struct {
+     const BTreeLeaf* leaf;
+     uint32_t pos;
+ } BTreeIter;
+
+ static inline void* btree_alloc_node(size_t size) {
+     size = (size + 63) & ~(size_t)63;
+     void* node = aligned_alloc(64, size);
+     if (node != NULL) memset(node, 0, size);
+     return node;
+ }
+
+ /* ---- Node search ---- */
+
+ // Index of the first of keys[0..count) that is >= key (> key if upper)
+ static inline uint32_t btree_search_scalar(const uint64_t* keys, uint32_t count, uint64_t key, bool upper) {
+     uint32_t lo = 0, n = count;
+     while (n > 0) {
+         uint32_t half = n / 2;
+         bool right = upper ? keys[lo + half] <= key : keys[lo + half] < key;
+         if (right) {
+             lo += half + 1;
+             n -= half + 1;
+         } else {
+             n = half;
+         }
+     }
+     return lo;
+ }
+
+ #ifdef BTREE_X86
+
+ static inline bool btree_has_avx2(void) {
+     __builtin_cpu_init();
+     return __builtin_cpu_supports("avx2");
+ }
+
+ // Same result as btree_search_scalar(), four keys per compare. AVX2 only has
+ // a signed 64-bit compare, so both sides are offset by 2^63. Lanes past
+ // count hold stale keys and only ever produce a position >= count.
+ static inline BTREE_TARGET_AVX2 uint32_t btree_search_avx2(const uint64_t* keys, uint32_t count, uint64_t key,
+                                                            bool upper) {
+     if (!upper) {
+         // First key >= key is the first key > key - 1
+         if (key == 0) return 0;
+         key--;
+     }
+     const __m256i bias = _mm256_set1_epi64x((long long)0x8000000000000000ull);
+     __m256i k = _mm256_xor_si256(_mm256_set1_epi64x((long long)key), bias);
+     for (uint32_t i = 0; i < count; i += 4) {
+         __m256i v = _mm256_xor_si256(_mm256_load_si256((const __m256i*)(keys + i)), bias);
+         unsigned greater = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, k)));
+         if (greater) {
+             uint32_t pos = i + (uint32_t)__builtin_ctz(greater);
+             return pos < count ? pos : count;
+         }
+     }
+     return count;
+ }
+
+ #endif // BTREE_X86
+
+ static inline uint32_t btree_search(const BTree* t, const uint64_t* keys, uint32_t count, uint64_t key, bool upper) {
+ #ifdef BTREE_X86
+     if (t->simd) return btree_search_avx2(keys, count, key, upper);
+ #else
+     (void)t;
+ #endif
+     return btree_search_scalar(keys, count, key, upper);
+ }
+
+ static inline BTreeLeaf* btree_find_leaf(const BTree* t, uint64_t key) {
+     void* node = t->root;
+     for (uint32_t h = t->height; h > 0; h--) {
+         const BTreeInner* in = (const BTreeInner*)node;
+         node = in->children[btree_search(t, in->keys, in->count, key, true)];
+     }
+     return (BTreeLeaf*)node;
+ }
+
+ /* ---- Creation ---- */
+
+ /**
+  * @brief Creates an empty tree
+  *
+  * @return BTree* The tree, or NULL on allocation failure
+  */
+ static inline BTree* btree_create(void) {
+     BTree* t = (BTree*)malloc(sizeof(BTree));
+     if (t == NULL) return NULL;
+     BTreeLeaf* leaf = (BTreeLeaf*)btree_alloc_node(sizeof(BTreeLeaf));
+     if (leaf == NULL) {
+         free(t);
+         return NULL;
+     }
+     t->root = leaf;
+     t->first = leaf;
+     t->height = 0;
+     t->size = 0;
+ #ifdef BTREE_X86
+     t->simd = btree_has_avx2();
+ #else
+     t->simd = false;
+ #endif
+     return t;
+ }
+
+ static inline void btree_free_node(void* node, uint32_t height) {
+     if (height > 0) {
+         BTreeInner* in = (BTreeInner*)node;
+         for (uint32_t i = 0; i <= in->count; i++) btree_free_node(in->children[i], height - 1);
+     }
+     free(node);
+ }
+
+ /**
+  * @brief Frees a tree (NULL is allowed)
+  */
+ static inline void btree_free(BTree* t) {
+     if (t == NULL) return;
+     btree_free_node(t->root, t->height);
+     free(t);
+ }
+
+ /**
+  * @brief Builds a tree from keys[0..n) in strictly increasing order
+  *
+  * Leaves are filled as evenly and as fully as possible, and every level
+  * above is built from the one below, in O(n).
+  *
+  * @param values Value of each key, or NULL to store 0
+  * @return BTree* The tree, or NULL if the keys are not strictly increasing
+  *         or allocation fails
+  */
+ static inline BTree* btree_bulk_load(const uint64_t* keys, const uint64_t* values, size_t n) {
+     for (size_t i = 1; i < n; i++) {
+         if (keys[i - 1] >= keys[i]) return NULL;
+     }
+     BTree* t = btree_create();
+     if (t == NULL || n == 0) return t;
+
+     size_t leaves = (n + BTREE_LEAF_KEYS - 1) / BTREE_LEAF_KEYS;
+     // level[j] and low[j]: the j-th node of the level being built and its smallest key
+     void** level = (void**)malloc(leaves * sizeof(void*));
+     uint64_t* low = (uint64_t*)malloc(leaves * sizeof(uint64_t));
+     // Every node allocated so far, to undo a failed load
+     void** nodes = (void**)malloc(2 * leaves * sizeof(void*));
+     size_t num_nodes = 0;
+     bool ok = level != NULL && low != NULL && nodes != NULL;
+
+     size_t done = 0;
+     BTreeLeaf* prev = (BTreeLeaf*)t->root;             // The empty leaf of btree_create() becomes the first
+     for (size_t j = 0; ok && j < leaves; j++) {
+         BTreeLeaf* leaf = j == 0 ? prev : (BTreeLeaf*)btree_alloc_node(sizeof(BTreeLeaf));
+         if (leaf == NULL) {
+             ok = false;
+             break;
+         }
+         if (j > 0) {
+             nodes[num_nodes++] = leaf;
+             prev->next = leaf;
+         }
+         uint32_t count = (uint32_t)(n / leaves + (j < n % leaves));
+         memcpy(leaf->keys, keys + done, count * sizeof(uint64_t));
+         if (values != NULL) memcpy(leaf->values, values + done, count * sizeof(uint64_t));
+         leaf->count = count;
+         level[j] = leaf;
+         low[j] = keys[done];
+         done += count;
+         prev = leaf;
+     }
+
+     size_t width = leaves;
+     uint32_t height = 0;
+     while (ok && width > 1) {
+         size_t parents = (width + BTREE_INNER_KEYS) / (BTREE_INNER_KEYS + 1);
+         size_t child = 0;
+         for (size_t p = 0; p < parents; p++) {
+             BTreeInner* in = (BTreeInner*)btree_alloc_node(sizeof(BTreeInner));
+             if (in == NULL) {
+                 ok = false;
+                 break;
+             }
+             nodes[num_nodes++] = in;
+             size_t fanout = width / parents + (p < width % parents);
+             uint64_t first_low = low[child];
+             for (size_t c = 0; c < fanout; c++, child++) {
+                 in->children[c] = level[child];
+                 if (c > 0) in->keys[c - 1] = low[child];
+             }
+             in->count = (uint32_t)(fanout - 1);
+             // child > p, so entries still to be read are not overwritten
+             level[p] = in;
+             low[p] = first_low;
+         }
+         width = parents;
+         height++;
+     }
+
+     if (ok) {
+         t->root = level[0];
+         t->height = height;
+         t->size = n;
+     } else {
+         for (size_t i = 0; i < num_nodes; i++) free(nodes[i]);
+         // Only the first leaf is left
+         ((BTreeLeaf*)t->root)->next = NULL;
+         btree_free(t);
+         t = NULL;
+     }
+     free(level);
+     free(low);
+     free(nodes);
+     return t;
+ }
+
+ /* ---- Lookup ---- */
+
+ static inline size_t btree_size(const BTree* t) {
+     return t->size;
+ }
+
+ /**
+  * @brief Inner levels above the leaves (0 if all keys fit in one leaf)
+  */
+ static inline uint32_t btree_height(const BTree* t) {
+     return t->height;
+ }
+
+ /**
+  * @brief Looks up @p key
+  *
+  * @param value Receives the value if found (may be NULL)
+  * @return bool Whether the key is present
+  */
+ static inline bool btree_get(const BTree* t, uint64_t key, uint64_t* value) {
+     const BTreeLeaf* leaf = btree_find_leaf(t, key);
+     uint32_t pos = btree_search(t, leaf->keys, leaf->count, key, false);
+     if (pos == leaf->count || leaf->keys[pos] != key) return false;
+     if (value != NULL) *value = leaf->values[pos];
+     return true;
+ }
+
+ static inline bool btree_contains(const BTree* t, uint64_t key) {
+     return btree_get(t, key, NULL);
+ }
+
+ static inline BTreeIter btree_iter_at(const BTreeLeaf* leaf, uint32_t pos) {
+     // A key past the end of its leaf is below every key of the next leaf
+     if (pos == leaf->count) {
+         leaf = leaf->next;
+         pos = 0;
+     }
+     BTreeIter it = { leaf, pos };
+     return it;
+ }
+
+ /**
+  * @brief Iterator to the smallest key
+  */
+ static inline BTreeIter btree_begin(const BTree* t) {
+     return btree_iter_at(t->first, 0);
+ }
+
+ /**
+  * @brief Iterator to the first key >= @p key
+  */
+ static inline BTreeIter btree_lower_bound(const BTree* t, uint64_t key) {
+     const BTreeLeaf* leaf = btree_find_leaf(t, key);
+     return btree_iter_at(leaf, btree_search(t, leaf->keys, leaf->count, key, false));
+ }
+
+ /**
+  * @brief Iterator to the first key > @p key
+  */
+ static inline BTreeIter btree_upper_bound(const BTree* t, uint64_t key) {
+     const BTreeLeaf* leaf = btree_find_leaf(t, key);
+     return btree_iter_at(leaf, btree_search(t, leaf->keys, leaf->count, key, true));
+ }
+
+ static inline bool btree_iter_valid(BTreeIter it) {
+     return it.leaf != NULL;
+ }
+
+ static inline uint64_t btree_iter_key(BTreeIter it) {
+     return it.leaf->keys[it.pos];
+ }
+
+ static inline uint64_t btree_iter_value(BTreeIter it) {
+     return it.leaf->values[it.pos];
+ }
+
+ static inline void btree_iter_next(BTreeIter* it) {
+     if (++it->pos == it->leaf->count) {
+         it->leaf = it->leaf->next;
+         it->pos = 0;
+     }
+ }
+
+ /**
+  * @brief Calls visit(key, value, ctx) for every key in [lo, hi], in
+  *        increasing order, until it returns false
+  *
+  * @return size_t Number of entries visited
+  */
+ static inline size_t btree_scan(const BTree* t, uint64_t lo, uint64_t hi,
+                                 bool (*visit)(uint64_t key, uint64_t value, void* ctx), void* ctx) {
+     if (lo > hi) return 0;
+     BTreeIter it = btree_lower_bound(t, lo);
+     size_t visited = 0;
+     for (const BTreeLeaf* leaf = it.leaf; leaf != NULL; leaf = leaf->next) {
+         for (uint32_t i = leaf == it.leaf ? it.pos : 0; i < leaf->count; i++) {
+             if (leaf->keys[i] > hi) return visited;
+             visited++;
+             if (!visit(leaf->keys[i], leaf->values[i], ctx)) return visited;
+         }
+     }
+     return visited;
+ }
+
+ /* ---- Insertion ---- */
+
+ static inline void btree_leaf_insert_at(BTreeLeaf* leaf, uint32_t pos, uint64_t key, uint64_t value) {
+     memmove(leaf->keys + pos + 1, leaf->keys + pos, (leaf->count - pos) * sizeof(uint64_t));
+     memmove(leaf->values + pos + 1, leaf->values + pos, (leaf->count - pos) * sizeof(uint64_t));
+     leaf->keys[pos] = key;
+     leaf->values[pos] = value;
+     leaf->count++;
+ }
+
+ // Inserts key at keys[pos] and its right child at children[pos + 1]
+ static inline void btree_inner_insert_at(BTreeInner* in, uint32_t pos, uint64_t key, void* child) {
+     memmove(in->keys + pos + 1, in->keys + pos, (in->count - pos) * sizeof(uint64_t));
+     memmove(in->children + pos + 2, in->children + pos + 1, (in->count - pos) * sizeof(void*));
+     in->keys[pos] = key;
+     in->children[pos + 1] = child;
+     in->count++;
+ }
+
+ /**
+  * @brief Inserts @p key, or replaces its value if present
+  *
+  * @return bool false on allocation failure (the tree is unchanged)
+  */
+ static inline bool btree_put(BTree* t, uint64_t key, uint64_t value) {
+     BTreeInner* path[BTREE_MAX_HEIGHT];
+     uint32_t slot[BTREE_MAX_HEIGHT];
+     void* node = t->root;
+     for (uint32_t d = 0; d < t->height; d++) {
+         BTreeInner* in = (BTreeInner*)node;
+         slot[d] = btree_search(t, in->keys, in->count, key, true);
+         path[d] = in;
+         node = in->children[slot[d]];
+     }
+     BTreeLeaf* leaf = (BTreeLeaf*)node;
+     uint32_t pos = btree_search(t, leaf->keys, leaf->count, key, false);
+     if (pos < leaf->count && leaf->keys[pos] == key) {
+         leaf->values[pos] = value;
+         return true;
+     }
+     if (leaf->count < BTREE_LEAF_KEYS) {
+         btree_leaf_insert_at(leaf, pos, key, value);
+         t->size++;
+         return true;
+     }
+
+     // Allocate every node the split needs before changing anything
+     uint32_t full = 0;
+     while (full < t->height && path[t->height - 1 - full]->count == BTREE_INNER_KEYS) full++;
+     bool new_root = full == t->height;
+     if (new_root && t->height == BTREE_MAX_HEIGHT) return false;
+     void* spare[BTREE_MAX_HEIGHT + 2];
+     uint32_t num_spare = 0;
+     BTreeLeaf* right = (BTreeLeaf*)btree_alloc_node(sizeof(BTreeLeaf));
+     bool ok = right != NULL;
+     for (uint32_t i = 0; ok && i < full + new_root; i++) {
+         spare[num_spare] = btree_alloc_node(sizeof(BTreeInner));
+         ok = spare[num_spare++] != NULL;
+     }
+     if (!ok) {
+         free(right);
+         for (uint32_t i = 0; i < num_spare; i++) free(spare[i]);
+         return false;
+     }
+
+     // Appending to the last leaf starts a new one; otherwise split in half
+     uint32_t split = pos == BTREE_LEAF_KEYS && leaf->next == NULL ? BTREE_LEAF_KEYS : BTREE_LEAF_KEYS / 2;
+     right->count = BTREE_LEAF_KEYS - split;
+     memcpy(right->keys, leaf->keys + split, right->count * sizeof(uint64_t));
+     memcpy(right->values, leaf->values + split, right->count * sizeof(uint64_t));
+     leaf->count = split;
+     right->next = leaf->next;
+     leaf->next = right;
+     if (pos < split) btree_leaf_insert_at(leaf, pos, key, value);
+     else btree_leaf_insert_at(right, pos - split, key, value);
+     t->size++;
+
+     // Insert (separator, new node) into the parents, splitting full ones
+     uint64_t separator = right->keys[0];
+     void* child = right;
+     for (uint32_t d = t->height; d-- > 0;) {
+         BTreeInner* in = path[d];
+         if (in->count < BTREE_INNER_KEYS) {
+             btree_inner_insert_at(in, slot[d], separator, child);
+             return true;
+         }
+         uint64_t keys[BTREE_INNER_KEYS + 1];
+         void* children[BTREE_INNER_KEYS + 2];
+         memcpy(keys, in->keys, slot[d] * sizeof(uint64_t));
+         keys[slot[d]] = separator;
+         memcpy(keys + slot[d] + 1, in->keys + slot[d], (BTREE_INNER_KEYS - slot[d]) * sizeof(uint64_t));
+         memcpy(children, in->children, (slot[d] + 1) * sizeof(void*));
+         children[slot[d] + 1] = child;
+         memcpy(children + slot[d] + 2, in->children + slot[d] + 1, (BTREE_INNER_KEYS - slot[d]) * sizeof(void*));
+
+         // keys[mid] moves up; each half keeps BTREE_INNER_KEYS / 2 keys
+         uint32_t mid = (BTREE_INNER_KEYS + 1) / 2;
+         BTreeInner* split_in = (BTreeInner*)spare[--num_spare];
+         memcpy(in->keys, keys, mid * sizeof(uint64_t));
+         memcpy(in->children, children, (mid + 1) * sizeof(void*));
+         in->count = mid;
+         split_in->count = BTREE_INNER_KEYS - mid;
+         memcpy(split_in->keys, keys + mid + 1, split_in->count * sizeof(uint64_t));
+         memcpy(split_in->children, children + mid + 1, (split_in->count + 1) * sizeof(void*));
+         separator = keys[mid];
+         child = split_in;
+     }
+
+     BTreeInner* root = (BTreeInner*)spare[--num_spare];
+     root->keys[0] = separator;
+     root->children[0] = t->root;
+     root->children[1] = child;
+     root->count = 1;
+     t->root = root;
+     t->height++;
+     return true;
+ }
+
+ /* ---- Removal ---- */
+
+ // Merges children[i + 1] of a parent into children[i] and drops separator i
+ static inline void btree_merge(BTreeInner* parent, uint32_t i, bool leaves) {
+     if (leaves) {
+         BTreeLeaf* left = (BTreeLeaf*)parent->children[i];
+         BTreeLeaf* right = (BTreeLeaf*)parent->children[i + 1];
+         memcpy(left->keys + left->count, right->keys, right->count * sizeof(uint64_t));
+         memcpy(left->values + left->count, right->values, right->count * sizeof(uint64_t));
+         left->count += right->count;
+         left->next = right->next;
+         free(right);
+     } else {
+         BTreeInner* left = (BTreeInner*)parent->children[i];
+         BTreeInner* right = (BTreeInner*)parent->children[i + 1];
+         left->keys[left->count] = parent->keys[i];
+         memcpy(left->keys + left->count + 1, right->keys, right->count * sizeof(uint64_t));
+         memcpy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(void*));
+         left->count += right->count + 1;
+         free(right);
+     }
+     memmove(parent->keys + i, parent->keys + i + 1, (parent->count - i - 1) * sizeof(uint64_t));
+     memmove(parent->children + i + 1, parent->children + i + 2, (parent->count - i - 1) * sizeof(void*));
+     parent->count--;
+ }
+
+ // Refills the leaf children[c] of a parent from a sibling, or merges it with one
+ static inline void btree_fix_leaf(BTreeInner* parent, uint32_t c) {
+     BTreeLeaf* leaf = (BTreeLeaf*)parent->children[c];
+     if (c > 0) {
+         BTreeLeaf* left = (BTreeLeaf*)parent->children[c - 1];
+         if (left->count > BTREE_LEAF_KEYS / 2) {
+             left->count--;
+             btree_leaf_insert_at(leaf, 0, left->keys[left->count], left->values[left->count]);
+             parent->keys[c - 1] = leaf->keys[0];
+             return;
+         }
+     }
+     if (c < parent->count) {
+         BTreeLeaf* right = (BTreeLeaf*)parent->children[c + 1];
+         if (right->count > BTREE_LEAF_KEYS / 2) {
+             leaf->keys[leaf->count] = right->keys[0];
+             leaf->values[leaf->count] = right->values[0];
+             leaf->count++;
+             right->count--;
+             memmove(right->keys, right->keys + 1, right->count * sizeof(uint64_t));
+             memmove(right->values, right->values + 1, right->count * sizeof(uint64_t));
+             parent->keys[c] = right->keys[0];
+             return;
+         }
+     }
+     btree_merge(parent, c > 0 ? c - 1 : c, true);
+ }
+
+ // The same for the inner node children[c], rotating keys through the parent
+ static inline void btree_fix_inner(BTreeInner* parent, uint32_t c) {
+     BTreeInner* in = (BTreeInner*)parent->children[c];
+     if (c > 0) {
+         BTreeInner* left = (BTreeInner*)parent->children[c - 1];
+         if (left->count > BTREE_INNER_KEYS / 2) {
+             memmove(in->keys + 1, in->keys, in->count * sizeof(uint64_t));
+             memmove(in->children + 1, in->children, (in->count + 1) * sizeof(void*));
+             in->keys[0] = parent->keys[c - 1];
+             in->children[0] = left->children[left->count];
+             in->count++;
+             parent->keys[c - 1] = left->keys[left->count - 1];
+             left->count--;
+             return;
+         }
+     }
+     if (c < parent->count) {
+         BTreeInner* right = (BTreeInner*)parent->children[c + 1];
+         if (right->count > BTREE_INNER_KEYS / 2) {
+             in->keys[in->count] = parent->keys[c];
+             in->children[in->count + 1] = right->children[0];
+             in->count++;
+             parent->keys[c] = right->keys[0];
+             memmove(right->keys, right->keys + 1, (right->count - 1) * sizeof(uint64_t));
+             memmove(right->children, right->children + 1, right->count * sizeof(void*));
+             right->count--;
+             return;
+         }
+     }
+     btree_merge(parent, c > 0 ? c - 1 : c, false);
+ }
+
+ /**
+  * @brief Removes @p key
+  *
+  * @param value Receives the removed value (may be NULL)
+  * @return bool Whether the key was present
+  */
+ static inline bool btree_remove(BTree* t, uint64_t key, uint64_t* value) {
+     BTreeInner* path[BTREE_MAX_HEIGHT];
+     uint32_t slot[BTREE_MAX_HEIGHT];
+     void* node = t->root;
+     for (uint32_t d = 0; d < t->height; d++) {
+         BTreeInner* in = (BTreeInner*)node;
+         slot[d] = btree_search(t, in->keys, in->count, key, true);
+         path[d] = in;
+         node = in->children[slot[d]];
+     }
+     BTreeLeaf* leaf = (BTreeLeaf*)node;
+     uint32_t pos = btree_search(t, leaf->keys, leaf->count, key, false);
+     if (pos == leaf->count || leaf->keys[pos] != key) return false;
+     if (value != NULL) *value = leaf->values[pos];
+     leaf->count--;
+     memmove(leaf->keys + pos, leaf->keys + pos + 1, (leaf->count - pos) * sizeof(uint64_t));
+     memmove(leaf->values + pos, leaf->values + pos + 1, (leaf->count - pos) * sizeof(uint64_t));
+     t->size--;
+
+     // Separators equal to the removed key still route correctly, so only
+     // underfull nodes need work, from the leaf upward
+     if (t->height == 0 || leaf->count >= BTREE_LEAF_KEYS / 2) return true;
+     uint32_t d = t->height - 1;
+     btree_fix_leaf(path[d], slot[d]);
+     while (d > 0 && path[d]->count < BTREE_INNER_KEYS / 2) {
+         d--;
+         btree_fix_inner(path[d], slot[d]);
+     }
+     if (d == 0 && path[0]->count == 0) {
+         t->root = path[0]->children[0];
+         t->height--;
+         free(path[0]);
+     }
+     return true;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // BTREE_H
@@ -0,0 +1,141 @@
+// bucket_queue.h
+#ifndef BUCKET_QUEUE_H
+#define BUCKET_QUEUE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Dial-style bucket queue for monotone keys with a small spread
+// Dial式桶队列，适用于单调且跨度较小的键
+//
+// All queued keys must lie in [current, current + span], where current is the
+// last popped key and span is fixed at creation (e.g. the largest edge weight
+// in Dijkstra, 1 for BFS). A circular array of span + 1 buckets is indexed by
+// key % (span + 1), so push is O(1) and pop is O(1) plus the number of empty
+// buckets skipped, at most span per pop.
+// 所有入队的键都必须位于 [current, current + span] 范围内，current为上次弹出
+// 的键，span在创建时确定（例如Dijkstra中的最大边权，BFS中为1）。span + 1个桶
+// 组成循环数组，以 key % (span + 1) 为下标，因此插入为O(1)，弹出为O(1)加上
+// 跳过的空桶数，每次最多span个。
+
+// Queue item: key and caller payload (队列元素：键与用户数据)
+typedef struct {
+    uint32_t key;
+    int value;
+} BucketQueueItem;
+
+typedef struct {
+    BucketQueueItem *items;
+    int count;
+    int capacity;
+} BucketQueueBucket;
+
+// Bucket queue structure
+// 桶队列结构
+typedef struct {
+    BucketQueueBucket *buckets;
+    uint32_t num_buckets;   // span + 1 (桶数)
+    uint32_t current;       // Last popped key, lower bound of all keys (上次弹出的键，所有键的下界)
+    int count;              // Current number of elements (当前元素数量)
+} BucketQueue;
+
+// Create an empty queue accepting keys up to `span` above the last popped key;
+// NULL on failure
+// 创建空队列，允许的键最多比上次弹出的键大span；失败返回NULL
+static inline BucketQueue* bq_create(uint32_t span) {
+    if (span >= UINT32_MAX) return NULL;
+    BucketQueue *q = (BucketQueue*)malloc(sizeof(BucketQueue));
+    if (!q) return NULL;
+    q->num_buckets = span + 1;
+    q->buckets = (BucketQueueBucket*)calloc(q->num_buckets, sizeof(BucketQueueBucket));
+    if (!q->buckets) {
+        free(q);
+        return NULL;
+    }
+    q->current = 0;
+    q->count = 0;
+    return q;
+}
+
+// Free the memory used by the queue
+// 释放队列使用的内存
+static inline void bq_free(BucketQueue *q) {
+    if (!q) return;
+    for (uint32_t i = 0; i < q->num_buckets; i++) free(q->buckets[i].items);
+    free(q->buckets);
+    free(q);
+}
+
+static inline bool bq_empty(const BucketQueue *q) {
+    return q->count == 0;
+}
+
+static inline int bq_size(const BucketQueue *q) {
+    return q->count;
+}
+
+// Insert a key/value pair in O(1). Returns false if the key is outside
+// [current, current + span] or allocation fails. An empty queue accepts any
+// key at least as large as the last popped one.
+// O(1)插入键值对。键超出 [current, current + span] 或分配失败时返回false。
+// 空队列接受任何不小于上次弹出键的键。
+static inline bool bq_push(BucketQueue *q, uint32_t key, int value) {
+    if (key < q->current) return false;
+    if (key - q->current >= q->num_buckets) {
+        if (q->count > 0) return false;
+        q->current = key;
+    }
+    BucketQueueBucket *b = &q->buckets[key % q->num_buckets];
+    if (b->count == b->capacity) {
+        int new_capacity = b->capacity == 0 ? 8 : b->capacity * 2;
+        BucketQueueItem *new_items = (BucketQueueItem*)realloc(b->items, (size_t)new_capacity * sizeof(BucketQueueItem));
+        if (!new_items) return false;
+        b->items = new_items;
+        b->capacity = new_capacity;
+    }
+    b->items[b->count].key = key;
+    b->items[b->count].value = value;
+    b->count++;
+    q->count++;
+    return true;
+}
+
+// Advance current to the smallest queued key (将current推进到最小的键)
+static inline BucketQueueBucket* bq_min_bucket(BucketQueue *q) {
+    uint32_t slot = q->current % q->num_buckets;
+    while (q->buckets[slot].count == 0) {
+        q->current++;
+        if (++slot == q->num_buckets) slot = 0;
+    }
+    return &q->buckets[slot];
+}
+
+// Peek at the minimum; false if empty (outputs may be NULL)
+// 查看最小元素；空队列返回false（输出参数可为NULL）
+static inline bool bq_top(BucketQueue *q, uint32_t *key, int *value) {
+    if (q->count == 0) return false;
+    BucketQueueBucket *b = bq_min_bucket(q);
+    if (key) *key = b->items[b->count - 1].key;
+    if (value) *value = b->items[b->count - 1].value;
+    return true;
+}
+
+// Remove the minimum; false if empty (outputs may be NULL)
+// 弹出最小元素；空队列返回false（输出参数可为NULL）
+static inline bool bq_pop(BucketQueue *q, uint32_t *key, int *value) {
+    if (!bq_top(q, key, value)) return false;
+    q->buckets[q->current % q->num_buckets].count--;
+    q->count--;
+    return true;
+}
+
+// Remove all elements and reset the key lower bound to 0, keeping memory
+// 清空队列并将键下界重置为0，保留已分配内存
+static inline void bq_clear(BucketQueue *q) {
+    for (uint32_t i = 0; i < q->num_buckets; i++) q->buckets[i].count = 0;
+    q->current = 0;
+    q->count = 0;
+}
+
+#endif // BUCKET_QUEUE_H
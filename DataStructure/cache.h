@@ -0,0 +1,600 @@
+/**
+ * @file cache.h
+ * @brief Bounded key/value cache with LRU or CLOCK eviction
+ *
+ * A chained hash table in the manner of hashmap.h (C string keys, void*
+ * values) whose entries also carry the links of a circular doubly linked
+ * list, so the recency order needs no second structure:
+ * - LRU: a hit moves the entry to the front and the entry at the back is
+ *   evicted
+ * - CLOCK: a hit only sets the entry's reference bit. The hand sits at the
+ *   front of the ring; a referenced entry there loses its bit and is passed
+ *   over, the first unreferenced one is evicted. New entries join just
+ *   behind the hand.
+ *
+ * Every entry has a charge: 1 to bound the number of entries, or its size in
+ * bytes to bound memory. A put evicts entries until the charges fit the
+ * capacity again. Entry and key are one allocation, made on insertion only;
+ * get, peek and remove never allocate.
+ *
+ * Every value the cache lets go of (evicted, replaced, removed, cleared) is
+ * passed to the eviction callback, which may free it. The callback must not
+ * call back into the cache.
+ *
+ * ShardedCache splits the keys over independent caches by hash, each behind
+ * its own pthread mutex, so threads working on different shards do not
+ * contend. Define CACHE_NO_THREADS to leave it out.
+ */
+
+ #ifndef CACHE_H
+ #define CACHE_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <string.h>
+
+ #ifndef CACHE_NO_THREADS
+ #include <pthread.h>
+ #endif
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Initial number of hash buckets (power of two)
+ #define CACHE_INITIAL_BUCKETS 16
+ /// Cache line size used to keep shards apart
+ #define CACHE_LINE 64
+
+ typedef enum {
+     CACHE_LRU,
+     CACHE_CLOCK
+ } CachePolicy;
+
+ /**
+  * @brief Receives every value the cache drops; ctx is the one given at creation
+  */
+ typedef void (*CacheEvict)(const char* key, void* value, void* ctx);
+
+ /**
+  * @brief Links of the recency list (LRU) or ring (CLOCK)
+  */
+ typedef struct CacheLink {
+     struct CacheLink* prev;
+     struct CacheLink* next;
+ } CacheLink;
+
+ typedef struct CacheEntry {
+     CacheLink link;                ///< First member, so a link is its entry
+     struct CacheEntry* chain;      ///< Next entry in the same bucket
+     void* value;
+     size_t charge;
+     uint32_t hash;
+     uint32_t key_len;
+     bool referenced;               ///< CLOCK reference bit
+     char key[];
+ } CacheEntry;
+
+ /**
+  * @brief Counters since creation or the last reset
+  */
+ typedef struct {
+     uint64_t hits;
+     uint64_t misses;
+     uint64_t insertions;
+     uint64_t evictions;            ///< Entries dropped to make room
+     size_t count;                  ///< Entries held now
+     size_t usage;                  ///< Sum of their charges
+ } CacheStats;
+
+ /**
+  * @brief Cache structure
+  */
+ typedef struct {
+     CacheEntry** buckets;
+     size_t num_buckets;            ///< Power of two
+     size_t count;
+     size_t usage;
+     size_t capacity;
+     CachePolicy policy;
+     CacheLink list;                ///< Sentinel; next is the most recent entry (LRU) or the hand (CLOCK)
+     CacheEvict on_evict;
+     void* ctx;
+     CacheStats stats;
+ } Cache;
+
+ /* ---- Hashing and lookup ---- */
+
+ // djb2, as in hashmap.h, with a final mix so the low bits index buckets and
+ // the high bits pick shards
+ static inline uint32_t cache_hash(const char* key, size_t* len) {
+     const unsigned char* p = (const unsigned char*)key;
+     uint32_t h = 5381;
+     while (*p) h = h * 33 + *p++;
+     *len = (size_t)(p - (const unsigned char*)key);
+     h ^= h >> 16;
+     h *= 0x85ebca6bu;
+     h ^= h >> 13;
+     h *= 0xc2b2ae35u;
+     h ^= h >> 16;
+     return h;
+ }
+
+ // Slot pointing at the entry for key, or at the NULL ending its bucket
+ static inline CacheEntry** cache_slot(const Cache* c, const char* key, size_t len, uint32_t hash) {
+     CacheEntry** slot = &c->buckets[hash & (c->num_buckets - 1)];
+     while (*slot != NULL) {
+         const CacheEntry* e = *slot;
+         if (e->hash == hash && e->key_len == len && memcmp(e->key, key, len) == 0) break;
+         slot = &(*slot)->chain;
+     }
+     return slot;
+ }
+
+ static inline void cache_link_remove(CacheLink* l) {
+     l->prev->next = l->next;
+     l->next->prev = l->prev;
+ }
+
+ static inline void cache_link_push_front(CacheLink* head, CacheLink* l) {
+     l->prev = head;
+     l->next = head->next;
+     head->next->prev = l;
+     head->next = l;
+ }
+
+ static inline void cache_link_push_back(CacheLink* head, CacheLink* l) {
+     l->next = head;
+     l->prev = head->prev;
+     head->prev->next = l;
+     head->prev = l;
+ }
+
+ // Records a use of e
+ static inline void cache_touch(Cache* c, CacheEntry* e) {
+     if (c->policy == CACHE_LRU) {
+         if (c->list.next != &e->link) {
+             cache_link_remove(&e->link);
+             cache_link_push_front(&c->list, &e->link);
+         }
+     } else if (!e->referenced) {
+         e->referenced = true;
+     }
+ }
+
+ /* ---- Creation ---- */
+
+ /**
+  * @brief Initializes a cache in place
+  *
+  * @param capacity Largest sum of charges kept
+  * @param on_evict Called with every dropped value (may be NULL)
+  * @return bool false on allocation failure
+  */
+ static inline bool cache_init(Cache* c, CachePolicy policy, size_t capacity, CacheEvict on_evict, void* ctx) {
+     c->buckets = (CacheEntry**)calloc(CACHE_INITIAL_BUCKETS, sizeof(CacheEntry*));
+     if (c->buckets == NULL) return false;
+     c->num_buckets = CACHE_INITIAL_BUCKETS;
+     c->count = 0;
+     c->usage = 0;
+     c->capacity = capacity;
+     c->policy = policy;
+     c->list.prev = c->list.next = &c->list;
+     c->on_evict = on_evict;
+     c->ctx = ctx;
+     memset(&c->stats, 0, sizeof(c->stats));
+     return true;
+ }
+
+ /**
+  * @brief Creates a cache; NULL on allocation failure
+  */
+ static inline Cache* cache_create(CachePolicy policy, size_t capacity, CacheEvict on_evict, void* ctx) {
+     Cache* c = (Cache*)malloc(sizeof(Cache));
+     if (c == NULL) return NULL;
+     if (!cache_init(c, policy, capacity, on_evict, ctx)) {
+         free(c);
+         return NULL;
+     }
+     return c;
+ }
+
+ /* ---- Removal and eviction ---- */
+
+ // Unlinks the entry at slot and hands its value to the callback
+ static inline void cache_drop(Cache* c, CacheEntry** slot) {
+     CacheEntry* e = *slot;
+     *slot = e->chain;
+     cache_link_remove(&e->link);
+     c->count--;
+     c->usage -= e->charge;
+     if (c->on_evict != NULL) c->on_evict(e->key, e->value, c->ctx);
+     free(e);
+ }
+
+ // Next entry to evict other than keep; the cache holds another entry
+ static inline CacheEntry* cache_victim(Cache* c, const CacheEntry* keep) {
+     if (c->policy == CACHE_LRU) {
+         CacheEntry* e = (CacheEntry*)c->list.prev;
+         return e != keep ? e : (CacheEntry*)e->link.prev;
+     }
+     for (;;) {
+         CacheEntry* e = (CacheEntry*)c->list.next;
+         if (e != keep && !e->referenced) return e;
+         // Advance the hand past e
+         e->referenced = false;
+         cache_link_remove(&e->link);
+         cache_link_push_back(&c->list, &e->link);
+     }
+ }
+
+ // Evicts entries other than keep until the charges fit the capacity
+ static inline void cache_trim(Cache* c, const CacheEntry* keep) {
+     while (c->usage > c->capacity && c->count > (keep != NULL ? 1u : 0u)) {
+         CacheEntry* e = cache_victim(c, keep);
+         c->stats.evictions++;
+         cache_drop(c, cache_slot(c, e->key, e->key_len, e->hash));
+     }
+ }
+
+ /**
+  * @brief Drops every entry; the counters are kept
+  */
+ static inline void cache_clear(Cache* c) {
+     while (c->count > 0) {
+         CacheEntry* e = (CacheEntry*)c->list.next;
+         cache_drop(c, cache_slot(c, e->key, e->key_len, e->hash));
+     }
+ }
+
+ /**
+  * @brief Drops every entry and releases a cache set up by cache_init
+  */
+ static inline void cache_destroy(Cache* c) {
+     cache_clear(c);
+     free(c->buckets);
+     c->buckets = NULL;
+ }
+
+ /**
+  * @brief Drops every entry and frees a cache from cache_create (NULL is allowed)
+  */
+ static inline void cache_free(Cache* c) {
+     if (c == NULL) return;
+     cache_destroy(c);
+     free(c);
+ }
+
+ /* ---- Operations on a known hash ---- */
+
+ static inline void* cache_get_hashed(Cache* c, const char* key, size_t len, uint32_t hash) {
+     CacheEntry* e = *cache_slot(c, key, len, hash);
+     if (e == NULL) {
+         c->stats.misses++;
+         return NULL;
+     }
+     c->stats.hits++;
+     cache_touch(c, e);
+     return e->value;
+ }
+
+ static inline void cache_grow(Cache* c) {
+     size_t n = c->num_buckets * 2;
+     CacheEntry** buckets = (CacheEntry**)calloc(n, sizeof(CacheEntry*));
+     // Without memory the chains just get longer
+     if (buckets == NULL) return;
+     for (size_t i = 0; i < c->num_buckets; i++) {
+         CacheEntry* e = c->buckets[i];
+         while (e != NULL) {
+             CacheEntry* next = e->chain;
+             e->chain = buckets[e->hash & (n - 1)];
+             buckets[e->hash & (n - 1)] = e;
+             e = next;
+         }
+     }
+     free(c->buckets);
+     c->buckets = buckets;
+     c->num_buckets = n;
+ }
+
+ static inline bool cache_put_hashed(Cache* c, const char* key, size_t len, uint32_t hash, void* value, size_t charge) {
+     CacheEntry** slot = cache_slot(c, key, len, hash);
+     if (charge > c->capacity) {
+         // Never fits: the old value goes, the new one is evicted at once
+         bool cached = *slot != NULL && (*slot)->value == value;
+         if (*slot != NULL) cache_drop(c, slot);
+         c->stats.evictions++;
+         if (!cached && c->on_evict != NULL) c->on_evict(key, value, c->ctx);
+         return true;
+     }
+     CacheEntry* e = *slot;
+     if (e != NULL) {
+         void* old = e->value;
+         e->value = value;
+         c->usage = c->usage - e->charge + charge;
+         e->charge = charge;
+         cache_touch(c, e);
+         if (old != value && c->on_evict != NULL) c->on_evict(e->key, old, c->ctx);
+         cache_trim(c, e);
+         return true;
+     }
+     if (len > UINT32_MAX) return false;
+     e = (CacheEntry*)malloc(sizeof(CacheEntry) + len + 1);
+     if (e == NULL) return false;
+     memcpy(e->key, key, len + 1);
+     e->key_len = (uint32_t)len;
+     e->hash = hash;
+     e->value = value;
+     e->charge = charge;
+     e->referenced = false;
+     e->chain = NULL;
+     *slot = e;
+     if (c->policy == CACHE_LRU) {
+         cache_link_push_front(&c->list, &e->link);
+     } else {
+         cache_link_push_back(&c->list, &e->link);
+     }
+     c->count++;
+     c->usage += charge;
+     c->stats.insertions++;
+     cache_trim(c, e);
+     if (c->count > c->num_buckets / 4 * 3) cache_grow(c);
+     return true;
+ }
+
+ static inline bool cache_remove_hashed(Cache* c, const char* key, size_t len, uint32_t hash) {
+     CacheEntry** slot = cache_slot(c, key, len, hash);
+     if (*slot == NULL) return false;
+     cache_drop(c, slot);
+     return true;
+ }
+
+ /* ---- Public operations ---- */
+
+ /**
+  * @brief Value cached under @p key, or NULL on a miss; counts as a use
+  */
+ static inline void* cache_get(Cache* c, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     return cache_get_hashed(c, key, len, hash);
+ }
+
+ /**
+  * @brief Value cached under @p key, or NULL; neither a use nor counted
+  */
+ static inline void* cache_peek(const Cache* c, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     const CacheEntry* e = *cache_slot(c, key, len, hash);
+     return e != NULL ? e->value : NULL;
+ }
+
+ /**
+  * @brief Whether @p key is cached; neither a use nor counted
+  */
+ static inline bool cache_contains(const Cache* c, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     return *cache_slot(c, key, len, hash) != NULL;
+ }
+
+ /**
+  * @brief Caches @p value under @p key (copied), replacing an older value,
+  *        and evicts entries until the charges fit the capacity
+  *
+  * A charge above the capacity never fits: the value goes straight to the
+  * eviction callback.
+  *
+  * @return bool false on allocation failure (the cache is unchanged)
+  */
+ static inline bool cache_put(Cache* c, const char* key, void* value, size_t charge) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     return cache_put_hashed(c, key, len, hash, value, charge);
+ }
+
+ /**
+  * @brief Drops @p key, passing its value to the eviction callback
+  *
+  * @return bool false if the key was not cached
+  */
+ static inline bool cache_remove(Cache* c, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     return cache_remove_hashed(c, key, len, hash);
+ }
+
+ /**
+  * @brief Changes the capacity, evicting entries if it shrinks
+  */
+ static inline void cache_set_capacity(Cache* c, size_t capacity) {
+     c->capacity = capacity;
+     cache_trim(c, NULL);
+ }
+
+ static inline size_t cache_size(const Cache* c) {
+     return c->count;
+ }
+
+ static inline size_t cache_usage(const Cache* c) {
+     return c->usage;
+ }
+
+ static inline CacheStats cache_stats(const Cache* c) {
+     CacheStats s = c->stats;
+     s.count = c->count;
+     s.usage = c->usage;
+     return s;
+ }
+
+ static inline void cache_reset_stats(Cache* c) {
+     memset(&c->stats, 0, sizeof(c->stats));
+ }
+
+ #ifndef CACHE_NO_THREADS
+
+ /* ---- Sharded, thread-safe cache ---- */
+
+ /**
+  * @brief Called under the shard lock with each value get or peek returns
+  *
+  * A value handed out may be evicted, and freed by the eviction callback,
+  * while another thread still uses it. Reference-counted values stay safe if
+  * retain takes a reference and the eviction callback drops one.
+  */
+ typedef void (*CacheRetain)(void* value, void* ctx);
+
+ typedef struct {
+     _Alignas(CACHE_LINE) pthread_mutex_t lock;
+     Cache cache;
+ } CacheShard;
+
+ typedef struct {
+     CacheShard* shards;
+     size_t num_shards;             ///< Power of two
+     unsigned shard_shift;          ///< The top bits of a hash pick the shard
+     CacheRetain retain;
+     void* ctx;
+ } ShardedCache;
+
+ /**
+  * @brief Creates a cache of @p num_shards shards (rounded up to a power of
+  *        two) that share @p capacity evenly
+  *
+  * @param retain Called with every value returned (may be NULL)
+  * @return ShardedCache* NULL on allocation failure
+  */
+ static inline ShardedCache* sharded_cache_create(size_t num_shards, CachePolicy policy, size_t capacity,
+                                                  CacheEvict on_evict, CacheRetain retain, void* ctx) {
+     unsigned bits = 0;
+     while (((size_t)1 << bits) < num_shards && bits < 16) bits++;
+     size_t n = (size_t)1 << bits;
+     ShardedCache* sc = (ShardedCache*)malloc(sizeof(ShardedCache));
+     if (sc == NULL) return NULL;
+     sc->shards = (CacheShard*)aligned_alloc(CACHE_LINE, n * sizeof(CacheShard));
+     if (sc->shards == NULL) {
+         free(sc);
+         return NULL;
+     }
+     for (size_t i = 0; i < n; i++) {
+         if (!cache_init(&sc->shards[i].cache, policy, (capacity + n - 1) / n, on_evict, ctx)) {
+             while (i-- > 0) {
+                 cache_destroy(&sc->shards[i].cache);
+                 pthread_mutex_destroy(&sc->shards[i].lock);
+             }
+             free(sc->shards);
+             free(sc);
+             return NULL;
+         }
+         pthread_mutex_init(&sc->shards[i].lock, NULL);
+     }
+     sc->num_shards = n;
+     sc->shard_shift = 32 - bits;
+     sc->retain = retain;
+     sc->ctx = ctx;
+     return sc;
+ }
+
+ /**
+  * @brief Drops every entry and frees the cache (NULL is allowed); no other
+  *        thread may be using it
+  */
+ static inline void sharded_cache_free(ShardedCache* sc) {
+     if (sc == NULL) return;
+     for (size_t i = 0; i < sc->num_shards; i++) {
+         cache_destroy(&sc->shards[i].cache);
+         pthread_mutex_destroy(&sc->shards[i].lock);
+     }
+     free(sc->shards);
+     free(sc);
+ }
+
+ static inline CacheShard* sharded_cache_shard(const ShardedCache* sc, uint32_t hash) {
+     // A shift by 32 is undefined, so one shard is a special case
+     return &sc->shards[sc->num_shards > 1 ? hash >> sc->shard_shift : 0];
+ }
+
+ /**
+  * @brief cache_get on the key's shard
+  */
+ static inline void* sharded_cache_get(ShardedCache* sc, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     CacheShard* s = sharded_cache_shard(sc, hash);
+     pthread_mutex_lock(&s->lock);
+     void* value = cache_get_hashed(&s->cache, key, len, hash);
+     if (value != NULL && sc->retain != NULL) sc->retain(value, sc->ctx);
+     pthread_mutex_unlock(&s->lock);
+     return value;
+ }
+
+ /**
+  * @brief cache_peek on the key's shard
+  */
+ static inline void* sharded_cache_peek(ShardedCache* sc, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     CacheShard* s = sharded_cache_shard(sc, hash);
+     pthread_mutex_lock(&s->lock);
+     const CacheEntry* e = *cache_slot(&s->cache, key, len, hash);
+     void* value = e != NULL ? e->value : NULL;
+     if (value != NULL && sc->retain != NULL) sc->retain(value, sc->ctx);
+     pthread_mutex_unlock(&s->lock);
+     return value;
+ }
+
+ /**
+  * @brief cache_put on the key's shard; the capacity applies per shard
+  */
+ static inline bool sharded_cache_put(ShardedCache* sc, const char* key, void* value, size_t charge) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     CacheShard* s = sharded_cache_shard(sc, hash);
+     pthread_mutex_lock(&s->lock);
+     bool ok = cache_put_hashed(&s->cache, key, len, hash, value, charge);
+     pthread_mutex_unlock(&s->lock);
+     return ok;
+ }
+
+ /**
+  * @brief cache_remove on the key's shard
+  */
+ static inline bool sharded_cache_remove(ShardedCache* sc, const char* key) {
+     size_t len;
+     uint32_t hash = cache_hash(key, &len);
+     CacheShard* s = sharded_cache_shard(sc, hash);
+     pthread_mutex_lock(&s->lock);
+     bool removed = cache_remove_hashed(&s->cache, key, len, hash);
+     pthread_mutex_unlock(&s->lock);
+     return removed;
+ }
+
+ /**
+  * @brief Counters summed over the shards
+  */
+ static inline CacheStats sharded_cache_stats(ShardedCache* sc) {
+     CacheStats total;
+     memset(&total, 0, sizeof(total));
+     for (size_t i = 0; i < sc->num_shards; i++) {
+         pthread_mutex_lock(&sc->shards[i].lock);
+         CacheStats s = cache_stats(&sc->shards[i].cache);
+         pthread_mutex_unlock(&sc->shards[i].lock);
+         total.hits += s.hits;
+         total.misses += s.misses;
+         total.insertions += s.insertions;
+         total.evictions += s.evictions;
+         total.count += s.count;
+         total.usage += s.usage;
+     }
+     return total;
+ }
+
+ #endif // CACHE_NO_THREADS
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // CACHE_H
@@ -0,0 +1,369 @@
+/**
+ * @file concurrent_stack.h
+ * @brief A lock-free LIFO stack (Treiber stack) for sharing work across threads
+ *
+ * The stack keeps the StackNode design of stack.h (a data pointer plus a link
+ * to the next node) but allocates every node up front in a fixed pool and
+ * links nodes by index. The top of the stack is a single 64-bit word holding
+ * a 32-bit node index and a 32-bit modification tag; every successful CAS
+ * bumps the tag, which defeats the ABA problem without double-width CAS or
+ * hazard pointers. Because pool memory is never returned to the allocator
+ * while the stack exists, a thread may safely read a node that another thread
+ * has just popped.
+ *
+ * Free nodes are kept on a second Treiber list. Threads may attach a
+ * ConcurrentStackCache to keep a private batch of free nodes so that
+ * push/pop touch the shared free list only once per batch. Under contention
+ * a failed CAS falls back to an elimination array where a concurrent push
+ * and pop can exchange an element without touching the top at all.
+ *
+ * Requires C11 <stdatomic.h>.
+ */
+
+ #ifndef CONCURRENT_STACK_H
+ #define CONCURRENT_STACK_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <stdatomic.h>
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Number of slots in the elimination array (power of two)
+ #define CONCURRENT_STACK_ELIMINATION_SLOTS 16
+ /// Spins a pusher waits in the elimination array for a matching pop
+ #define CONCURRENT_STACK_ELIMINATION_SPINS 64
+ /// Capacity of a per-thread node cache
+ #define CONCURRENT_STACK_CACHE_SIZE 64
+ /// Cache line size used to keep hot words apart
+ #define CONCURRENT_STACK_CACHE_LINE 64
+
+ /* Internal encoding of a list head: high 32 bits = tag, low 32 bits = index + 1 (0 = empty) */
+ #define CS_WORD(tag, ref) (((uint64_t)(tag) << 32) | (uint64_t)(ref))
+ #define CS_REF(word)      ((uint32_t)(word))
+ #define CS_TAG(word)      ((uint32_t)((word) >> 32))
+ #define CS_ELIM_TAKEN     UINT64_MAX
+
+ /**
+  * @brief Pool node
+  *
+  * Mirrors StackNode; @c next holds the index + 1 of the next node (0 = none)
+  * and is atomic because poppers may read it while another thread relinks it.
+  */
+ typedef struct {
+     void* data;                  ///< Generic data pointer
+     _Atomic uint32_t next;       ///< Reference to the next node
+ } ConcurrentStackNode;
+
+ /**
+  * @brief Lock-free stack structure
+  */
+ typedef struct {
+     _Atomic uint64_t top;        ///< Tagged reference to the top node
+     char pad0[CONCURRENT_STACK_CACHE_LINE - sizeof(uint64_t)];
+     _Atomic uint64_t free_top;   ///< Tagged reference to the first free node
+     char pad1[CONCURRENT_STACK_CACHE_LINE - sizeof(uint64_t)];
+     _Atomic uint64_t elimination[CONCURRENT_STACK_ELIMINATION_SLOTS]; ///< 0, an offered node ref, or CS_ELIM_TAKEN
+     ConcurrentStackNode* nodes;  ///< Node pool
+     uint32_t capacity;           ///< Number of nodes in the pool
+ } ConcurrentStack;
+
+ /**
+  * @brief Per-thread cache of free nodes
+  *
+  * A cache must be used by one thread at a time. Call
+  * concurrent_stack_cache_flush() before the owning thread exits so that its
+  * nodes become available to other threads again.
+  */
+ typedef struct {
+     ConcurrentStack* stack;      ///< Stack the cached nodes belong to
+     uint32_t count;              ///< Number of cached node references
+     uint32_t seed;               ///< Random state for elimination slot choice
+     uint32_t refs[CONCURRENT_STACK_CACHE_SIZE]; ///< Cached node references
+ } ConcurrentStackCache;
+
+ /* ====================== Internal Helpers ====================== */
+
+ static inline ConcurrentStackNode* cs_node(ConcurrentStack* s, uint32_t ref) {
+     return &s->nodes[ref - 1];
+ }
+
+ static inline void cs_cpu_relax(void) {
+ #if defined(__x86_64__) || defined(__i386__)
+     __asm__ __volatile__("pause");
+ #elif defined(__aarch64__)
+     __asm__ __volatile__("yield");
+ #endif
+ }
+
+ static inline uint32_t cs_next_random(uint32_t* seed) {
+     uint32_t x = *seed;
+     x ^= x << 13;
+     x ^= x >> 17;
+     x ^= x << 5;
+     *seed = x ? x : 0x9E3779B9u;
+     return x;
+ }
+
+ /**
+  * @brief Internal: links the chain first..last in front of a list head
+  */
+ static inline void cs_list_push_chain(ConcurrentStack* s, _Atomic uint64_t* head,
+                                       uint32_t first, uint32_t last) {
+     uint64_t old = atomic_load_explicit(head, memory_order_relaxed);
+     for (;;) {
+         atomic_store_explicit(&cs_node(s, last)->next, CS_REF(old), memory_order_relaxed);
+         if (atomic_compare_exchange_weak_explicit(head, &old, CS_WORD(CS_TAG(old) + 1, first),
+                                                   memory_order_release, memory_order_relaxed)) {
+             return;
+         }
+     }
+ }
+
+ /**
+  * @brief Internal: one CAS attempt to unlink the first node of a list
+  *
+  * @return 1 on success, 0 if the list is empty, -1 if the CAS lost a race
+  */
+ static inline int cs_list_try_pop(ConcurrentStack* s, _Atomic uint64_t* head, uint32_t* ref) {
+     uint64_t old = atomic_load_explicit(head, memory_order_acquire);
+     if (CS_REF(old) == 0) return 0;
+     uint32_t next = atomic_load_explicit(&cs_node(s, CS_REF(old))->next, memory_order_relaxed);
+     if (atomic_compare_exchange_strong_explicit(head, &old, CS_WORD(CS_TAG(old) + 1, next),
+                                                 memory_order_acquire, memory_order_relaxed)) {
+         *ref = CS_REF(old);
+         return 1;
+     }
+     return -1;
+ }
+
+ static inline bool cs_list_pop(ConcurrentStack* s, _Atomic uint64_t* head, uint32_t* ref) {
+     int r;
+     while ((r = cs_list_try_pop(s, head, ref)) < 0) {
+         cs_cpu_relax();
+     }
+     return r == 1;
+ }
+
+ /**
+  * @brief Internal: obtains a free node, preferring the thread cache
+  */
+ static inline bool cs_acquire_node(ConcurrentStack* s, ConcurrentStackCache* cache, uint32_t* ref) {
+     if (cache == NULL) return cs_list_pop(s, &s->free_top, ref);
+     if (cache->count == 0) {
+         // Refill half of the cache from the shared free list
+         while (cache->count < CONCURRENT_STACK_CACHE_SIZE / 2 &&
+                cs_list_pop(s, &s->free_top, &cache->refs[cache->count])) {
+             cache->count++;
+         }
+         if (cache->count == 0) return false;
+     }
+     *ref = cache->refs[--cache->count];
+     return true;
+ }
+
+ /**
+  * @brief Internal: returns a node to the thread cache or the shared free list
+  */
+ static inline void cs_release_node(ConcurrentStack* s, ConcurrentStackCache* cache, uint32_t ref) {
+     if (cache == NULL) {
+         cs_list_push_chain(s, &s->free_top, ref, ref);
+         return;
+     }
+     if (cache->count == CONCURRENT_STACK_CACHE_SIZE) {
+         // Spill half of the cache with a single CAS
+         uint32_t half = CONCURRENT_STACK_CACHE_SIZE / 2;
+         uint32_t* batch = &cache->refs[cache->count - half];
+         for (uint32_t i = 0; i + 1 < half; i++) {
+             atomic_store_explicit(&cs_node(s, batch[i])->next, batch[i + 1], memory_order_relaxed);
+         }
+         cs_list_push_chain(s, &s->free_top, batch[0], batch[half - 1]);
+         cache->count -= half;
+     }
+     cache->refs[cache->count++] = ref;
+ }
+
+ /* ====================== Basic Operations ====================== */
+
+ /**
+  * @brief Creates a new empty lock-free stack
+  *
+  * @param capacity Maximum number of elements the stack can hold (1 .. 2^32 - 2)
+  * @return ConcurrentStack* Pointer to the stack, or NULL on failure
+  * @note The caller must call concurrent_stack_free() to release memory
+  */
+ static inline ConcurrentStack* concurrent_stack_create(uint32_t capacity) {
+     if (capacity == 0 || capacity == UINT32_MAX) return NULL;
+
+     ConcurrentStack* s = (ConcurrentStack*)malloc(sizeof(ConcurrentStack));
+     if (s == NULL) return NULL;
+     s->nodes = (ConcurrentStackNode*)malloc((size_t)capacity * sizeof(ConcurrentStackNode));
+     if (s->nodes == NULL) {
+         free(s);
+         return NULL;
+     }
+     s->capacity = capacity;
+
+     // Thread every node onto the free list: node i links to node i + 1
+     for (uint32_t i = 0; i < capacity; i++) {
+         s->nodes[i].data = NULL;
+         atomic_init(&s->nodes[i].next, i + 1 < capacity ? i + 2 : 0);
+     }
+     atomic_init(&s->top, CS_WORD(0, 0));
+     atomic_init(&s->free_top, CS_WORD(0, 1));
+     for (int i = 0; i < CONCURRENT_STACK_ELIMINATION_SLOTS; i++) {
+         atomic_init(&s->elimination[i], 0);
+     }
+     return s;
+ }
+
+ /**
+  * @brief Frees the stack and its node pool (not the data pointers)
+  *
+  * @param s Pointer to the stack (may be NULL)
+  * @warning No other thread may use the stack or any of its caches afterwards
+  */
+ static inline void concurrent_stack_free(ConcurrentStack* s) {
+     if (s == NULL) return;
+     free(s->nodes);
+     free(s);
+ }
+
+ /**
+  * @brief Initializes a per-thread node cache for a stack
+  *
+  * @param cache Cache to initialize
+  * @param s Stack whose nodes the cache will hold
+  * @param seed Any value distinct per thread (used to spread elimination)
+  */
+ static inline void concurrent_stack_cache_init(ConcurrentStackCache* cache, ConcurrentStack* s, uint32_t seed) {
+     cache->stack = s;
+     cache->count = 0;
+     cache->seed = seed * 2654435761u + 1u;
+ }
+
+ /**
+  * @brief Returns every cached node to the shared free list
+  *
+  * @param cache Cache to flush
+  */
+ static inline void concurrent_stack_cache_flush(ConcurrentStackCache* cache) {
+     ConcurrentStack* s = cache->stack;
+     if (cache->count == 0) return;
+     for (uint32_t i = 0; i + 1 < cache->count; i++) {
+         atomic_store_explicit(&cs_node(s, cache->refs[i])->next, cache->refs[i + 1], memory_order_relaxed);
+     }
+     cs_list_push_chain(s, &s->free_top, cache->refs[0], cache->refs[cache->count - 1]);
+     cache->count = 0;
+ }
+
+ /**
+  * @brief Pushes a data pointer onto the stack
+  *
+  * @param s Pointer to the stack
+  * @param cache Calling thread's node cache, or NULL to use the shared free list
+  * @param item Pointer to push (the stack only stores the pointer)
+  * @return true on success, false if all @c capacity nodes are in use
+  */
+ static inline bool concurrent_stack_push(ConcurrentStack* s, ConcurrentStackCache* cache, void* item) {
+     uint32_t ref;
+     if (!cs_acquire_node(s, cache, &ref)) return false;
+     ConcurrentStackNode* node = cs_node(s, ref);
+     node->data = item;
+
+     uint64_t old = atomic_load_explicit(&s->top, memory_order_relaxed);
+     for (;;) {
+         atomic_store_explicit(&node->next, CS_REF(old), memory_order_relaxed);
+         if (atomic_compare_exchange_strong_explicit(&s->top, &old, CS_WORD(CS_TAG(old) + 1, ref),
+                                                     memory_order_release, memory_order_relaxed)) {
+             return true;
+         }
+
+         // Contended: offer the node to a concurrent pop through the elimination array
+         uint32_t seed_fallback = ref;
+         uint32_t slot = cs_next_random(cache ? &cache->seed : &seed_fallback)
+                         & (CONCURRENT_STACK_ELIMINATION_SLOTS - 1);
+         _Atomic uint64_t* cell = &s->elimination[slot];
+         uint64_t expected = 0;
+         if (atomic_compare_exchange_strong_explicit(cell, &expected, (uint64_t)ref,
+                                                     memory_order_release, memory_order_relaxed)) {
+             for (int spin = 0; spin < CONCURRENT_STACK_ELIMINATION_SPINS; spin++) {
+                 if (atomic_load_explicit(cell, memory_order_relaxed) != ref) break;
+                 cs_cpu_relax();
+             }
+             expected = ref;
+             if (!atomic_compare_exchange_strong_explicit(cell, &expected, 0,
+                                                          memory_order_relaxed, memory_order_relaxed)) {
+                 // A pop took the node; we own the cell until we reset it
+                 atomic_store_explicit(cell, 0, memory_order_release);
+                 return true;
+             }
+         }
+         old = atomic_load_explicit(&s->top, memory_order_relaxed);
+     }
+ }
+
+ /**
+  * @brief Pops the top data pointer
+  *
+  * @param s Pointer to the stack
+  * @param cache Calling thread's node cache, or NULL to use the shared free list
+  * @param out Receives the popped pointer
+  * @return true on success, false if the stack was observed empty
+  */
+ static inline bool concurrent_stack_pop(ConcurrentStack* s, ConcurrentStackCache* cache, void** out) {
+     uint32_t seed_fallback = (uint32_t)(uintptr_t)out;
+     for (;;) {
+         uint32_t ref;
+         int r = cs_list_try_pop(s, &s->top, &ref);
+         if (r == 0) return false;
+         if (r < 0) {
+             // Contended: try to take an offered node from the elimination array
+             uint32_t slot = cs_next_random(cache ? &cache->seed : &seed_fallback)
+                             & (CONCURRENT_STACK_ELIMINATION_SLOTS - 1);
+             _Atomic uint64_t* cell = &s->elimination[slot];
+             uint64_t offer = atomic_load_explicit(cell, memory_order_relaxed);
+             if (offer == 0 || offer == CS_ELIM_TAKEN ||
+                 !atomic_compare_exchange_strong_explicit(cell, &offer, CS_ELIM_TAKEN,
+                                                          memory_order_acquire, memory_order_relaxed)) {
+                 continue;
+             }
+             ref = (uint32_t)offer;
+         }
+         *out = cs_node(s, ref)->data;
+         cs_release_node(s, cache, ref);
+         return true;
+     }
+ }
+
+ /* ====================== Accessors ====================== */
+
+ /**
+  * @brief Checks if the stack is empty
+  *
+  * @param s Pointer to the stack
+  * @return true if the stack was empty at the moment of the check
+  * @note The result may be stale as soon as it is returned
+  */
+ static inline bool concurrent_stack_isEmpty(ConcurrentStack* s) {
+     return CS_REF(atomic_load_explicit(&s->top, memory_order_acquire)) == 0;
+ }
+
+ /**
+  * @brief Returns the node capacity of the stack
+  *
+  * @param s Pointer to the stack
+  * @return uint32_t Maximum number of elements
+  */
+ static inline uint32_t concurrent_stack_capacity(const ConcurrentStack* s) {
+     return s->capacity;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // CONCURRENT_STACK_H
@@ -0,0 +1,992 @@
+/**
+ * @file graph.h
+ * @brief Compressed sparse row (CSR) graphs with a parallel builder and
+ *        direction-optimizing breadth-first search
+ *
+ * A graph with n vertices and m arcs is stored as two arrays: offsets[0..n]
+ * and neighbors[0..m), where the out-neighbors of v are
+ * neighbors[offsets[v] .. offsets[v + 1]). Scanning a vertex touches exactly
+ * its own neighbors in one contiguous block, instead of a row of n entries
+ * as in an adjacency matrix, so graphs with 10^7 vertices and 10^8 arcs fit
+ * in about 8 bytes per vertex and 4 bytes per arc.
+ *
+ * graph_create() builds the CSR form from an edge list in three passes,
+ * each split into tasks on a TaskScheduler: count the arcs per bucket of
+ * consecutive vertices, append the arcs to their buckets, then lay out each
+ * bucket's offsets and neighbors. No pass needs atomics, and every neighbor
+ * list keeps the order of the input edges. Directed graphs also get the
+ * reverse (in-arc) CSR, which bottom-up BFS needs; undirected graphs share
+ * one CSR for both.
+ *
+ * WeightedGraph is the same CSR with a weight stored next to each target,
+ * for the shortest-path algorithms in shortest_path.h.
+ *
+ * graph_bfs() follows Beamer, Asanovic and Patterson (SC 2012):
+ * - top-down steps expand a frontier queue, checking each out-arc against a
+ *   visited bitset
+ * - when the arcs leaving the frontier exceed 1/GRAPH_BFS_ALPHA of the arcs
+ *   of unvisited vertices, it switches to bottom-up steps: every unvisited
+ *   vertex scans its in-arcs and stops at the first parent found in the
+ *   frontier bitset, which skips most arcs of the few huge middle levels of
+ *   small-world graphs
+ * - when the frontier shrinks below n/GRAPH_BFS_BETA vertices it switches
+ *   back to top-down
+ *
+ * graph_bfs_parallel() runs the same search level-synchronously on a
+ * TaskScheduler. Top-down tasks claim vertices with an atomic fetch-or on
+ * the visited bitset and collect them in small local frontiers, which are
+ * appended to the next frontier a block at a time. Bottom-up tasks own
+ * whole bitset words and need no atomics.
+ *
+ * graph_connected_components() labels the (weakly) connected components
+ * with Afforest (Sutton, Ben-Nun and Barak, IPDPS 2018): union-find with
+ * lock-free linking and path compression, first over a couple of sampled
+ * neighbors per vertex, then over the remaining arcs of every vertex outside
+ * the largest component found so far, which skips most of the arcs.
+ *
+ * Requires C11 <stdatomic.h> and POSIX threads (through task_scheduler.h).
+ */
+
+ #ifndef GRAPH_H
+ #define GRAPH_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <string.h>
+ #include <stdatomic.h>
+
+ #include "task_scheduler.h"
+ #include "bitset.h"
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Marks "no vertex" in parent arrays
+ #define GRAPH_NO_VERTEX UINT32_MAX
+ /// Minimum edges per task in the parallel build
+ #define GRAPH_BUILD_GRAIN 65536
+ /// Target arcs per vertex bucket in the build (their neighbors stay in cache)
+ #define GRAPH_BUILD_BUCKET_ARCS 65536
+ /// Top-down to bottom-up switch: frontier arcs > unexplored arcs / ALPHA
+ #define GRAPH_BFS_ALPHA 15
+ /// Bottom-up to top-down switch: frontier vertices < n / BETA
+ #define GRAPH_BFS_BETA 18
+ /// Frontier vertices per task in top-down steps of the parallel BFS
+ #define GRAPH_PAR_FRONTIER_GRAIN 1024
+ /// Bitset words (64 vertices each) per task in the parallel kernels
+ #define GRAPH_PAR_WORD_GRAIN 256
+ /// Vertices a task collects before appending them to the next frontier
+ #define GRAPH_PAR_LOCAL_FRONTIER 256
+ /// Afforest: sampled neighbors per vertex before the largest component is skipped
+ #define GRAPH_CC_NEIGHBOR_ROUNDS 2
+ /// Afforest: vertices sampled to find the largest component
+ #define GRAPH_CC_SAMPLES 1024
+
+ /**
+  * @brief One input edge (an arc from src to dst if the graph is directed)
+  */
+ typedef struct {
+     uint32_t src;
+     uint32_t dst;
+ } GraphEdge;
+
+ /**
+  * @brief One input edge with a weight (WeightedGraph)
+  */
+ typedef struct {
+     uint32_t src;
+     uint32_t dst;
+     uint32_t weight;
+ } WeightedEdge;
+
+ /**
+  * @brief Arc of a WeightedGraph: target and weight side by side, so
+  *        relaxing an arc reads one cache line
+  */
+ typedef struct {
+     uint32_t target;
+     uint32_t weight;
+ } WeightedArc;
+
+ /**
+  * @brief Graph in CSR form
+  */
+ typedef struct {
+     uint32_t num_vertices;    ///< Vertices are 0 .. num_vertices - 1
+     uint64_t num_arcs;        ///< Stored arcs; an undirected edge is two arcs
+     bool undirected;          ///< Whether in-arcs alias out-arcs
+     uint64_t* out_offsets;    ///< num_vertices + 1 entries
+     uint32_t* out_neighbors;  ///< num_arcs entries
+     uint64_t* in_offsets;     ///< Reverse CSR (same arrays when undirected)
+     uint32_t* in_neighbors;
+ } Graph;
+
+ /**
+  * @brief Weighted graph in CSR form (out-arcs only)
+  */
+ typedef struct {
+     uint32_t num_vertices;
+     uint64_t num_arcs;        ///< An undirected edge is two arcs
+     uint64_t* offsets;        ///< num_vertices + 1 entries
+     WeightedArc* arcs;        ///< Out-arcs of v: arcs[offsets[v] .. offsets[v + 1])
+ } WeightedGraph;
+
+ /* ---- Parallel loops on the task scheduler ---- */
+
+ typedef void (*GraphRangeFunc)(void* ctx, size_t begin, size_t end);
+
+ typedef struct {
+     GraphRangeFunc fn;
+     void* ctx;
+     size_t begin;
+     size_t end;
+ } GraphRange;
+
+ static inline void graph_range_task(void* arg) {
+     GraphRange* r = (GraphRange*)arg;
+     r->fn(r->ctx, r->begin, r->end);
+ }
+
+ /**
+  * @brief Runs fn over [0, n) in chunks of @p grain, as tasks on @p sched
+  *
+  * Chunk boundaries are multiples of @p grain. Runs sequentially when
+  * @p sched is NULL.
+  */
+ static inline void graph_parallel_for(TaskScheduler* sched, size_t n, size_t grain,
+                                       GraphRangeFunc fn, void* ctx) {
+     size_t chunks = (n + grain - 1) / grain;
+     GraphRange* ranges = sched != NULL && chunks > 1 ? (GraphRange*)malloc(chunks * sizeof(GraphRange)) : NULL;
+     if (ranges == NULL) {
+         for (size_t begin = 0; begin < n; begin += grain) fn(ctx, begin, begin + grain < n ? begin + grain : n);
+         return;
+     }
+     TaskGroup group;
+     task_group_init(&group);
+     for (size_t c = 0; c < chunks; c++) {
+         ranges[c].fn = fn;
+         ranges[c].ctx = ctx;
+         ranges[c].begin = c * grain;
+         ranges[c].end = (c + 1) * grain < n ? (c + 1) * grain : n;
+         task_spawn(sched, &group, graph_range_task, &ranges[c]);
+     }
+     task_sync(sched, &group);
+     free(ranges);
+ }
+
+ /* ---- CSR construction ---- */
+
+ /// Which arcs an edge produces in the CSR being built
+ typedef enum {
+     GRAPH_ARCS_FORWARD,       ///< src -> dst
+     GRAPH_ARCS_REVERSE,       ///< dst -> src
+     GRAPH_ARCS_BOTH           ///< both (one arc for a self-loop)
+ } GraphArcMode;
+
+ typedef struct {
+     uint32_t n;
+     const uint32_t* edges;    ///< src, dst[, weight] per edge
+     size_t stride;            ///< uint32_t words per edge; 3 means weighted
+     GraphArcMode mode;
+     size_t edge_grain;        ///< Edges per chunk
+     int shift;                ///< A bucket holds 1 << shift vertices
+     size_t num_buckets;
+     uint64_t* bucket_pos;     ///< [chunk][bucket] arc counts, then write cursors
+     uint64_t* bucket_start;   ///< num_buckets + 1 entries
+     uint64_t* arcs;           ///< Arcs grouped by bucket, owner << 32 | neighbor
+     uint32_t* arc_weights;    ///< Weights of arcs[], when weighted
+     uint64_t* offsets;
+     void* targets;            ///< uint32_t neighbors, or WeightedArc when weighted
+     atomic_bool invalid;      ///< An edge had an endpoint >= n
+ } GraphBuild;
+
+ // Counts the arcs each bucket receives from one chunk of edges
+ static inline void graph_build_count(void* arg, size_t begin, size_t end) {
+     GraphBuild* b = (GraphBuild*)arg;
+     uint64_t* row = b->bucket_pos + begin / b->edge_grain * b->num_buckets;
+     for (size_t i = begin; i < end; i++) {
+         const uint32_t* e = b->edges + i * b->stride;
+         uint32_t s = e[0], d = e[1];
+         if (s >= b->n || d >= b->n) {
+             atomic_store_explicit(&b->invalid, true, memory_order_relaxed);
+             continue;
+         }
+         if (b->mode != GRAPH_ARCS_REVERSE) row[s >> b->shift]++;
+         if (b->mode == GRAPH_ARCS_REVERSE || (b->mode == GRAPH_ARCS_BOTH && s != d)) row[d >> b->shift]++;
+     }
+ }
+
+ // Appends one chunk's arcs to the buckets, at cursors reserved for the chunk
+ static inline void graph_build_bin(void* arg, size_t begin, size_t end) {
+     GraphBuild* b = (GraphBuild*)arg;
+     uint64_t* row = b->bucket_pos + begin / b->edge_grain * b->num_buckets;
+     for (size_t i = begin; i < end; i++) {
+         const uint32_t* e = b->edges + i * b->stride;
+         uint32_t s = e[0], d = e[1];
+         if (b->mode != GRAPH_ARCS_REVERSE) {
+             uint64_t at = row[s >> b->shift]++;
+             b->arcs[at] = (uint64_t)s << 32 | d;
+             if (b->arc_weights != NULL) b->arc_weights[at] = e[2];
+         }
+         if (b->mode == GRAPH_ARCS_REVERSE || (b->mode == GRAPH_ARCS_BOTH && s != d)) {
+             uint64_t at = row[d >> b->shift]++;
+             b->arcs[at] = (uint64_t)d << 32 | s;
+             if (b->arc_weights != NULL) b->arc_weights[at] = e[2];
+         }
+     }
+ }
+
+ // Builds offsets and neighbor lists of the vertices in buckets [begin, end).
+ // A bucket's arcs and neighbors are small enough to stay in cache.
+ static inline void graph_build_buckets(void* arg, size_t begin, size_t end) {
+     GraphBuild* b = (GraphBuild*)arg;
+     for (size_t k = begin; k < end; k++) {
+         size_t v0 = k << b->shift, v1 = (k + 1) << b->shift;
+         if (v1 > b->n) v1 = b->n;
+         uint64_t first = b->bucket_start[k], last = b->bucket_start[k + 1];
+         if (v0 >= v1) continue;
+         uint64_t* offsets = b->offsets;
+         memset(offsets + v0, 0, (v1 - v0) * sizeof(uint64_t));
+         for (uint64_t i = first; i < last; i++) offsets[b->arcs[i] >> 32]++;
+         uint64_t sum = first;
+         for (size_t v = v0; v < v1; v++) {
+             uint64_t degree = offsets[v];
+             offsets[v] = sum;
+             sum += degree;
+         }
+         // offsets[v] serves as the cursor and ends at the start of v + 1
+         if (b->arc_weights != NULL) {
+             WeightedArc* out = (WeightedArc*)b->targets;
+             for (uint64_t i = first; i < last; i++) {
+                 uint64_t arc = b->arcs[i];
+                 WeightedArc* slot = &out[offsets[arc >> 32]++];
+                 slot->target = (uint32_t)arc;
+                 slot->weight = b->arc_weights[i];
+             }
+         } else {
+             uint32_t* out = (uint32_t*)b->targets;
+             for (uint64_t i = first; i < last; i++) {
+                 uint64_t arc = b->arcs[i];
+                 out[offsets[arc >> 32]++] = (uint32_t)arc;
+             }
+         }
+         for (size_t v = v1 - 1; v > v0; v--) offsets[v] = offsets[v - 1];
+         offsets[v0] = first;
+     }
+ }
+
+ /**
+  * @brief Builds one CSR (offsets, targets) from an edge list
+  *
+  * Edges are @p stride uint32_t words each: src, dst and, when the stride is
+  * 3, a weight. Targets are then WeightedArc entries instead of uint32_t.
+  *
+  * Propagation blocking: arcs are first appended to buckets of consecutive
+  * vertices (a few sequential write streams), then each bucket is laid out
+  * on its own. Writing neighbors straight to their final slots would miss
+  * the cache on almost every arc. Needs 8 bytes per arc of temporary memory.
+  *
+  * @return false on allocation failure or an out-of-range endpoint
+  */
+ static inline bool graph_build_csr(uint32_t n, const uint32_t* edges, size_t stride, size_t num_edges,
+                                    GraphArcMode mode, TaskScheduler* sched, uint64_t** offsets_out,
+                                    void** targets_out, uint64_t* num_arcs_out) {
+     GraphBuild b;
+     b.n = n;
+     b.edges = edges;
+     b.stride = stride;
+     b.mode = mode;
+     atomic_init(&b.invalid, false);
+
+     // Up to 256 edge chunks; a single one when sequential
+     size_t edge_grain = num_edges > 0 ? num_edges : 1;
+     if (sched != NULL) {
+         edge_grain = (num_edges + 255) / 256;
+         if (edge_grain < GRAPH_BUILD_GRAIN) edge_grain = GRAPH_BUILD_GRAIN;
+     }
+     size_t chunks = (num_edges + edge_grain - 1) / edge_grain;
+     b.edge_grain = edge_grain;
+
+     // Buckets of about GRAPH_BUILD_BUCKET_ARCS arcs on average
+     uint64_t arcs_per_vertex = (mode == GRAPH_ARCS_BOTH ? 2 : 1) * (uint64_t)num_edges / (n > 0 ? n : 1);
+     uint64_t bucket_vertices = GRAPH_BUILD_BUCKET_ARCS / (arcs_per_vertex > 0 ? arcs_per_vertex : 1);
+     b.shift = 0;
+     while (b.shift < 31 && ((uint64_t)2 << b.shift) <= bucket_vertices) b.shift++;
+     b.num_buckets = ((size_t)n >> b.shift) + 1;
+
+     b.bucket_pos = (uint64_t*)calloc((chunks > 0 ? chunks : 1) * b.num_buckets, sizeof(uint64_t));
+     b.bucket_start = (uint64_t*)malloc((b.num_buckets + 1) * sizeof(uint64_t));
+     b.offsets = (uint64_t*)malloc(((size_t)n + 1) * sizeof(uint64_t));
+     b.arcs = NULL;
+     b.arc_weights = NULL;
+     b.targets = NULL;
+     if (b.bucket_pos == NULL || b.bucket_start == NULL || b.offsets == NULL) goto fail;
+
+     graph_parallel_for(sched, num_edges, edge_grain, graph_build_count, &b);
+     if (atomic_load(&b.invalid)) goto fail;
+
+     // Bucket-major, chunk-minor scan: each chunk gets its own range in every bucket
+     uint64_t total = 0;
+     for (size_t k = 0; k < b.num_buckets; k++) {
+         b.bucket_start[k] = total;
+         for (size_t c = 0; c < chunks; c++) {
+             uint64_t count = b.bucket_pos[c * b.num_buckets + k];
+             b.bucket_pos[c * b.num_buckets + k] = total;
+             total += count;
+         }
+     }
+     b.bucket_start[b.num_buckets] = total;
+
+     size_t slots = total > 0 ? (size_t)total : 1;
+     b.arcs = (uint64_t*)malloc(slots * sizeof(uint64_t));
+     if (stride > 2) {
+         b.arc_weights = (uint32_t*)malloc(slots * sizeof(uint32_t));
+         b.targets = malloc(slots * sizeof(WeightedArc));
+         if (b.arc_weights == NULL) goto fail;
+     } else {
+         b.targets = malloc(slots * sizeof(uint32_t));
+     }
+     if (b.arcs == NULL || b.targets == NULL) goto fail;
+     graph_parallel_for(sched, num_edges, edge_grain, graph_build_bin, &b);
+     graph_parallel_for(sched, b.num_buckets, 1, graph_build_buckets, &b);
+     b.offsets[n] = total;
+
+     free(b.bucket_pos);
+     free(b.bucket_start);
+     free(b.arcs);
+     free(b.arc_weights);
+     *offsets_out = b.offsets;
+     *targets_out = b.targets;
+     *num_arcs_out = total;
+     return true;
+
+ fail:
+     free(b.bucket_pos);
+     free(b.bucket_start);
+     free(b.offsets);
+     free(b.arcs);
+     free(b.arc_weights);
+     free(b.targets);
+     return false;
+ }
+
+ /**
+  * @brief Frees a graph (NULL is allowed)
+  */
+ static inline void graph_free(Graph* g) {
+     if (g == NULL) return;
+     if (!g->undirected) {
+         free(g->in_offsets);
+         free(g->in_neighbors);
+     }
+     free(g->out_offsets);
+     free(g->out_neighbors);
+     free(g);
+ }
+
+ /**
+  * @brief Builds a graph from an edge list
+  *
+  * @param num_vertices Number of vertices; every endpoint must be below it
+  * @param edges Edge list (not kept after the call)
+  * @param num_edges Number of edges
+  * @param undirected true: each edge u-v becomes arcs u->v and v->u
+  *                   (a self-loop becomes one arc); false: arc src->dst
+  * @param sched Scheduler to build on, or NULL to build sequentially
+  * @return Graph* The graph, or NULL on allocation failure or an endpoint
+  *         out of range
+  */
+ static inline Graph* graph_create(uint32_t num_vertices, const GraphEdge* edges, size_t num_edges,
+                                   bool undirected, TaskScheduler* sched) {
+     if (num_vertices == GRAPH_NO_VERTEX) return NULL;
+     Graph* g = (Graph*)calloc(1, sizeof(Graph));
+     if (g == NULL) return NULL;
+     g->num_vertices = num_vertices;
+     g->undirected = undirected;
+     void* targets;
+     if (!graph_build_csr(num_vertices, (const uint32_t*)edges, 2, num_edges,
+                          undirected ? GRAPH_ARCS_BOTH : GRAPH_ARCS_FORWARD,
+                          sched, &g->out_offsets, &targets, &g->num_arcs)) {
+         free(g);
+         return NULL;
+     }
+     g->out_neighbors = (uint32_t*)targets;
+     if (undirected) {
+         g->in_offsets = g->out_offsets;
+         g->in_neighbors = g->out_neighbors;
+         return g;
+     }
+     uint64_t in_arcs;
+     if (!graph_build_csr(num_vertices, (const uint32_t*)edges, 2, num_edges, GRAPH_ARCS_REVERSE,
+                          sched, &g->in_offsets, &targets, &in_arcs)) {
+         g->undirected = true;     // Only the out-CSR exists
+         graph_free(g);
+         return NULL;
+     }
+     g->in_neighbors = (uint32_t*)targets;
+     return g;
+ }
+
+ /**
+  * @brief Frees a weighted graph (NULL is allowed)
+  */
+ static inline void weighted_graph_free(WeightedGraph* g) {
+     if (g == NULL) return;
+     free(g->offsets);
+     free(g->arcs);
+     free(g);
+ }
+
+ /**
+  * @brief Builds a weighted graph from an edge list
+  *
+  * Same as graph_create(), except that only out-arcs are stored and each
+  * arc carries the weight of its edge.
+  */
+ static inline WeightedGraph* weighted_graph_create(uint32_t num_vertices, const WeightedEdge* edges,
+                                                    size_t num_edges, bool undirected, TaskScheduler* sched) {
+     if (num_vertices == GRAPH_NO_VERTEX) return NULL;
+     WeightedGraph* g = (WeightedGraph*)calloc(1, sizeof(WeightedGraph));
+     if (g == NULL) return NULL;
+     g->num_vertices = num_vertices;
+     void* targets;
+     if (!graph_build_csr(num_vertices, (const uint32_t*)edges, 3, num_edges,
+                          undirected ? GRAPH_ARCS_BOTH : GRAPH_ARCS_FORWARD,
+                          sched, &g->offsets, &targets, &g->num_arcs)) {
+         free(g);
+         return NULL;
+     }
+     g->arcs = (WeightedArc*)targets;
+     return g;
+ }
+
+ /**
+  * @brief Out-arcs of @p v in a weighted graph: returns a pointer to them and
+  *        stores their count in @p count
+  */
+ static inline const WeightedArc* weighted_graph_arcs(const WeightedGraph* g, uint32_t v, uint64_t* count) {
+     *count = g->offsets[v + 1] - g->offsets[v];
+     return g->arcs + g->offsets[v];
+ }
+
+ static inline uint32_t graph_num_vertices(const Graph* g) {
+     return g->num_vertices;
+ }
+
+ static inline uint64_t graph_num_arcs(const Graph* g) {
+     return g->num_arcs;
+ }
+
+ static inline uint64_t graph_out_degree(const Graph* g, uint32_t v) {
+     return g->out_offsets[v + 1] - g->out_offsets[v];
+ }
+
+ static inline uint64_t graph_in_degree(const Graph* g, uint32_t v) {
+     return g->in_offsets[v + 1] - g->in_offsets[v];
+ }
+
+ /**
+  * @brief Out-neighbors of @p v: returns a pointer to them and stores their
+  *        count in @p count
+  */
+ static inline const uint32_t* graph_neighbors(const Graph* g, uint32_t v, uint64_t* count) {
+     *count = g->out_offsets[v + 1] - g->out_offsets[v];
+     return g->out_neighbors + g->out_offsets[v];
+ }
+
+ /* ---- Breadth-first search ---- */
+
+ static inline bool graph_bfs_run(const Graph* g, uint32_t source, int32_t* distance, uint32_t* parent,
+                                  bool direction_optimizing) {
+     uint32_t n = g->num_vertices;
+     if (source >= n) return false;
+     uint32_t* queue = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+     Bitset* visited = bitset_create(n);
+     Bitset* front = direction_optimizing ? bitset_create(n) : NULL;
+     Bitset* next = direction_optimizing ? bitset_create(n) : NULL;
+     if (queue == NULL || visited == NULL || (direction_optimizing && (front == NULL || next == NULL))) {
+         free(queue);
+         bitset_free(visited);
+         bitset_free(front);
+         bitset_free(next);
+         return false;
+     }
+     if (distance != NULL) {
+         for (uint32_t v = 0; v < n; v++) distance[v] = -1;
+         distance[source] = 0;
+     }
+     if (parent != NULL) {
+         for (uint32_t v = 0; v < n; v++) parent[v] = GRAPH_NO_VERTEX;
+         parent[source] = source;
+     }
+
+     bitset_set(visited, source);
+     size_t head = 0, tail = 0;
+     queue[tail++] = source;
+     uint64_t frontier_arcs = graph_out_degree(g, source);           // Arcs leaving the frontier
+     uint64_t unexplored_arcs = g->num_arcs - frontier_arcs;        // Arcs of unvisited vertices
+     size_t frontier_size = 1;
+     bool bottom_up = false;
+     int32_t level = 0;
+
+     while (frontier_size > 0) {
+         if (direction_optimizing && !bottom_up && frontier_arcs > unexplored_arcs / GRAPH_BFS_ALPHA) {
+             // Queue -> bitset
+             bitset_clear_all(front);
+             for (size_t i = head; i < tail; i++) bitset_set(front, queue[i]);
+             bottom_up = true;
+         }
+
+         if (!bottom_up) {
+             size_t level_end = tail;
+             frontier_arcs = 0;
+             for (; head < level_end; head++) {
+                 uint32_t u = queue[head];
+                 const uint32_t* adj = g->out_neighbors + g->out_offsets[u];
+                 const uint32_t* adj_end = g->out_neighbors + g->out_offsets[u + 1];
+                 for (; adj < adj_end; adj++) {
+                     uint32_t v = *adj;
+                     if (bitset_test_and_set(visited, v)) continue;
+                     if (distance != NULL) distance[v] = level + 1;
+                     if (parent != NULL) parent[v] = u;
+                     queue[tail++] = v;
+                     frontier_arcs += graph_out_degree(g, v);
+                 }
+             }
+             frontier_size = tail - head;
+         } else {
+             // Every unvisited vertex looks for a parent in the frontier
+             bitset_clear_all(next);
+             size_t awake = 0;
+             frontier_arcs = 0;
+             size_t words = ((size_t)n + 63) / 64;
+             for (size_t w = 0; w < words; w++) {
+                 // Whole words of the visited bitset at a time
+                 uint64_t todo = ~visited->words[w];
+                 if (w == words - 1 && (n & 63)) todo &= ((uint64_t)1 << (n & 63)) - 1;
+                 while (todo) {
+                     uint32_t v = (uint32_t)(w * 64 + (size_t)__builtin_ctzll(todo));
+                     todo &= todo - 1;
+                     const uint32_t* adj = g->in_neighbors + g->in_offsets[v];
+                     const uint32_t* adj_end = g->in_neighbors + g->in_offsets[v + 1];
+                     for (; adj < adj_end; adj++) {
+                         uint32_t u = *adj;
+                         if (!bitset_test(front, u)) continue;
+                         bitset_set(visited, v);
+                         bitset_set(next, v);
+                         if (distance != NULL) distance[v] = level + 1;
+                         if (parent != NULL) parent[v] = u;
+                         awake++;
+                         frontier_arcs += graph_out_degree(g, v);
+                         break;
+                     }
+                 }
+             }
+             Bitset* t = front;
+             front = next;
+             next = t;
+             bool shrinking = awake < frontier_size;
+             frontier_size = awake;
+             if (shrinking && awake < n / GRAPH_BFS_BETA) {
+                 // Bitset -> queue
+                 head = tail = 0;
+                 BITSET_FOREACH(front, v) queue[tail++] = (uint32_t)v;
+                 bottom_up = false;
+             }
+         }
+         unexplored_arcs -= frontier_arcs;
+         level++;
+     }
+
+     free(queue);
+     bitset_free(visited);
+     bitset_free(front);
+     bitset_free(next);
+     return true;
+ }
+
+ /**
+  * @brief Direction-optimizing breadth-first search from @p source
+  *
+  * @param g Graph
+  * @param source Start vertex
+  * @param distance If not NULL, receives the number of arcs on a shortest
+  *        path from @p source, or -1 for unreachable vertices
+  * @param parent If not NULL, receives a BFS-tree parent of every reached
+  *        vertex (@p source is its own parent), GRAPH_NO_VERTEX otherwise
+  * @return false if @p source is out of range or memory runs out
+  */
+ static inline bool graph_bfs(const Graph* g, uint32_t source, int32_t* distance, uint32_t* parent) {
+     return graph_bfs_run(g, source, distance, parent, true);
+ }
+
+ /**
+  * @brief Conventional queue-based (top-down only) BFS; same contract as graph_bfs()
+  */
+ static inline bool graph_bfs_top_down(const Graph* g, uint32_t source, int32_t* distance, uint32_t* parent) {
+     return graph_bfs_run(g, source, distance, parent, false);
+ }
+
+ /* ---- Parallel breadth-first search ---- */
+
+ typedef struct {
+     const Graph* g;
+     int32_t* distance;
+     uint32_t* parent;
+     int32_t level;                ///< Distance of the vertices found in this step
+     size_t words;
+     _Atomic uint64_t* visited;
+     _Atomic uint64_t* front;      ///< Frontier bitset (bottom-up)
+     _Atomic uint64_t* next;
+     const uint32_t* queue;        ///< Frontier queue (top-down)
+     uint32_t* next_queue;
+     _Atomic size_t next_size;
+     _Atomic uint64_t frontier_arcs;
+     _Atomic size_t awake;
+ } GraphParBfs;
+
+ // Appends a task's local frontier to the next frontier
+ static inline void graph_par_flush(GraphParBfs* b, const uint32_t* local, size_t count) {
+     if (count == 0) return;
+     size_t at = atomic_fetch_add_explicit(&b->next_size, count, memory_order_relaxed);
+     memcpy(b->next_queue + at, local, count * sizeof(uint32_t));
+ }
+
+ static inline void graph_par_bfs_init(void* arg, size_t begin, size_t end) {
+     GraphParBfs* b = (GraphParBfs*)arg;
+     size_t v0 = begin * 64, v1 = end * 64 < b->g->num_vertices ? end * 64 : b->g->num_vertices;
+     for (size_t w = begin; w < end; w++) atomic_store_explicit(&b->visited[w], 0, memory_order_relaxed);
+     if (b->distance != NULL) {
+         for (size_t v = v0; v < v1; v++) b->distance[v] = -1;
+     }
+     if (b->parent != NULL) {
+         for (size_t v = v0; v < v1; v++) b->parent[v] = GRAPH_NO_VERTEX;
+     }
+ }
+
+ static inline void graph_par_top_down(void* arg, size_t begin, size_t end) {
+     GraphParBfs* b = (GraphParBfs*)arg;
+     const Graph* g = b->g;
+     uint32_t local[GRAPH_PAR_LOCAL_FRONTIER];
+     size_t count = 0;
+     uint64_t arcs = 0;
+     for (size_t i = begin; i < end; i++) {
+         uint32_t u = b->queue[i];
+         const uint32_t* adj = g->out_neighbors + g->out_offsets[u];
+         const uint32_t* adj_end = g->out_neighbors + g->out_offsets[u + 1];
+         for (; adj < adj_end; adj++) {
+             uint32_t v = *adj;
+             uint64_t bit = (uint64_t)1 << (v & 63);
+             // Plain load first: most arcs lead to visited vertices
+             if (atomic_load_explicit(&b->visited[v >> 6], memory_order_relaxed) & bit) continue;
+             if (atomic_fetch_or_explicit(&b->visited[v >> 6], bit, memory_order_relaxed) & bit) continue;
+             if (b->distance != NULL) b->distance[v] = b->level;
+             if (b->parent != NULL) b->parent[v] = u;
+             arcs += graph_out_degree(g, v);
+             local[count++] = v;
+             if (count == GRAPH_PAR_LOCAL_FRONTIER) {
+                 graph_par_flush(b, local, count);
+                 count = 0;
+             }
+         }
+     }
+     graph_par_flush(b, local, count);
+     atomic_fetch_add_explicit(&b->frontier_arcs, arcs, memory_order_relaxed);
+ }
+
+ // Each task owns bitset words [begin, end), so visited and next need no read-modify-write
+ static inline void graph_par_bottom_up(void* arg, size_t begin, size_t end) {
+     GraphParBfs* b = (GraphParBfs*)arg;
+     const Graph* g = b->g;
+     uint32_t n = g->num_vertices;
+     size_t awake = 0;
+     uint64_t arcs = 0;
+     for (size_t w = begin; w < end; w++) {
+         uint64_t seen = atomic_load_explicit(&b->visited[w], memory_order_relaxed);
+         uint64_t todo = ~seen, found = 0;
+         if (w == b->words - 1 && (n & 63)) todo &= ((uint64_t)1 << (n & 63)) - 1;
+         while (todo) {
+             int bit = __builtin_ctzll(todo);
+             uint32_t v = (uint32_t)(w * 64 + (size_t)bit);
+             todo &= todo - 1;
+             const uint32_t* adj = g->in_neighbors + g->in_offsets[v];
+             const uint32_t* adj_end = g->in_neighbors + g->in_offsets[v + 1];
+             for (; adj < adj_end; adj++) {
+                 uint32_t u = *adj;
+                 if (!((atomic_load_explicit(&b->front[u >> 6], memory_order_relaxed) >> (u & 63)) & 1)) continue;
+                 found |= (uint64_t)1 << bit;
+                 if (b->distance != NULL) b->distance[v] = b->level;
+                 if (b->parent != NULL) b->parent[v] = u;
+                 awake++;
+                 arcs += graph_out_degree(g, v);
+                 break;
+             }
+         }
+         atomic_store_explicit(&b->visited[w], seen | found, memory_order_relaxed);
+         atomic_store_explicit(&b->next[w], found, memory_order_relaxed);
+     }
+     atomic_fetch_add_explicit(&b->awake, awake, memory_order_relaxed);
+     atomic_fetch_add_explicit(&b->frontier_arcs, arcs, memory_order_relaxed);
+ }
+
+ static inline void graph_par_clear_front(void* arg, size_t begin, size_t end) {
+     GraphParBfs* b = (GraphParBfs*)arg;
+     for (size_t w = begin; w < end; w++) atomic_store_explicit(&b->front[w], 0, memory_order_relaxed);
+ }
+
+ static inline void graph_par_queue_to_bits(void* arg, size_t begin, size_t end) {
+     GraphParBfs* b = (GraphParBfs*)arg;
+     for (size_t i = begin; i < end; i++) {
+         uint32_t v = b->queue[i];
+         atomic_fetch_or_explicit(&b->front[v >> 6], (uint64_t)1 << (v & 63), memory_order_relaxed);
+     }
+ }
+
+ static inline void graph_par_bits_to_queue(void* arg, size_t begin, size_t end) {
+     GraphParBfs* b = (GraphParBfs*)arg;
+     uint32_t local[GRAPH_PAR_LOCAL_FRONTIER];
+     size_t count = 0;
+     for (size_t w = begin; w < end; w++) {
+         uint64_t bits = atomic_load_explicit(&b->front[w], memory_order_relaxed);
+         for (; bits; bits &= bits - 1) {
+             local[count++] = (uint32_t)(w * 64 + (size_t)__builtin_ctzll(bits));
+             if (count == GRAPH_PAR_LOCAL_FRONTIER) {
+                 graph_par_flush(b, local, count);
+                 count = 0;
+             }
+         }
+     }
+     graph_par_flush(b, local, count);
+ }
+
+ /**
+  * @brief Level-synchronous, direction-optimizing BFS on a task scheduler
+  *
+  * Same contract and results as graph_bfs(), except that when several
+  * vertices of a level can be a vertex's parent, which one is recorded
+  * depends on scheduling. Runs graph_bfs() when @p sched is NULL.
+  */
+ static inline bool graph_bfs_parallel(const Graph* g, uint32_t source, int32_t* distance, uint32_t* parent,
+                                       TaskScheduler* sched) {
+     if (sched == NULL) return graph_bfs(g, source, distance, parent);
+     uint32_t n = g->num_vertices;
+     if (source >= n) return false;
+     GraphParBfs b;
+     b.g = g;
+     b.distance = distance;
+     b.parent = parent;
+     b.words = ((size_t)n + 63) / 64;
+     b.visited = (_Atomic uint64_t*)malloc(b.words * sizeof(_Atomic uint64_t));
+     b.front = (_Atomic uint64_t*)malloc(b.words * sizeof(_Atomic uint64_t));
+     b.next = (_Atomic uint64_t*)malloc(b.words * sizeof(_Atomic uint64_t));
+     uint32_t* queue = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+     b.next_queue = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+     if (b.visited == NULL || b.front == NULL || b.next == NULL || queue == NULL || b.next_queue == NULL) {
+         free((void*)b.visited);
+         free((void*)b.front);
+         free((void*)b.next);
+         free(queue);
+         free(b.next_queue);
+         return false;
+     }
+     graph_parallel_for(sched, b.words, GRAPH_PAR_WORD_GRAIN, graph_par_bfs_init, &b);
+     atomic_store_explicit(&b.visited[source >> 6], (uint64_t)1 << (source & 63), memory_order_relaxed);
+     if (distance != NULL) distance[source] = 0;
+     if (parent != NULL) parent[source] = source;
+
+     queue[0] = source;
+     size_t frontier_size = 1;
+     uint64_t frontier_arcs = graph_out_degree(g, source);
+     uint64_t unexplored_arcs = g->num_arcs - frontier_arcs;
+     bool bottom_up = false;
+     b.level = 0;
+
+     while (frontier_size > 0) {
+         b.level++;
+         atomic_init(&b.frontier_arcs, 0);
+         if (!bottom_up && frontier_arcs > unexplored_arcs / GRAPH_BFS_ALPHA) {
+             b.queue = queue;
+             graph_parallel_for(sched, b.words, GRAPH_PAR_WORD_GRAIN, graph_par_clear_front, &b);
+             graph_parallel_for(sched, frontier_size, GRAPH_PAR_FRONTIER_GRAIN, graph_par_queue_to_bits, &b);
+             bottom_up = true;
+         }
+
+         if (!bottom_up) {
+             b.queue = queue;
+             atomic_init(&b.next_size, 0);
+             graph_parallel_for(sched, frontier_size, GRAPH_PAR_FRONTIER_GRAIN, graph_par_top_down, &b);
+             frontier_size = atomic_load(&b.next_size);
+             uint32_t* t = queue;
+             queue = b.next_queue;
+             b.next_queue = t;
+         } else {
+             atomic_init(&b.awake, 0);
+             graph_parallel_for(sched, b.words, GRAPH_PAR_WORD_GRAIN, graph_par_bottom_up, &b);
+             _Atomic uint64_t* t = b.front;
+             b.front = b.next;
+             b.next = t;
+             size_t awake = atomic_load(&b.awake);
+             bool shrinking = awake < frontier_size;
+             frontier_size = awake;
+             if (shrinking && awake < n / GRAPH_BFS_BETA) {
+                 atomic_init(&b.next_size, 0);
+                 graph_parallel_for(sched, b.words, GRAPH_PAR_WORD_GRAIN, graph_par_bits_to_queue, &b);
+                 uint32_t* q = queue;
+                 queue = b.next_queue;
+                 b.next_queue = q;
+                 bottom_up = false;
+             }
+         }
+         frontier_arcs = atomic_load(&b.frontier_arcs);
+         unexplored_arcs -= frontier_arcs;
+     }
+
+     free((void*)b.visited);
+     free((void*)b.front);
+     free((void*)b.next);
+     free(queue);
+     free(b.next_queue);
+     return true;
+ }
+
+ /* ---- Connected components (Afforest) ---- */
+
+ typedef struct {
+     const Graph* g;
+     _Atomic uint32_t* comp;       ///< Union-find parent; a root is its own parent
+     uint32_t round;               ///< Sampled neighbor index in the linking rounds
+     uint32_t skip;                ///< Largest sampled component
+     uint32_t* out;
+ } GraphCc;
+
+ // Joins the trees of u and v, hooking the higher root under the lower one
+ static inline void graph_cc_link(_Atomic uint32_t* comp, uint32_t u, uint32_t v) {
+     uint32_t p1 = atomic_load_explicit(&comp[u], memory_order_relaxed);
+     uint32_t p2 = atomic_load_explicit(&comp[v], memory_order_relaxed);
+     while (p1 != p2) {
+         uint32_t high = p1 > p2 ? p1 : p2, low = p1 + p2 - high;
+         uint32_t p_high = atomic_load_explicit(&comp[high], memory_order_relaxed);
+         if (p_high == low) break;
+         if (p_high == high) {
+             uint32_t expected = high;
+             if (atomic_compare_exchange_strong_explicit(&comp[high], &expected, low,
+                                                         memory_order_relaxed, memory_order_relaxed)) break;
+         }
+         p1 = atomic_load_explicit(&comp[atomic_load_explicit(&comp[high], memory_order_relaxed)],
+                                   memory_order_relaxed);
+         p2 = atomic_load_explicit(&comp[low], memory_order_relaxed);
+     }
+ }
+
+ static inline void graph_cc_init(void* arg, size_t begin, size_t end) {
+     GraphCc* c = (GraphCc*)arg;
+     for (size_t v = begin; v < end; v++) atomic_store_explicit(&c->comp[v], (uint32_t)v, memory_order_relaxed);
+ }
+
+ static inline void graph_cc_compress(void* arg, size_t begin, size_t end) {
+     GraphCc* c = (GraphCc*)arg;
+     for (size_t v = begin; v < end; v++) {
+         for (;;) {
+             uint32_t p = atomic_load_explicit(&c->comp[v], memory_order_relaxed);
+             uint32_t pp = atomic_load_explicit(&c->comp[p], memory_order_relaxed);
+             if (p == pp) break;
+             atomic_store_explicit(&c->comp[v], pp, memory_order_relaxed);
+         }
+     }
+ }
+
+ static inline void graph_cc_store(void* arg, size_t begin, size_t end) {
+     GraphCc* c = (GraphCc*)arg;
+     for (size_t v = begin; v < end; v++) c->out[v] = atomic_load_explicit(&c->comp[v], memory_order_relaxed);
+ }
+
+ static inline void graph_cc_sample_round(void* arg, size_t begin, size_t end) {
+     GraphCc* c = (GraphCc*)arg;
+     const Graph* g = c->g;
+     for (size_t v = begin; v < end; v++) {
+         if (graph_out_degree(g, (uint32_t)v) > c->round) {
+             graph_cc_link(c->comp, (uint32_t)v, g->out_neighbors[g->out_offsets[v] + c->round]);
+         }
+     }
+ }
+
+ static inline void graph_cc_finish(void* arg, size_t begin, size_t end) {
+     GraphCc* c = (GraphCc*)arg;
+     const Graph* g = c->g;
+     for (size_t v = begin; v < end; v++) {
+         if (atomic_load_explicit(&c->comp[v], memory_order_relaxed) == c->skip) continue;
+         for (uint64_t i = g->out_offsets[v] + GRAPH_CC_NEIGHBOR_ROUNDS; i < g->out_offsets[v + 1]; i++) {
+             graph_cc_link(c->comp, (uint32_t)v, g->out_neighbors[i]);
+         }
+         // Arcs into v from the skipped component are seen only from this side
+         if (!g->undirected) {
+             for (uint64_t i = g->in_offsets[v]; i < g->in_offsets[v + 1]; i++) {
+                 graph_cc_link(c->comp, (uint32_t)v, g->in_neighbors[i]);
+             }
+         }
+     }
+ }
+
+ static inline int graph_cc_compare_u32(const void* a, const void* b) {
+     uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+     return (x > y) - (x < y);
+ }
+
+ /**
+  * @brief Labels connected components (weakly connected for directed graphs)
+  *
+  * @param g Graph
+  * @param component Receives, for every vertex, the smallest vertex id in
+  *        its component (num_vertices entries)
+  * @param sched Scheduler to run on, or NULL to run sequentially
+  * @return false if memory runs out
+  */
+ static inline bool graph_connected_components(const Graph* g, uint32_t* component, TaskScheduler* sched) {
+     uint32_t n = g->num_vertices;
+     GraphCc c;
+     c.g = g;
+     c.out = component;
+     c.comp = (_Atomic uint32_t*)malloc(((size_t)n + 1) * sizeof(_Atomic uint32_t));
+     if (c.comp == NULL) return false;
+     size_t grain = GRAPH_PAR_WORD_GRAIN * 64;
+     graph_parallel_for(sched, n, grain, graph_cc_init, &c);
+
+     for (c.round = 0; c.round < GRAPH_CC_NEIGHBOR_ROUNDS; c.round++) {
+         graph_parallel_for(sched, n, grain, graph_cc_sample_round, &c);
+         graph_parallel_for(sched, n, grain, graph_cc_compress, &c);
+     }
+
+     // Most frequent root among random samples, likely the giant component
+     c.skip = GRAPH_NO_VERTEX;
+     if (n > 0) {
+         uint32_t samples[GRAPH_CC_SAMPLES];
+         uint64_t x = 0x9E3779B97F4A7C15ull;
+         for (int i = 0; i < GRAPH_CC_SAMPLES; i++) {
+             x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+             samples[i] = atomic_load_explicit(&c.comp[x % n], memory_order_relaxed);
+         }
+         qsort(samples, GRAPH_CC_SAMPLES, sizeof(uint32_t), graph_cc_compare_u32);
+         int best = 0;
+         for (int i = 0, j; i < GRAPH_CC_SAMPLES; i = j) {
+             for (j = i + 1; j < GRAPH_CC_SAMPLES && samples[j] == samples[i]; j++) {}
+             if (j - i > best) {
+                 best = j - i;
+                 c.skip = samples[i];
+             }
+         }
+     }
+
+     graph_parallel_for(sched, n, grain, graph_cc_finish, &c);
+     graph_parallel_for(sched, n, grain, graph_cc_compress, &c);
+     graph_parallel_for(sched, n, grain, graph_cc_store, &c);
+     free((void*)c.comp);
+     return true;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // GRAPH_H
@@ -0,0 +1,224 @@
+// indexed_priority_queue.h
+#ifndef INDEXED_PRIORITY_QUEUE_H
+#define INDEXED_PRIORITY_QUEUE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Indexed priority queue (binary min-heap addressed by element id)
+// 索引优先队列（可按元素编号访问的二叉最小堆）
+//
+// Every element has an integer id in [0, max_id). Besides the heap, a
+// position map pos[id] records where the element currently sits, so an
+// element can be found, re-prioritized or removed in O(log n) without
+// searching and without pushing duplicates.
+// 每个元素有一个 [0, max_id) 范围内的整数编号。除堆数组外，位置表 pos[id]
+// 记录该元素当前所在的堆位置，因此无需查找、也无需插入重复元素，就能在
+// O(log n) 时间内修改优先级或删除元素。
+
+// Key type; define before including to override (键类型，可在包含前重新定义)
+#ifndef IPQ_KEY_TYPE
+#define IPQ_KEY_TYPE double
+#endif
+
+typedef IPQ_KEY_TYPE ipq_key_t;
+
+// Heap entry: key stored next to the id to avoid an indirection per comparison
+// 堆元素：键与编号相邻存储，比较时无需额外间接访问
+typedef struct {
+    ipq_key_t key;
+    int id;
+} IpqEntry;
+
+// Indexed priority queue structure
+// 索引优先队列结构
+typedef struct {
+    IpqEntry *heap;     // Heap array starting from index 0 (堆数组，从索引0开始)
+    int *pos;           // pos[id] = heap slot, -1 if absent (元素位置，不在队列中为-1)
+    int max_id;         // Ids must be in [0, max_id) (编号范围)
+    int count;          // Current number of elements (当前元素数量)
+} IndexedPriorityQueue;
+
+// Create an empty queue for ids in [0, max_id); NULL on failure
+// 创建可容纳编号 [0, max_id) 的空队列，失败返回NULL
+static inline IndexedPriorityQueue* ipq_create(int max_id) {
+    if (max_id <= 0) return NULL;
+    IndexedPriorityQueue *ipq = (IndexedPriorityQueue*)malloc(sizeof(IndexedPriorityQueue));
+    if (!ipq) return NULL;
+    ipq->heap = (IpqEntry*)malloc((size_t)max_id * sizeof(IpqEntry));
+    ipq->pos = (int*)malloc((size_t)max_id * sizeof(int));
+    if (!ipq->heap || !ipq->pos) {
+        free(ipq->heap);
+        free(ipq->pos);
+        free(ipq);
+        return NULL;
+    }
+    for (int i = 0; i < max_id; i++) ipq->pos[i] = -1;
+    ipq->max_id = max_id;
+    ipq->count = 0;
+    return ipq;
+}
+
+// Free the memory used by the queue
+// 释放队列使用的内存
+static inline void ipq_free(IndexedPriorityQueue *ipq) {
+    if (!ipq) return;
+    free(ipq->heap);
+    free(ipq->pos);
+    free(ipq);
+}
+
+// Remove all elements in O(n) of the current size
+// 清空队列，耗时与当前元素数成正比
+static inline void ipq_clear(IndexedPriorityQueue *ipq) {
+    for (int i = 0; i < ipq->count; i++) ipq->pos[ipq->heap[i].id] = -1;
+    ipq->count = 0;
+}
+
+static inline bool ipq_empty(const IndexedPriorityQueue *ipq) {
+    return ipq->count == 0;
+}
+
+static inline int ipq_size(const IndexedPriorityQueue *ipq) {
+    return ipq->count;
+}
+
+// Check whether an id is currently in the queue, O(1)
+// 检查编号是否在队列中，O(1)
+static inline bool ipq_contains(const IndexedPriorityQueue *ipq, int id) {
+    return id >= 0 && id < ipq->max_id && ipq->pos[id] >= 0;
+}
+
+// Get the key of a queued id; false if absent
+// 获取队列中某编号的键，不存在返回false
+static inline bool ipq_key_of(const IndexedPriorityQueue *ipq, int id, ipq_key_t *key) {
+    if (!ipq_contains(ipq, id)) return false;
+    *key = ipq->heap[ipq->pos[id]].key;
+    return true;
+}
+
+// Move the hole at k up until e fits, updating the position map
+// 空穴上浮直到e满足堆性质，同时更新位置表
+static inline void ipq_sift_up(IndexedPriorityQueue *ipq, int k, IpqEntry e) {
+    IpqEntry *h = ipq->heap;
+    while (k > 0) {
+        int parent = (k - 1) / 2;
+        if (!(e.key < h[parent].key)) break;
+        h[k] = h[parent];
+        ipq->pos[h[k].id] = k;
+        k = parent;
+    }
+    h[k] = e;
+    ipq->pos[e.id] = k;
+}
+
+// Move the hole at k down until e fits, updating the position map
+// 空穴下沉直到e满足堆性质，同时更新位置表
+static inline void ipq_sift_down(IndexedPriorityQueue *ipq, int k, IpqEntry e) {
+    IpqEntry *h = ipq->heap;
+    int n = ipq->count;
+    int child;
+    while ((child = 2 * k + 1) < n) {
+        // Choose the smaller child (选择较小的子节点)
+        if (child + 1 < n && h[child + 1].key < h[child].key) child++;
+        if (!(h[child].key < e.key)) break;
+        h[k] = h[child];
+        ipq->pos[h[k].id] = k;
+        k = child;
+    }
+    h[k] = e;
+    ipq->pos[e.id] = k;
+}
+
+// Insert id with a key; false if the id is out of range or already queued
+// 插入编号及其键；编号越界或已在队列中时返回false
+static inline bool ipq_push(IndexedPriorityQueue *ipq, int id, ipq_key_t key) {
+    if (id < 0 || id >= ipq->max_id || ipq->pos[id] >= 0) return false;
+    IpqEntry e;
+    e.key = key;
+    e.id = id;
+    ipq_sift_up(ipq, ipq->count++, e);
+    return true;
+}
+
+// Peek at the minimum; false if empty (outputs may be NULL)
+// 查看最小元素；空队列返回false（输出参数可为NULL）
+static inline bool ipq_top(const IndexedPriorityQueue *ipq, int *id, ipq_key_t *key) {
+    if (ipq->count == 0) return false;
+    if (id) *id = ipq->heap[0].id;
+    if (key) *key = ipq->heap[0].key;
+    return true;
+}
+
+// Remove the minimum; false if empty (outputs may be NULL)
+// 弹出最小元素；空队列返回false（输出参数可为NULL）
+static inline bool ipq_pop(IndexedPriorityQueue *ipq, int *id, ipq_key_t *key) {
+    if (ipq->count == 0) return false;
+    IpqEntry top = ipq->heap[0];
+    if (id) *id = top.id;
+    if (key) *key = top.key;
+    ipq->pos[top.id] = -1;
+    if (--ipq->count > 0) {
+        ipq_sift_down(ipq, 0, ipq->heap[ipq->count]);
+    }
+    return true;
+}
+
+// Lower the key of a queued id; false if absent or new_key is larger
+// 降低队列中某编号的键；不存在或新键更大时返回false
+static inline bool ipq_decrease_key(IndexedPriorityQueue *ipq, int id, ipq_key_t new_key) {
+    if (!ipq_contains(ipq, id)) return false;
+    int k = ipq->pos[id];
+    if (ipq->heap[k].key < new_key) return false;
+    IpqEntry e;
+    e.key = new_key;
+    e.id = id;
+    ipq_sift_up(ipq, k, e);
+    return true;
+}
+
+// Set the key of a queued id in either direction; false if absent
+// 任意方向修改队列中某编号的键；不存在返回false
+static inline bool ipq_update(IndexedPriorityQueue *ipq, int id, ipq_key_t new_key) {
+    if (!ipq_contains(ipq, id)) return false;
+    int k = ipq->pos[id];
+    IpqEntry e;
+    e.key = new_key;
+    e.id = id;
+    if (new_key < ipq->heap[k].key) {
+        ipq_sift_up(ipq, k, e);
+    } else {
+        ipq_sift_down(ipq, k, e);
+    }
+    return true;
+}
+
+// Insert id, or lower its key if already queued with a larger one.
+// Returns true if the queue changed (the typical Dijkstra relaxation step).
+// 插入编号，若已在队列中且键更大则降低其键。队列发生变化时返回true
+// （即Dijkstra中典型的松弛操作）。
+static inline bool ipq_push_or_decrease(IndexedPriorityQueue *ipq, int id, ipq_key_t key) {
+    if (id < 0 || id >= ipq->max_id) return false;
+    if (ipq->pos[id] < 0) return ipq_push(ipq, id, key);
+    if (!(key < ipq->heap[ipq->pos[id]].key)) return false;
+    return ipq_decrease_key(ipq, id, key);
+}
+
+// Remove an arbitrary id; false if absent
+// 删除任意编号；不存在返回false
+static inline bool ipq_remove_id(IndexedPriorityQueue *ipq, int id) {
+    if (!ipq_contains(ipq, id)) return false;
+    int k = ipq->pos[id];
+    ipq->pos[id] = -1;
+    if (--ipq->count == k) return true;   // Removed the last slot (删除的是最后一个位置)
+    IpqEntry last = ipq->heap[ipq->count];
+    if (k > 0 && last.key < ipq->heap[(k - 1) / 2].key) {
+        ipq_sift_up(ipq, k, last);
+    } else {
+        ipq_sift_down(ipq, k, last);
+    }
+    return true;
+}
+
+#endif // INDEXED_PRIORITY_QUEUE_H
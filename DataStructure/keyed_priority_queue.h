@@ -0,0 +1,179 @@
+// keyed_priority_queue.h
+#ifndef KEYED_PRIORITY_QUEUE_H
+#define KEYED_PRIORITY_QUEUE_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Generic keyed priority queue (binary min-heap of (key, payload) pairs)
+// 泛型键值优先队列（以(key, payload)对为元素的二叉最小堆）
+//
+// KEYED_PQ_DEFINE(name, key_type, payload_type, less) generates a heap type
+// `name` whose entries are stored inline in one array, and functions
+// `name_push`, `name_pop`, ... specialized for those types. `less(a, b)` is a
+// macro or function deciding whether key a has higher priority than key b,
+// so the comparison is inlined instead of called through a pointer.
+// KEYED_PQ_DEFINE 生成类型 `name` 及其专用函数，元素内联存储在一个数组中；
+// `less(a, b)` 判断键a是否优先于键b，比较被内联而不是通过函数指针调用。
+//
+// Sifting moves a "hole" instead of swapping: the moving entry is held in a
+// local and written once at its final slot, so each level costs one write
+// instead of the two of a swap.
+// 上浮/下沉采用"空穴"法：移动的元素暂存在局部变量中，只在最终位置写入一次，
+// 每层只需一次写操作，而不是交换的两次。
+//
+// All errors are reported by return value; no sentinel keys are used.
+// 所有错误都通过返回值报告，不使用哨兵键值。
+
+// Default ordering: smaller key = higher priority (min-heap)
+// 默认顺序：键越小优先级越高（最小堆）
+#define KEYED_PQ_LESS(a, b) ((a) < (b))
+// Reversed ordering for max-heaps
+// 反向顺序，用于最大堆
+#define KEYED_PQ_GREATER(a, b) ((a) > (b))
+
+#define KEYED_PQ_DEFINE(name, key_type, payload_type, less)                              \
+                                                                                         \
+typedef struct {                                                                         \
+    key_type key;               /* Priority key (优先级键) */                            \
+    payload_type payload;       /* User data stored inline (内联存储的用户数据) */       \
+} name##_entry;                                                                          \
+                                                                                         \
+typedef struct {                                                                         \
+    name##_entry *heap;         /* Heap array starting from index 0 (堆数组，从索引0开始) */ \
+    size_t capacity;            /* Current allocated capacity (当前分配的容量) */        \
+    size_t count;               /* Current number of elements (当前元素数量) */          \
+} name;                                                                                  \
+                                                                                         \
+/* Initialize an empty queue in caller storage (在调用者提供的存储中初始化空队列) */     \
+static inline bool name##_init(name *pq, size_t initial_capacity) {                     \
+    pq->heap = NULL;                                                                     \
+    pq->capacity = 0;                                                                    \
+    pq->count = 0;                                                                       \
+    if (initial_capacity > 0) {                                                          \
+        pq->heap = (name##_entry*)malloc(initial_capacity * sizeof(name##_entry));       \
+        if (!pq->heap) return false;                                                     \
+        pq->capacity = initial_capacity;                                                 \
+    }                                                                                    \
+    return true;                                                                         \
+}                                                                                        \
+                                                                                         \
+/* Release the heap array (释放堆数组) */                                                \
+static inline void name##_destroy(name *pq) {                                            \
+    free(pq->heap);                                                                      \
+    pq->heap = NULL;                                                                     \
+    pq->capacity = pq->count = 0;                                                        \
+}                                                                                        \
+                                                                                         \
+/* Create a heap-allocated queue, NULL on failure (创建堆上分配的队列，失败返回NULL) */  \
+static inline name *name##_create(size_t initial_capacity) {                             \
+    name *pq = (name*)malloc(sizeof(name));                                              \
+    if (!pq) return NULL;                                                                \
+    if (!name##_init(pq, initial_capacity)) {                                            \
+        free(pq);                                                                        \
+        return NULL;                                                                     \
+    }                                                                                    \
+    return pq;                                                                           \
+}                                                                                        \
+                                                                                         \
+/* Free a queue created by name_create (释放由name_create创建的队列) */                  \
+static inline void name##_free(name *pq) {                                               \
+    if (!pq) return;                                                                     \
+    name##_destroy(pq);                                                                  \
+    free(pq);                                                                            \
+}                                                                                        \
+                                                                                         \
+/* Ensure room for at least `capacity` entries (预留至少capacity个元素的空间) */         \
+static inline bool name##_reserve(name *pq, size_t capacity) {                           \
+    if (capacity <= pq->capacity) return true;                                           \
+    if (capacity > (size_t)-1 / sizeof(name##_entry)) return false;                      \
+    name##_entry *new_heap = (name##_entry*)realloc(pq->heap,                            \
+                                                    capacity * sizeof(name##_entry));    \
+    if (!new_heap) return false;                                                         \
+    pq->heap = new_heap;                                                                 \
+    pq->capacity = capacity;                                                             \
+    return true;                                                                         \
+}                                                                                        \
+                                                                                         \
+static inline bool name##_empty(const name *pq) {                                        \
+    return pq->count == 0;                                                               \
+}                                                                                        \
+                                                                                         \
+static inline size_t name##_size(const name *pq) {                                       \
+    return pq->count;                                                                    \
+}                                                                                        \
+                                                                                         \
+/* Swim the hole at k up until `e` fits, then store it (空穴上浮后写入e) */              \
+static inline void name##_sift_up(name *pq, size_t k, name##_entry e) {                  \
+    name##_entry *h = pq->heap;                                                          \
+    while (k > 0) {                                                                      \
+        size_t parent = (k - 1) / 2;                                                     \
+        if (!(less(e.key, h[parent].key))) break;                                        \
+        h[k] = h[parent];                                                                \
+        k = parent;                                                                      \
+    }                                                                                    \
+    h[k] = e;                                                                            \
+}                                                                                        \
+                                                                                         \
+/* Sink the hole at k down until `e` fits, then store it (空穴下沉后写入e) */            \
+static inline void name##_sift_down(name *pq, size_t k, name##_entry e) {                \
+    name##_entry *h = pq->heap;                                                          \
+    size_t n = pq->count;                                                                \
+    size_t child;                                                                        \
+    while ((child = 2 * k + 1) < n) {                                                    \
+        /* Choose the higher-priority child (选择优先级更高的子节点) */                  \
+        if (child + 1 < n && less(h[child + 1].key, h[child].key)) child++;              \
+        if (!(less(h[child].key, e.key))) break;                                         \
+        h[k] = h[child];                                                                 \
+        k = child;                                                                       \
+    }                                                                                    \
+    h[k] = e;                                                                            \
+}                                                                                        \
+                                                                                         \
+/* Insert an entry; false on allocation failure (插入元素，分配失败返回false) */         \
+static inline bool name##_push(name *pq, key_type key, payload_type payload) {           \
+    if (pq->count == pq->capacity) {                                                     \
+        size_t new_capacity = pq->capacity == 0 ? 16 : pq->capacity * 2;                 \
+        if (!name##_reserve(pq, new_capacity)) return false;                             \
+    }                                                                                    \
+    name##_entry e;                                                                      \
+    e.key = key;                                                                         \
+    e.payload = payload;                                                                 \
+    name##_sift_up(pq, pq->count++, e);                                                  \
+    return true;                                                                         \
+}                                                                                        \
+                                                                                         \
+/* Peek at the top entry, NULL if empty (查看堆顶元素，空队列返回NULL) */               \
+static inline const name##_entry *name##_top(const name *pq) {                           \
+    return pq->count ? &pq->heap[0] : NULL;                                              \
+}                                                                                        \
+                                                                                         \
+/* Remove the top entry; outputs may be NULL; false if empty */                          \
+/* 弹出堆顶元素，输出参数可为NULL；空队列返回false */                                    \
+static inline bool name##_pop(name *pq, key_type *key, payload_type *payload) {          \
+    if (pq->count == 0) return false;                                                    \
+    if (key) *key = pq->heap[0].key;                                                     \
+    if (payload) *payload = pq->heap[0].payload;                                         \
+    if (--pq->count > 0) {                                                               \
+        name##_sift_down(pq, 0, pq->heap[pq->count]);                                    \
+    }                                                                                    \
+    return true;                                                                         \
+}                                                                                        \
+                                                                                         \
+/* Replace the top entry with a new one in a single sift (一次下沉替换堆顶元素) */       \
+static inline bool name##_replace_top(name *pq, key_type key, payload_type payload) {    \
+    if (pq->count == 0) return false;                                                    \
+    name##_entry e;                                                                      \
+    e.key = key;                                                                         \
+    e.payload = payload;                                                                 \
+    name##_sift_down(pq, 0, e);                                                          \
+    return true;                                                                         \
+}                                                                                        \
+                                                                                         \
+/* Remove all entries, keeping capacity (清空队列，保留容量) */                         \
+static inline void name##_clear(name *pq) {                                              \
+    pq->count = 0;                                                                       \
+}
+
+#endif // KEYED_PRIORITY_QUEUE_H
@@ -0,0 +1,281 @@
+// minmax_heap.h
+#ifndef MINMAX_HEAP_H
+#define MINMAX_HEAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+// Min-max heap (double-ended priority queue)
+// 最小-最大堆（双端优先队列）
+//
+// Levels alternate between "min" levels (even depth, root = depth 0) and
+// "max" levels (odd depth). Every node on a min level is <= all of its
+// descendants and every node on a max level is >= all of its descendants, so
+// the minimum is the root and the maximum is one of the root's two children.
+// Both ends are available in O(1) and removable in O(log n).
+// (Atkinson, Sack, Santoro, Strothotte, CACM 1986)
+// 各层交替为"最小层"（偶数深度，根深度为0）和"最大层"（奇数深度）。最小层上
+// 的节点不大于其所有后代，最大层上的节点不小于其所有后代，因此最小值在根，
+// 最大值是根的两个子节点之一。两端都可以O(1)读取、O(log n)删除。
+
+// Min-max heap structure
+// 最小-最大堆结构
+typedef struct {
+    int *heap;          // Heap array starting from index 0 (堆数组，从索引0开始)
+    int capacity;       // Current allocated capacity (当前分配的容量)
+    int count;          // Current number of elements (当前元素数量)
+} MinMaxHeap;
+
+// Result of mmh_push_bounded
+// mmh_push_bounded的结果
+typedef enum {
+    MMH_INSERTED,       // Inserted, nothing removed (已插入，未移除元素)
+    MMH_REPLACED,       // Inserted, the previous maximum was evicted (已插入，原最大值被淘汰)
+    MMH_REJECTED,       // Not inserted: not smaller than the current maximum (未插入：不小于当前最大值)
+    MMH_NO_MEMORY       // Allocation failed (内存分配失败)
+} MmhBoundedResult;
+
+// Create an empty heap; NULL on failure
+// 创建空堆，失败返回NULL
+static inline MinMaxHeap* mmh_create(int initial_capacity) {
+    MinMaxHeap *h = (MinMaxHeap*)malloc(sizeof(MinMaxHeap));
+    if (!h) return NULL;
+    h->heap = NULL;
+    h->capacity = 0;
+    h->count = 0;
+    if (initial_capacity > 0) {
+        h->heap = (int*)malloc((size_t)initial_capacity * sizeof(int));
+        if (!h->heap) {
+            free(h);
+            return NULL;
+        }
+        h->capacity = initial_capacity;
+    }
+    return h;
+}
+
+// Free the memory used by the heap
+// 释放堆使用的内存
+static inline void mmh_free(MinMaxHeap *h) {
+    if (!h) return;
+    free(h->heap);
+    free(h);
+}
+
+static inline bool mmh_empty(const MinMaxHeap *h) {
+    return h->count == 0;
+}
+
+static inline int mmh_size(const MinMaxHeap *h) {
+    return h->count;
+}
+
+// True if index i lies on a min level (索引i是否位于最小层)
+static inline bool mmh_is_min_level(int i) {
+    int depth = 0;
+    unsigned n = (unsigned)i + 1;
+#if defined(__GNUC__)
+    depth = 31 - __builtin_clz(n);
+#else
+    while (n > 1) { n >>= 1; depth++; }
+#endif
+    return (depth & 1) == 0;
+}
+
+static inline void mmh_swap(int *a, int *b) {
+    int temp = *a;
+    *a = *b;
+    *b = temp;
+}
+
+// Bubble up among grandparents on the same kind of level
+// 在同类层的祖父节点之间上浮
+static inline void mmh_bubble_up_grand(MinMaxHeap *h, int i, bool min_level) {
+    int *a = h->heap;
+    int value = a[i];
+    while (i >= 3) {
+        int grand = (i - 3) / 4;
+        if (min_level ? !(value < a[grand]) : !(value > a[grand])) break;
+        a[i] = a[grand];
+        i = grand;
+    }
+    a[i] = value;
+}
+
+// Restore order for a new element at index i
+// 为位于索引i的新元素恢复堆序
+static inline void mmh_bubble_up(MinMaxHeap *h, int i) {
+    if (i == 0) return;
+    int *a = h->heap;
+    int parent = (i - 1) / 2;
+    if (mmh_is_min_level(i)) {
+        if (a[i] > a[parent]) {
+            mmh_swap(&a[i], &a[parent]);
+            mmh_bubble_up_grand(h, parent, false);
+        } else {
+            mmh_bubble_up_grand(h, i, true);
+        }
+    } else {
+        if (a[i] < a[parent]) {
+            mmh_swap(&a[i], &a[parent]);
+            mmh_bubble_up_grand(h, parent, true);
+        } else {
+            mmh_bubble_up_grand(h, i, false);
+        }
+    }
+}
+
+// Index of the smallest (or largest) child or grandchild of i, -1 if leaf
+// i的子节点和孙节点中最小（或最大）值的索引，叶节点返回-1
+static inline int mmh_extreme_descendant(const MinMaxHeap *h, int i, bool want_min) {
+    const int *a = h->heap;
+    int n = h->count;
+    int first_child = 2 * i + 1;
+    if (first_child >= n) return -1;
+    int best = first_child;
+    int candidates[5] = { first_child + 1, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6 };
+    for (int c = 0; c < 5; c++) {
+        int j = candidates[c];
+        if (j >= n) break;
+        if (want_min ? a[j] < a[best] : a[j] > a[best]) best = j;
+    }
+    return best;
+}
+
+// Push the element at index i down to its place (Atkinson's trickle-down)
+// 将索引i处的元素下沉到正确位置
+static inline void mmh_trickle_down(MinMaxHeap *h, int i) {
+    int *a = h->heap;
+    bool min_level = mmh_is_min_level(i);
+    for (;;) {
+        int m = mmh_extreme_descendant(h, i, min_level);
+        if (m < 0) return;
+        bool better = min_level ? a[m] < a[i] : a[m] > a[i];
+        if (m > 2 * i + 2) {
+            // m is a grandchild (m为孙节点)
+            if (!better) return;
+            mmh_swap(&a[m], &a[i]);
+            int parent = (m - 1) / 2;
+            if (min_level ? a[m] > a[parent] : a[m] < a[parent]) {
+                mmh_swap(&a[m], &a[parent]);
+            }
+            i = m;
+        } else {
+            // m is a child: one swap finishes the job (m为子节点，一次交换即可)
+            if (better) mmh_swap(&a[m], &a[i]);
+            return;
+        }
+    }
+}
+
+// Ensure room for at least `capacity` elements
+// 预留至少capacity个元素的空间
+static inline bool mmh_reserve(MinMaxHeap *h, int capacity) {
+    if (capacity <= h->capacity) return true;
+    int *new_heap = (int*)realloc(h->heap, (size_t)capacity * sizeof(int));
+    if (!new_heap) return false;
+    h->heap = new_heap;
+    h->capacity = capacity;
+    return true;
+}
+
+// Insert an element; false on allocation failure
+// 插入元素，分配失败返回false
+static inline bool mmh_push(MinMaxHeap *h, int value) {
+    if (h->count == h->capacity) {
+        int new_capacity = h->capacity == 0 ? 16 : h->capacity * 2;
+        if (!mmh_reserve(h, new_capacity)) return false;
+    }
+    h->heap[h->count] = value;
+    mmh_bubble_up(h, h->count++);
+    return true;
+}
+
+// Index of the maximum element (count must be > 0)
+// 最大元素的索引（要求count > 0）
+static inline int mmh_max_index(const MinMaxHeap *h) {
+    if (h->count == 1) return 0;
+    if (h->count == 2) return 1;
+    return h->heap[1] >= h->heap[2] ? 1 : 2;
+}
+
+// Get the minimum; false if empty
+// 获取最小值，空堆返回false
+static inline bool mmh_front(const MinMaxHeap *h, int *out) {
+    if (h->count == 0) return false;
+    *out = h->heap[0];
+    return true;
+}
+
+// Get the maximum in O(1); false if empty
+// O(1)获取最大值，空堆返回false
+static inline bool mmh_back(const MinMaxHeap *h, int *out) {
+    if (h->count == 0) return false;
+    *out = h->heap[mmh_max_index(h)];
+    return true;
+}
+
+// Remove the element at index i (i must be 0 or a max-index child)
+// 删除索引i处的元素
+static inline void mmh_remove_at(MinMaxHeap *h, int i) {
+    h->count--;
+    if (i == h->count) return;
+    h->heap[i] = h->heap[h->count];
+    mmh_trickle_down(h, i);
+}
+
+// Remove and return the minimum; false if empty (out may be NULL)
+// 弹出最小值，空堆返回false（out可为NULL）
+static inline bool mmh_pop_min(MinMaxHeap *h, int *out) {
+    if (h->count == 0) return false;
+    if (out) *out = h->heap[0];
+    mmh_remove_at(h, 0);
+    return true;
+}
+
+// Remove and return the maximum; false if empty (out may be NULL)
+// 弹出最大值，空堆返回false（out可为NULL）
+static inline bool mmh_pop_max(MinMaxHeap *h, int *out) {
+    if (h->count == 0) return false;
+    int i = mmh_max_index(h);
+    if (out) *out = h->heap[i];
+    mmh_remove_at(h, i);
+    return true;
+}
+
+// Bounded insert keeping at most `limit` smallest elements. When full, the
+// value replaces the current maximum if it is smaller, otherwise it is
+// rejected. `dropped` (may be NULL) receives the element that left the heap.
+// 有界插入：最多保留limit个最小元素。已满时，若新值小于当前最大值则替换之，
+// 否则拒绝插入。dropped（可为NULL）接收被移出的元素。
+static inline MmhBoundedResult mmh_push_bounded(MinMaxHeap *h, int value, int limit, int *dropped) {
+    if (limit <= 0) {
+        if (dropped) *dropped = value;
+        return MMH_REJECTED;
+    }
+    if (h->count < limit) {
+        return mmh_push(h, value) ? MMH_INSERTED : MMH_NO_MEMORY;
+    }
+    int i = mmh_max_index(h);
+    if (!(value < h->heap[i])) {
+        if (dropped) *dropped = value;
+        return MMH_REJECTED;
+    }
+    if (dropped) *dropped = h->heap[i];
+    // Overwrite the maximum in place, then restore both orders
+    // 原地覆盖最大值，再恢复堆序
+    h->heap[i] = value;
+    if (i > 0 && value < h->heap[0]) {
+        mmh_swap(&h->heap[i], &h->heap[0]);
+    }
+    mmh_trickle_down(h, i);
+    return MMH_REPLACED;
+}
+
+// Remove all elements, keeping capacity
+// 清空堆，保留容量
+static inline void mmh_clear(MinMaxHeap *h) {
+    h->count = 0;
+}
+
+#endif // MINMAX_HEAP_H
@@ -0,0 +1,300 @@
+/**
+ * @file multi_queue.h
+ * @brief A relaxed concurrent priority queue (MultiQueue) for parallel schedulers
+ *
+ * A MultiQueue spreads its elements over c * p ordinary binary heaps (p = number
+ * of threads, c = a small constant such as 2 or 4), each protected by its own
+ * try-lock. A push locks a random heap and inserts there. A pop looks at the
+ * cached minimum keys of two random heaps and removes the smaller one; if the
+ * chosen heap is locked by another thread it simply picks two new heaps. No
+ * operation ever waits for a lock, and with c * p heaps two threads rarely
+ * touch the same one.
+ *
+ * The price is relaxed ordering: a pop returns an element close to, but not
+ * necessarily equal to, the global minimum. With the two-choice rule the
+ * expected rank of a popped element among all queued elements is O(c * p)
+ * and the worst case is O(c * p * log(c * p)) with high probability
+ * (Rihani, Sanders, Dementiev, SPAA 2015; Alistarh et al., PODC 2017). These
+ * are the guarantees parallel best-first search and priority scheduling need:
+ * work is done in roughly priority order, and a constant number of extra,
+ * slightly-too-early elements is tolerated.
+ *
+ * The heaps come from KEYED_PQ_DEFINE in keyed_priority_queue.h, keyed by
+ * uint64_t (smaller = higher priority) with a void* payload.
+ *
+ * Requires C11 <stdatomic.h>.
+ */
+
+ #ifndef MULTI_QUEUE_H
+ #define MULTI_QUEUE_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <stdatomic.h>
+ #include "keyed_priority_queue.h"
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Cache line size used to keep heaps apart
+ #define MULTI_QUEUE_CACHE_LINE 64
+ /// Default number of heaps per thread (the constant c)
+ #define MULTI_QUEUE_DEFAULT_FACTOR 2
+ /// Cached top key of an empty heap
+ #define MQ_EMPTY_KEY UINT64_MAX
+
+ KEYED_PQ_DEFINE(MultiQueueHeap, uint64_t, void*, KEYED_PQ_LESS)
+
+ /**
+  * @brief One internal heap with its try-lock
+  *
+  * @c top_key and @c size mirror the heap and are read without the lock to
+  * steer pops; they are only hints and are re-checked under the lock.
+  */
+ typedef struct {
+     _Alignas(MULTI_QUEUE_CACHE_LINE) _Atomic bool locked; ///< Try-lock flag
+     _Atomic uint64_t top_key;    ///< Minimum key, MQ_EMPTY_KEY when empty
+     _Atomic size_t size;         ///< Number of elements in the heap
+     MultiQueueHeap heap;         ///< The heap itself, guarded by @c locked
+ } MultiQueueShard;
+
+ /**
+  * @brief MultiQueue structure
+  */
+ typedef struct {
+     MultiQueueShard* shards;     ///< c * p heaps, each on its own cache line
+     uint32_t num_shards;         ///< Number of heaps (at least 2)
+ } MultiQueue;
+
+ /**
+  * @brief Per-thread handle holding the random state
+  *
+  * A handle must be used by one thread at a time.
+  */
+ typedef struct {
+     MultiQueue* mq;              ///< Queue the handle operates on
+     uint32_t seed;               ///< Random state for heap choice
+ } MultiQueueHandle;
+
+ /* ====================== Internal Helpers ====================== */
+
+ static inline void mq_cpu_relax(void) {
+ #if defined(__x86_64__) || defined(__i386__)
+     __asm__ __volatile__("pause");
+ #elif defined(__aarch64__)
+     __asm__ __volatile__("yield");
+ #endif
+ }
+
+ static inline uint32_t mq_next_random(uint32_t* seed) {
+     uint32_t x = *seed;
+     x ^= x << 13;
+     x ^= x >> 17;
+     x ^= x << 5;
+     *seed = x ? x : 0x9E3779B9u;
+     return x;
+ }
+
+ /// Uniform index in [0, n) without a division
+ static inline uint32_t mq_random_index(uint32_t* seed, uint32_t n) {
+     return (uint32_t)(((uint64_t)mq_next_random(seed) * n) >> 32);
+ }
+
+ static inline bool mq_try_lock(MultiQueueShard* q) {
+     return !atomic_load_explicit(&q->locked, memory_order_relaxed) &&
+            !atomic_exchange_explicit(&q->locked, true, memory_order_acquire);
+ }
+
+ static inline void mq_lock(MultiQueueShard* q) {
+     while (!mq_try_lock(q)) mq_cpu_relax();
+ }
+
+ /**
+  * @brief Internal: republishes the hints of a locked heap, then unlocks it
+  */
+ static inline void mq_unlock(MultiQueueShard* q) {
+     const MultiQueueHeap_entry* top = MultiQueueHeap_top(&q->heap);
+     atomic_store_explicit(&q->top_key, top ? top->key : MQ_EMPTY_KEY, memory_order_relaxed);
+     atomic_store_explicit(&q->size, MultiQueueHeap_size(&q->heap), memory_order_relaxed);
+     atomic_store_explicit(&q->locked, false, memory_order_release);
+ }
+
+ /* ====================== Public API ====================== */
+
+ /**
+  * @brief Creates an empty MultiQueue
+  *
+  * @param num_threads Number of threads that will use the queue (p)
+  * @param factor Heaps per thread (c); 0 selects MULTI_QUEUE_DEFAULT_FACTOR
+  * @return MultiQueue* Pointer to the queue, or NULL on failure
+  */
+ static inline MultiQueue* multi_queue_create(uint32_t num_threads, uint32_t factor) {
+     if (num_threads == 0) num_threads = 1;
+     if (factor == 0) factor = MULTI_QUEUE_DEFAULT_FACTOR;
+     uint64_t n = (uint64_t)num_threads * factor;
+     if (n < 2) n = 2;
+     if (n > UINT32_MAX / sizeof(MultiQueueShard)) return NULL;
+
+     MultiQueue* mq = (MultiQueue*)malloc(sizeof(MultiQueue));
+     if (!mq) return NULL;
+     mq->shards = (MultiQueueShard*)aligned_alloc(MULTI_QUEUE_CACHE_LINE, (size_t)n * sizeof(MultiQueueShard));
+     if (!mq->shards) {
+         free(mq);
+         return NULL;
+     }
+     mq->num_shards = (uint32_t)n;
+     for (uint32_t i = 0; i < mq->num_shards; i++) {
+         MultiQueueShard* q = &mq->shards[i];
+         atomic_init(&q->locked, false);
+         atomic_init(&q->top_key, MQ_EMPTY_KEY);
+         atomic_init(&q->size, 0);
+         MultiQueueHeap_init(&q->heap, 0);
+     }
+     return mq;
+ }
+
+ /**
+  * @brief Frees the queue (not the payload pointers)
+  *
+  * @param mq Pointer to the queue (may be NULL); no thread may still use it
+  */
+ static inline void multi_queue_free(MultiQueue* mq) {
+     if (!mq) return;
+     for (uint32_t i = 0; i < mq->num_shards; i++) {
+         MultiQueueHeap_destroy(&mq->shards[i].heap);
+     }
+     free(mq->shards);
+     free(mq);
+ }
+
+ /**
+  * @brief Initializes a per-thread handle
+  *
+  * @param h Handle to initialize
+  * @param mq Queue the handle will operate on
+  * @param seed Any value distinct per thread
+  */
+ static inline void multi_queue_handle_init(MultiQueueHandle* h, MultiQueue* mq, uint32_t seed) {
+     h->mq = mq;
+     h->seed = seed * 2654435761u + 1u;
+     if (h->seed == 0) h->seed = 0x9E3779B9u;
+ }
+
+ /**
+  * @brief Inserts an element into a random heap
+  *
+  * @param h Calling thread's handle
+  * @param key Priority (smaller = popped earlier)
+  * @param payload Pointer stored with the key
+  * @return true on success, false if the heap could not grow
+  */
+ static inline bool multi_queue_push(MultiQueueHandle* h, uint64_t key, void* payload) {
+     MultiQueue* mq = h->mq;
+     MultiQueueShard* q;
+     do {
+         q = &mq->shards[mq_random_index(&h->seed, mq->num_shards)];
+     } while (!mq_try_lock(q));
+     bool ok = MultiQueueHeap_push(&q->heap, key, payload);
+     mq_unlock(q);
+     return ok;
+ }
+
+ /**
+  * @brief Removes an element whose key is close to the minimum
+  *
+  * Picks two random heaps, locks the one with the smaller cached top key and
+  * pops from it. After num_shards consecutive picks that only found empty
+  * heaps, every heap is scanned once; if all are empty, false is returned.
+  *
+  * @param h Calling thread's handle
+  * @param key Receives the key (may be NULL)
+  * @param payload Receives the payload (may be NULL)
+  * @return true on success, false if the queue was observed empty
+  */
+ static inline bool multi_queue_pop(MultiQueueHandle* h, uint64_t* key, void** payload) {
+     MultiQueue* mq = h->mq;
+     uint32_t n = mq->num_shards;
+     uint32_t empty_picks = 0;
+     for (;;) {
+         uint32_t i = mq_random_index(&h->seed, n);
+         uint32_t j = mq_random_index(&h->seed, n - 1);
+         if (j >= i) j++;
+         MultiQueueShard* a = &mq->shards[i];
+         MultiQueueShard* b = &mq->shards[j];
+         size_t size_a = atomic_load_explicit(&a->size, memory_order_relaxed);
+         size_t size_b = atomic_load_explicit(&b->size, memory_order_relaxed);
+         MultiQueueShard* q;
+         if (size_a == 0 && size_b == 0) {
+             if (++empty_picks < n) continue;
+             // Looks empty: scan every heap once, starting at a random one
+             uint32_t start = i;
+             q = NULL;
+             for (uint32_t k = 0; k < n; k++) {
+                 MultiQueueShard* c = &mq->shards[(start + k) % n];
+                 if (atomic_load_explicit(&c->size, memory_order_relaxed) > 0) {
+                     q = c;
+                     break;
+                 }
+             }
+             if (!q) return false;
+             empty_picks = 0;
+             mq_lock(q);
+         } else {
+             if (size_a == 0) {
+                 q = b;
+             } else if (size_b == 0) {
+                 q = a;
+             } else {
+                 uint64_t ka = atomic_load_explicit(&a->top_key, memory_order_relaxed);
+                 uint64_t kb = atomic_load_explicit(&b->top_key, memory_order_relaxed);
+                 q = ka <= kb ? a : b;
+             }
+             if (!mq_try_lock(q)) continue;
+         }
+         bool ok = MultiQueueHeap_pop(&q->heap, key, payload);
+         mq_unlock(q);
+         if (ok) return true;
+     }
+ }
+
+ /**
+  * @brief Returns the number of elements
+  *
+  * @param mq Pointer to the queue
+  * @return size_t Exact when no other thread is operating, approximate otherwise
+  */
+ static inline size_t multi_queue_size(MultiQueue* mq) {
+     size_t total = 0;
+     for (uint32_t i = 0; i < mq->num_shards; i++) {
+         total += atomic_load_explicit(&mq->shards[i].size, memory_order_relaxed);
+     }
+     return total;
+ }
+
+ /**
+  * @brief Checks if the queue is empty
+  *
+  * @param mq Pointer to the queue
+  * @return true if every heap was empty when it was looked at
+  */
+ static inline bool multi_queue_isEmpty(MultiQueue* mq) {
+     return multi_queue_size(mq) == 0;
+ }
+
+ /**
+  * @brief Returns the number of internal heaps (c * p)
+  *
+  * @param mq Pointer to the queue
+  * @return uint32_t Number of heaps
+  */
+ static inline uint32_t multi_queue_num_heaps(const MultiQueue* mq) {
+     return mq->num_shards;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // MULTI_QUEUE_H
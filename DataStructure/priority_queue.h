@@ -4,67 +4,194 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdbool.h>
 #include <limits.h>
 
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// Alignment of the heap array; child groups never straddle a cache line
+// 堆数组的对齐字节数；子节点组不会跨越缓存行
+#define PQ_CACHE_LINE 64
+// Largest supported arity (支持的最大分支数)
+#define PQ_MAX_ARITY 16
+// Capacity of the first allocation and floor for automatic shrinking
+// 首次分配的容量，也是自动缩容的下限
+#define PQ_MIN_CAPACITY 16
+
 // Priority Queue structure (Min-Heap implementation)
 // 优先队列结构（最小堆实现）
+//
+// The heap is d-ary (d = arity, 2 by default). Heap position p (root = 0)
+// is stored at heap[p + d - 1]; its children are positions p*d+1 .. p*d+d,
+// which occupy heap[d*(p+1)] .. heap[d*(p+1) + d - 1]. Because the array is
+// cache-line aligned, every child group starts on a multiple of d ints, so
+// the children of a node are read from a single cache line.
+// For d = 2 this is exactly the classic layout: root at heap[1], children of
+// heap[k] at heap[2k] and heap[2k+1].
+// 堆为d叉堆（d = arity，默认为2）。堆位置p（根为0）存放在 heap[p + d - 1]，
+// 其子节点为位置 p*d+1 .. p*d+d，即 heap[d*(p+1)] 起的连续d个元素。数组按缓存
+// 行对齐，每组子节点都从d的整数倍处开始，因此一个节点的所有子节点位于同一缓存行。
+// 当d = 2时即经典布局：根在heap[1]，heap[k]的子节点为heap[2k]和heap[2k+1]。
 typedef struct {
-    int *heap;          // Heap array starting from index 1 (堆数组，从索引1开始)
+    int *heap;          // Heap array, root at heap[arity - 1] (堆数组，根位于heap[arity - 1])
     int capacity;       // Current allocated capacity (当前分配的容量)
     int count;          // Current number of elements (当前元素数量)
+    int arity;          // Children per node: 2, 4, 8 or 16 (每个节点的子节点数)
+    int min_capacity;   // pq_pop never shrinks below this (pq_pop缩容的下限)
+    bool shrink;        // Whether pq_pop may shrink the buffer (pq_pop是否可以缩容)
 } PriorityQueue;
 
-// Create an empty priority queue with initial capacity 0
-// 创建一个空的优先队列，初始容量为0
-PriorityQueue* pq_create() {
+// Create an empty d-ary priority queue; arity must be 2, 4, 8 or 16
+// 创建一个空的d叉优先队列，arity必须为2、4、8或16
+PriorityQueue* pq_create_with_arity(int arity) {
+    if (arity != 2 && arity != 4 && arity != 8 && arity != 16) {
+        fprintf(stderr, "Unsupported priority queue arity %d!\n", arity);
+        return NULL;
+    }
     PriorityQueue *pq = (PriorityQueue*)malloc(sizeof(PriorityQueue));
+    if (!pq) return NULL;
     pq->heap = NULL;
     pq->capacity = 0;
     pq->count = 0;
+    pq->arity = arity;
+    pq->min_capacity = PQ_MIN_CAPACITY;
+    pq->shrink = true;
     return pq;
 }
 
+// Create an empty priority queue with initial capacity 0
+// 创建一个空的优先队列，初始容量为0
+PriorityQueue* pq_create() {
+    return pq_create_with_arity(2);
+}
+
+// Free the aligned heap array
+// 释放对齐的堆数组
+static void pq_heap_release(int *heap) {
+#if defined(_MSC_VER)
+    _aligned_free(heap);
+#else
+    free(heap);
+#endif
+}
+
 // Free the memory used by the priority queue
 // 释放优先队列使用的内存
 void pq_free(PriorityQueue *pq) {
-    free(pq->heap);
+    pq_heap_release(pq->heap);
     free(pq);
 }
 
-// Swap two elements
-// 交换两个元素
-static void pq_swap(int *a, int *b) {
-    int temp = *a;
-    *a = *b;
-    *b = temp;
+// Reallocate the heap array to hold new_capacity elements, keeping alignment
+// 重新分配堆数组以容纳new_capacity个元素，并保持对齐
+static bool pq_resize(PriorityQueue *pq, int new_capacity) {
+    if (new_capacity == 0) {
+        pq_heap_release(pq->heap);
+        pq->heap = NULL;
+        pq->capacity = 0;
+        return true;
+    }
+    // Slots before the root plus one full trailing child group, rounded to the cache line
+    // 根之前的空位加上完整的最后一组子节点，并按缓存行取整
+    size_t slots = (size_t)new_capacity + 2 * (size_t)pq->arity;
+    size_t bytes = (slots * sizeof(int) + PQ_CACHE_LINE - 1) & ~(size_t)(PQ_CACHE_LINE - 1);
+#if defined(_MSC_VER)
+    int *new_heap = (int*)_aligned_malloc(bytes, PQ_CACHE_LINE);
+#else
+    int *new_heap = (int*)aligned_alloc(PQ_CACHE_LINE, bytes);
+#endif
+    if (!new_heap) return false;
+    if (pq->heap) {
+        memcpy(new_heap, pq->heap, ((size_t)pq->count + pq->arity) * sizeof(int));
+        pq_heap_release(pq->heap);
+    }
+    pq->heap = new_heap;
+    pq->capacity = new_capacity;
+    return true;
+}
+
+// Index of the smallest of d consecutive, group-aligned children
+// 在d个连续且按组对齐的子节点中找到最小值的下标
+static inline int pq_min_child(const int *c, int d) {
+#if defined(__AVX2__)
+    if (d >= 8) {
+        __m256i m = _mm256_load_si256((const __m256i*)c);
+        if (d == 16) m = _mm256_min_epi32(m, _mm256_load_si256((const __m256i*)(c + 8)));
+        // Horizontal minimum (水平方向求最小值)
+        __m256i t = _mm256_min_epi32(m, _mm256_permute2x128_si256(m, m, 1));
+        t = _mm256_min_epi32(t, _mm256_shuffle_epi32(t, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = _mm256_min_epi32(t, _mm256_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        __m256i lo = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i*)c), t);
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(lo));
+        if (d == 16) {
+            __m256i hi = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i*)(c + 8)), t);
+            mask |= (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(hi)) << 8;
+        }
+        return __builtin_ctz(mask);
+    }
+#endif
+#if defined(__SSE4_1__)
+    if (d == 4) {
+        __m128i v = _mm_load_si128((const __m128i*)c);
+        __m128i t = _mm_min_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = _mm_min_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(v, t)));
+        return __builtin_ctz(mask);
+    }
+#endif
+    int best = 0;
+    for (int i = 1; i < d; i++) {
+        if (c[i] < c[best]) best = i;
+    }
+    return best;
 }
 
 // Swim (heapify up) operation to maintain heap property
 // 上浮操作（堆化向上）以维护堆性质
+// The moving value is held aside and written once at its final slot.
+// 移动的值暂存在局部变量中，只在最终位置写入一次。
 static void pq_swim(PriorityQueue *pq, int k) {
-    while (k > 1 && pq->heap[k/2] > pq->heap[k]) {
-        pq_swap(&pq->heap[k/2], &pq->heap[k]);
-        k /= 2;
+    int d = pq->arity;
+    int root = d - 1;
+    int value = pq->heap[k];
+    while (k > root) {
+        int parent = (k - root - 1) / d + root;
+        if (pq->heap[parent] <= value) break;
+        pq->heap[k] = pq->heap[parent];
+        k = parent;
     }
+    pq->heap[k] = value;
 }
 
 // Sink (heapify down) operation to maintain heap property
 // 下沉操作（堆化向下）以维护堆性质
 static void pq_sink(PriorityQueue *pq, int k) {
-    while (2*k <= pq->count) {
-        int j = 2*k;
-        // Choose the smaller child (选择较小的子节点)
-        if (j < pq->count && pq->heap[j] > pq->heap[j+1]) {
-            j++;
+    int d = pq->arity;
+    int root = d - 1;
+    int last = pq->count + root - 1;      // Array index of the last element (最后一个元素的下标)
+    int value = pq->heap[k];
+    for (;;) {
+        int first = d * (k - root + 1);   // First child (第一个子节点)
+        if (first > last) break;
+        int j;
+        if (first + d - 1 <= last) {
+            j = first + pq_min_child(&pq->heap[first], d);
+        } else {
+            // Partial last group (最后一组子节点不完整)
+            j = first;
+            for (int c = first + 1; c <= last; c++) {
+                if (pq->heap[c] < pq->heap[j]) j = c;
+            }
         }
         // Stop if heap property is satisfied (如果堆性质已满足则停止)
-        if (pq->heap[k] <= pq->heap[j]) {
-            break;
-        }
-        pq_swap(&pq->heap[k], &pq->heap[j]);
+        if (value <= pq->heap[j]) break;
+        pq->heap[k] = pq->heap[j];
         k = j;
     }
+    pq->heap[k] = value;
 }
 
 // Check if the priority queue is empty
@@ -78,19 +205,18 @@ bool pq_empty(PriorityQueue *pq) {
 void pq_push(PriorityQueue *pq, int value) {
     // Check if resizing is needed (检查是否需要扩容)
     if (pq->count == pq->capacity) {
-        int new_capacity = pq->capacity == 0 ? 1 : pq->capacity * 2;
-        int *new_heap = (int*)realloc(pq->heap, (new_capacity + 1) * sizeof(int));
-        if (!new_heap) {
+        int new_capacity = pq->capacity == 0 ? PQ_MIN_CAPACITY : pq->capacity * 2;
+        if (!pq_resize(pq, new_capacity)) {
             fprintf(stderr, "Memory allocation failed!\n");
             return;
         }
-        pq->heap = new_heap;
-        pq->capacity = new_capacity;
     }
     // Add the new element and perform swim operation
     // 添加新元素并执行上浮操作
-    pq->heap[++pq->count] = value;
-    pq_swim(pq, pq->count);
+    int k = pq->count + pq->arity - 1;
+    pq->count++;
+    pq->heap[k] = value;
+    pq_swim(pq, k);
 }
 
 // Get the front element (minimum value)
@@ -100,7 +226,7 @@ int pq_front(PriorityQueue *pq) {
         fprintf(stderr, "Priority queue is empty!\n");
         return INT_MAX;
     }
-    return pq->heap[1];
+    return pq->heap[pq->arity - 1];
 }
 
 // Get the back element (maximum value in a min-heap)
@@ -110,14 +236,16 @@ int pq_back(PriorityQueue *pq) {
         fprintf(stderr, "Priority queue is empty!\n");
         return INT_MIN;
     }
+    int root = pq->arity - 1;
     if (pq->count == 1) {
-        return pq->heap[1];
+        return pq->heap[root];
     }
     // The maximum value must be in the leaf nodes
     // 最大值一定在叶子节点中
-    int first_leaf = (pq->count / 2) + 1;
+    int first_leaf = (pq->count - 2) / pq->arity + 1 + root;
+    int last = pq->count + root - 1;
     int max_val = INT_MIN;
-    for (int i = first_leaf; i <= pq->count; i++) {
+    for (int i = first_leaf; i <= last; i++) {
         if (pq->heap[i] > max_val) {
             max_val = pq->heap[i];
         }
@@ -132,20 +260,25 @@ int pq_pop(PriorityQueue *pq) {
         fprintf(stderr, "Priority queue is empty!\n");
         return INT_MAX;
     }
-    int min = pq->heap[1];
+    int root = pq->arity - 1;
+    int min = pq->heap[root];
     // Move the last element to the root and sink it
     // 将最后一个元素移到根节点并执行下沉操作
-    pq_swap(&pq->heap[1], &pq->heap[pq->count--]);
-    pq_sink(pq, 1);
+    pq->heap[root] = pq->heap[pq->count + root - 1];
+    pq->count--;
+    if (pq->count > 0) {
+        pq_sink(pq, root);
+    }
 
     // Check if shrinking is needed (检查是否需要缩容)
-    if (pq->capacity > 0 && pq->count <= pq->capacity / 4) {
-        int new_capacity = pq->capacity / 2;
-        int *new_heap = (int*)realloc(pq->heap, (new_capacity + 1) * sizeof(int));
-        if (new_heap || new_capacity == 0) {
-            pq->heap = new_heap;
-            pq->capacity = new_capacity;
-        }
+    // Shrink to half at 1/4 occupancy: after shrinking the buffer is at most
+    // half full, so it takes capacity/4 pushes to grow again and the count
+    // has to halve once more to shrink again. Never shrink below
+    // min_capacity, which pq_reserve raises.
+    // 占用率降到1/4时缩容一半：缩容后缓冲区至多半满，需再插入capacity/4个元素
+    // 才会扩容，元素数需再减半才会再次缩容。容量不会低于min_capacity（由pq_reserve设定）。
+    if (pq->shrink && pq->count <= pq->capacity / 4 && pq->capacity / 2 >= pq->min_capacity) {
+        pq_resize(pq, pq->capacity / 2);
     }
     return min;
 }
@@ -156,4 +289,70 @@ int pq_size(PriorityQueue *pq) {
     return pq->count;
 }
 
+// Ensure room for at least `capacity` elements; pq_pop will not shrink below it
+// 预留至少capacity个元素的空间；pq_pop不会缩容到该值以下
+bool pq_reserve(PriorityQueue *pq, int capacity) {
+    if (capacity < 0) return false;
+    if (capacity > pq->min_capacity) pq->min_capacity = capacity;
+    if (capacity <= pq->capacity) return true;
+    return pq_resize(pq, capacity);
+}
+
+// Enable or disable automatic shrinking in pq_pop
+// 启用或禁用pq_pop中的自动缩容
+void pq_set_shrink(PriorityQueue *pq, bool enabled) {
+    pq->shrink = enabled;
+}
+
+// Restore the heap property over the whole array bottom-up (Floyd), O(n)
+// 自底向上对整个数组建堆（Floyd算法），O(n)
+static void pq_heapify(PriorityQueue *pq) {
+    if (pq->count < 2) return;
+    int root = pq->arity - 1;
+    int last_internal = (pq->count - 2) / pq->arity + root;
+    for (int k = last_internal; k >= root; k--) {
+        pq_sink(pq, k);
+    }
+}
+
+// Insert n elements at once; false on allocation failure (queue unchanged)
+// 一次插入n个元素；分配失败返回false（队列保持不变）
+bool pq_push_batch(PriorityQueue *pq, const int *values, int n) {
+    if (n <= 0) return n == 0;
+    if (n > INT_MAX - pq->count) return false;
+    int needed = pq->count + n;
+    if (needed > pq->capacity) {
+        int new_capacity = pq->capacity == 0 ? PQ_MIN_CAPACITY : pq->capacity;
+        while (new_capacity < needed) {
+            new_capacity = new_capacity > INT_MAX / 2 ? needed : new_capacity * 2;
+        }
+        if (!pq_resize(pq, new_capacity)) return false;
+    }
+    int root = pq->arity - 1;
+    int old_count = pq->count;
+    memcpy(&pq->heap[old_count + root], values, (size_t)n * sizeof(int));
+    pq->count = needed;
+    if (n >= old_count) {
+        // Large batch: rebuilding is O(count + n) (批量较大时整体重建堆)
+        pq_heapify(pq);
+    } else {
+        for (int k = old_count + root; k < needed + root; k++) {
+            pq_swim(pq, k);
+        }
+    }
+    return true;
+}
+
+// Build a binary priority queue from n values in O(n); NULL on failure
+// 以O(n)时间从n个值构建二叉优先队列，失败返回NULL
+PriorityQueue* pq_create_from_array(const int *values, int n) {
+    PriorityQueue *pq = pq_create_with_arity(2);
+    if (!pq) return NULL;
+    if (n > 0 && !pq_push_batch(pq, values, n)) {
+        pq_free(pq);
+        return NULL;
+    }
+    return pq;
+}
+
 #endif // PRIORITY_QUEUE_H
@@ -0,0 +1,174 @@
+// radix_heap.h
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Radix heap for monotone unsigned integer keys
+// 单调无符号整数键的基数堆
+//
+// Valid when keys are never smaller than the last popped key, as in Dijkstra
+// with non-negative weights or a timer queue. Bucket 0 holds keys equal to the
+// last popped key; bucket i (1..32) holds keys whose highest bit differing
+// from it is bit i-1. Push is O(1); pop empties the lowest non-empty bucket
+// and redistributes it into lower buckets, and since an element only ever
+// moves down, pop costs O(log C) amortized, where C is the key range.
+// (Ahuja, Mehlhorn, Orlin, Tarjan, JACM 1990)
+// 适用于键永远不小于上次弹出键的场景，例如非负权Dijkstra或定时器队列。
+// 0号桶存放等于上次弹出键的元素；i号桶（1..32）存放与其最高不同位为第i-1位
+// 的元素。插入为O(1)；弹出时清空最低的非空桶并重新分配到更低的桶中，由于元素
+// 只会向下移动，弹出的均摊代价为O(log C)，C为键的范围。
+
+#define RADIX_HEAP_BUCKETS 33
+
+// Heap item: key and caller payload (堆元素：键与用户数据)
+typedef struct {
+    uint32_t key;
+    int value;
+} RadixHeapItem;
+
+typedef struct {
+    RadixHeapItem *items;
+    int count;
+    int capacity;
+} RadixHeapBucket;
+
+// Radix heap structure
+// 基数堆结构
+typedef struct {
+    RadixHeapBucket buckets[RADIX_HEAP_BUCKETS];
+    uint32_t last;      // Last popped key, lower bound of all keys (上次弹出的键，所有键的下界)
+    int count;          // Current number of elements (当前元素数量)
+} RadixHeap;
+
+// Create an empty heap; NULL on failure
+// 创建空堆，失败返回NULL
+static inline RadixHeap* rh_create(void) {
+    RadixHeap *h = (RadixHeap*)calloc(1, sizeof(RadixHeap));
+    return h;
+}
+
+// Free the memory used by the heap
+// 释放堆使用的内存
+static inline void rh_free(RadixHeap *h) {
+    if (!h) return;
+    for (int i = 0; i < RADIX_HEAP_BUCKETS; i++) free(h->buckets[i].items);
+    free(h);
+}
+
+static inline bool rh_empty(const RadixHeap *h) {
+    return h->count == 0;
+}
+
+static inline int rh_size(const RadixHeap *h) {
+    return h->count;
+}
+
+// Smallest key that may still be pushed (当前允许插入的最小键)
+static inline uint32_t rh_last_key(const RadixHeap *h) {
+    return h->last;
+}
+
+// Bucket index of key relative to the last popped key
+// 键相对于上次弹出键所在的桶编号
+static inline int rh_bucket_of(uint32_t key, uint32_t last) {
+    uint32_t diff = key ^ last;
+    if (diff == 0) return 0;
+#if defined(__GNUC__)
+    return 32 - __builtin_clz(diff);
+#else
+    int b = 0;
+    while (diff) { diff >>= 1; b++; }
+    return b;
+#endif
+}
+
+static inline bool rh_bucket_reserve(RadixHeapBucket *b, int capacity) {
+    if (capacity <= b->capacity) return true;
+    int new_capacity = b->capacity == 0 ? 16 : b->capacity;
+    while (new_capacity < capacity) new_capacity *= 2;
+    RadixHeapItem *new_items = (RadixHeapItem*)realloc(b->items, (size_t)new_capacity * sizeof(RadixHeapItem));
+    if (!new_items) return false;
+    b->items = new_items;
+    b->capacity = new_capacity;
+    return true;
+}
+
+// Insert a key/value pair in O(1). Returns false if key is smaller than
+// the last popped key (monotonicity violated) or allocation fails.
+// O(1)插入键值对。键小于上次弹出的键（违反单调性）或分配失败时返回false。
+static inline bool rh_push(RadixHeap *h, uint32_t key, int value) {
+    if (key < h->last) return false;
+    RadixHeapBucket *b = &h->buckets[rh_bucket_of(key, h->last)];
+    if (!rh_bucket_reserve(b, b->count + 1)) return false;
+    b->items[b->count].key = key;
+    b->items[b->count].value = value;
+    b->count++;
+    h->count++;
+    return true;
+}
+
+// Make bucket 0 non-empty by redistributing the lowest non-empty bucket.
+// Space is reserved before anything moves, so on allocation failure the
+// heap is left unchanged and false is returned.
+// 重新分配最低的非空桶，使0号桶非空。移动前先预留空间，分配失败时堆保持
+// 不变并返回false。
+static inline bool rh_refill(RadixHeap *h) {
+    if (h->buckets[0].count > 0) return true;
+    int i = 1;
+    while (h->buckets[i].count == 0) i++;
+    RadixHeapBucket *b = &h->buckets[i];
+    uint32_t new_last = b->items[0].key;
+    for (int j = 1; j < b->count; j++) {
+        if (b->items[j].key < new_last) new_last = b->items[j].key;
+    }
+    // Every item moves to a bucket below i (每个元素都会移到低于i的桶)
+    int incoming[RADIX_HEAP_BUCKETS] = { 0 };
+    for (int j = 0; j < b->count; j++) {
+        incoming[rh_bucket_of(b->items[j].key, new_last)]++;
+    }
+    for (int k = 0; k < i; k++) {
+        if (incoming[k] > 0 && !rh_bucket_reserve(&h->buckets[k], h->buckets[k].count + incoming[k])) {
+            return false;
+        }
+    }
+    h->last = new_last;
+    for (int j = 0; j < b->count; j++) {
+        RadixHeapBucket *dst = &h->buckets[rh_bucket_of(b->items[j].key, new_last)];
+        dst->items[dst->count++] = b->items[j];
+    }
+    b->count = 0;
+    return true;
+}
+
+// Peek at the minimum; false if empty (outputs may be NULL)
+// 查看最小元素；空堆返回false（输出参数可为NULL）
+static inline bool rh_top(RadixHeap *h, uint32_t *key, int *value) {
+    if (h->count == 0) return false;
+    if (!rh_refill(h)) return false;
+    RadixHeapItem *item = &h->buckets[0].items[h->buckets[0].count - 1];
+    if (key) *key = item->key;
+    if (value) *value = item->value;
+    return true;
+}
+
+// Remove the minimum, O(log C) amortized; false if empty (outputs may be NULL)
+// 弹出最小元素，均摊O(log C)；空堆返回false（输出参数可为NULL）
+static inline bool rh_pop(RadixHeap *h, uint32_t *key, int *value) {
+    if (!rh_top(h, key, value)) return false;
+    h->buckets[0].count--;
+    h->count--;
+    return true;
+}
+
+// Remove all elements and reset the key lower bound to 0, keeping memory
+// 清空堆并将键下界重置为0，保留已分配内存
+static inline void rh_clear(RadixHeap *h) {
+    for (int i = 0; i < RADIX_HEAP_BUCKETS; i++) h->buckets[i].count = 0;
+    h->last = 0;
+    h->count = 0;
+}
+
+#endif // RADIX_HEAP_H
@@ -0,0 +1,404 @@
+/**
+ * @file task_scheduler.h
+ * @brief Work-stealing task scheduler with spawn/sync primitives
+ *
+ * A fixed pool of worker threads, each owning a Chase-Lev deque from
+ * work_stealing_deque.h. A task spawned from inside a worker goes to the
+ * bottom of that worker's deque (LIFO, cache-warm); idle workers steal from
+ * the top of a random victim's deque (FIFO, oldest and usually largest
+ * work). Tasks spawned from outside the pool go through a small shared
+ * injection queue.
+ *
+ * Completion is tracked per TaskGroup: task_sync() does not block while
+ * work remains, it runs queued or stolen tasks until the group's pending
+ * count drops to zero, so recursive divide-and-conquer code can spawn and
+ * sync at every level without deadlocking the pool.
+ *
+ * Requires C11 <stdatomic.h> and POSIX threads.
+ */
+
+ #ifndef TASK_SCHEDULER_H
+ #define TASK_SCHEDULER_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <stdatomic.h>
+ #include <pthread.h>
+ #include <sched.h>
+ #include <unistd.h>
+
+ #include "work_stealing_deque.h"
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Failed find-work rounds before an idle worker goes to sleep
+ #define TASK_SCHEDULER_IDLE_SPINS 64
+ /// Recycled task objects kept per worker
+ #define TASK_SCHEDULER_FREE_TASKS 256
+
+ typedef void (*TaskFunc)(void* arg);
+
+ /**
+  * @brief Completion counter shared by a set of spawned tasks
+  */
+ typedef struct {
+     atomic_long pending;  ///< Tasks spawned into the group and not yet finished
+ } TaskGroup;
+
+ /**
+  * @brief A unit of work
+  */
+ typedef struct Task {
+     TaskFunc fn;          ///< Function to run
+     void* arg;            ///< Argument passed to fn
+     TaskGroup* group;     ///< Group notified on completion
+     struct Task* next;    ///< Link for the injection queue and free lists
+ } Task;
+
+ struct TaskScheduler;
+
+ /**
+  * @brief Per-worker state
+  */
+ typedef struct {
+     WsDeque deque;                   ///< Owned work-stealing deque
+     struct TaskScheduler* scheduler; ///< Owning scheduler
+     Task* free_tasks;                ///< Recycled task objects (worker-private)
+     int free_count;                  ///< Length of free_tasks
+     int id;                          ///< Worker index
+     uint32_t seed;                   ///< Victim selection random state
+     pthread_t thread;                ///< Worker thread
+ } TaskWorker;
+
+ /**
+  * @brief Scheduler structure
+  */
+ typedef struct TaskScheduler {
+     TaskWorker* workers;             ///< Worker array
+     int num_workers;                 ///< Number of workers
+     atomic_bool stop;                ///< Set when shutting down
+     atomic_int sleepers;             ///< Workers blocked on wake
+     atomic_long injected;            ///< Tasks in the injection queue
+     Task* inject_head;               ///< Injection queue head (guarded by lock)
+     Task* inject_tail;               ///< Injection queue tail (guarded by lock)
+     pthread_mutex_t lock;            ///< Guards injection queue and sleeping
+     pthread_cond_t wake;             ///< Signalled when work appears
+ } TaskScheduler;
+
+ /// Worker running on the current thread, NULL outside any pool
+ static _Thread_local TaskWorker* ts_current_worker = NULL;
+
+ /* ====================== Internal Helpers ====================== */
+
+ static inline Task* ts_task_alloc(TaskWorker* w) {
+     if (w != NULL && w->free_tasks != NULL) {
+         Task* t = w->free_tasks;
+         w->free_tasks = t->next;
+         w->free_count--;
+         return t;
+     }
+     return (Task*)malloc(sizeof(Task));
+ }
+
+ static inline void ts_task_release(TaskWorker* w, Task* t) {
+     if (w != NULL && w->free_count < TASK_SCHEDULER_FREE_TASKS) {
+         t->next = w->free_tasks;
+         w->free_tasks = t;
+         w->free_count++;
+         return;
+     }
+     free(t);
+ }
+
+ static inline void ts_run_task(TaskWorker* w, Task* t) {
+     TaskGroup* group = t->group;
+     t->fn(t->arg);
+     ts_task_release(w, t);
+     atomic_fetch_sub_explicit(&group->pending, 1, memory_order_release);
+ }
+
+ static inline Task* ts_take_injected(TaskScheduler* s) {
+     if (atomic_load_explicit(&s->injected, memory_order_relaxed) == 0) return NULL;
+     pthread_mutex_lock(&s->lock);
+     Task* t = s->inject_head;
+     if (t != NULL) {
+         s->inject_head = t->next;
+         if (s->inject_head == NULL) s->inject_tail = NULL;
+         atomic_fetch_sub_explicit(&s->injected, 1, memory_order_relaxed);
+     }
+     pthread_mutex_unlock(&s->lock);
+     return t;
+ }
+
+ /**
+  * @brief Internal: finds one task to run (own deque, injection queue, then steal)
+  *
+  * @param s Scheduler
+  * @param w Calling worker, or NULL for an external thread
+  */
+ static inline Task* ts_find_task(TaskScheduler* s, TaskWorker* w) {
+     void* item;
+     if (w != NULL && ws_deque_pop(&w->deque, &item)) return (Task*)item;
+
+     Task* t = ts_take_injected(s);
+     if (t != NULL) return t;
+
+     uint32_t seed_fallback = (uint32_t)(uintptr_t)&item;
+     uint32_t* seed = w != NULL ? &w->seed : &seed_fallback;
+     int n = s->num_workers;
+     for (int attempt = 0; attempt < 2 * n; attempt++) {
+         uint32_t x = *seed;
+         x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+         *seed = x ? x : 1u;
+         TaskWorker* victim = &s->workers[x % (uint32_t)n];
+         if (victim == w) continue;
+         if (ws_deque_steal(&victim->deque, &item) == WS_STEAL_SUCCESS) return (Task*)item;
+     }
+     return NULL;
+ }
+
+ static inline bool ts_work_visible(TaskScheduler* s) {
+     if (atomic_load_explicit(&s->injected, memory_order_relaxed) > 0) return true;
+     for (int i = 0; i < s->num_workers; i++) {
+         if (ws_deque_size(&s->workers[i].deque) > 0) return true;
+     }
+     return false;
+ }
+
+ static inline void ts_notify(TaskScheduler* s) {
+     // Pairs with the fence in ts_worker_main: either we see the sleeper or it sees our task
+     atomic_thread_fence(memory_order_seq_cst);
+     if (atomic_load_explicit(&s->sleepers, memory_order_relaxed) > 0) {
+         pthread_mutex_lock(&s->lock);
+         pthread_cond_signal(&s->wake);
+         pthread_mutex_unlock(&s->lock);
+     }
+ }
+
+ static inline void* ts_worker_main(void* arg) {
+     TaskWorker* w = (TaskWorker*)arg;
+     TaskScheduler* s = w->scheduler;
+     ts_current_worker = w;
+     int idle = 0;
+
+     while (!atomic_load_explicit(&s->stop, memory_order_acquire)) {
+         Task* t = ts_find_task(s, w);
+         if (t != NULL) {
+             ts_run_task(w, t);
+             idle = 0;
+             continue;
+         }
+         if (++idle < TASK_SCHEDULER_IDLE_SPINS) {
+             sched_yield();
+             continue;
+         }
+         pthread_mutex_lock(&s->lock);
+         atomic_fetch_add_explicit(&s->sleepers, 1, memory_order_relaxed);
+         atomic_thread_fence(memory_order_seq_cst);
+         if (!ts_work_visible(s) && !atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+             pthread_cond_wait(&s->wake, &s->lock);
+         }
+         atomic_fetch_sub_explicit(&s->sleepers, 1, memory_order_relaxed);
+         pthread_mutex_unlock(&s->lock);
+         idle = 0;
+     }
+
+     while (w->free_tasks != NULL) {
+         Task* t = w->free_tasks;
+         w->free_tasks = t->next;
+         free(t);
+     }
+     w->free_count = 0;
+     ts_current_worker = NULL;
+     return NULL;
+ }
+
+ /* ====================== Basic Operations ====================== */
+
+ /**
+  * @brief Returns the number of online processors (at least 1)
+  */
+ static inline int task_scheduler_default_workers(void) {
+     long n = sysconf(_SC_NPROCESSORS_ONLN);
+     return n > 0 ? (int)n : 1;
+ }
+
+ /**
+  * @brief Creates a scheduler and starts its worker threads
+  *
+  * @param num_workers Number of worker threads (0 = one per online processor)
+  * @return TaskScheduler* Pointer to the scheduler, or NULL on failure
+  * @note The caller must call task_scheduler_destroy() to stop the workers
+  */
+ static inline TaskScheduler* task_scheduler_create(int num_workers) {
+     if (num_workers <= 0) num_workers = task_scheduler_default_workers();
+
+     TaskScheduler* s = (TaskScheduler*)malloc(sizeof(TaskScheduler));
+     if (s == NULL) return NULL;
+     s->workers = (TaskWorker*)calloc((size_t)num_workers, sizeof(TaskWorker));
+     if (s->workers == NULL) {
+         free(s);
+         return NULL;
+     }
+     s->num_workers = num_workers;
+     atomic_init(&s->stop, false);
+     atomic_init(&s->sleepers, 0);
+     atomic_init(&s->injected, 0);
+     s->inject_head = s->inject_tail = NULL;
+     pthread_mutex_init(&s->lock, NULL);
+     pthread_cond_init(&s->wake, NULL);
+
+     for (int i = 0; i < num_workers; i++) {
+         TaskWorker* w = &s->workers[i];
+         w->scheduler = s;
+         w->id = i;
+         w->seed = 2654435761u * (uint32_t)(i + 1);
+         w->free_tasks = NULL;
+         w->free_count = 0;
+         if (!ws_deque_init(&w->deque)) {
+             for (int j = 0; j < i; j++) ws_deque_destroy(&s->workers[j].deque);
+             pthread_mutex_destroy(&s->lock);
+             pthread_cond_destroy(&s->wake);
+             free(s->workers);
+             free(s);
+             return NULL;
+         }
+     }
+     for (int i = 0; i < num_workers; i++) {
+         TaskWorker* w = &s->workers[i];
+         if (pthread_create(&w->thread, NULL, ts_worker_main, w) != 0) {
+             // Stop the workers that did start, then release everything
+             pthread_mutex_lock(&s->lock);
+             atomic_store_explicit(&s->stop, true, memory_order_release);
+             pthread_cond_broadcast(&s->wake);
+             pthread_mutex_unlock(&s->lock);
+             for (int j = 0; j < i; j++) pthread_join(s->workers[j].thread, NULL);
+             for (int j = 0; j < num_workers; j++) ws_deque_destroy(&s->workers[j].deque);
+             pthread_mutex_destroy(&s->lock);
+             pthread_cond_destroy(&s->wake);
+             free(s->workers);
+             free(s);
+             return NULL;
+         }
+     }
+     return s;
+ }
+
+ /**
+  * @brief Stops the workers and frees the scheduler
+  *
+  * @param s Pointer to the scheduler (may be NULL)
+  * @warning All task groups must have been synced beforehand
+  */
+ static inline void task_scheduler_destroy(TaskScheduler* s) {
+     if (s == NULL) return;
+     pthread_mutex_lock(&s->lock);
+     atomic_store_explicit(&s->stop, true, memory_order_release);
+     pthread_cond_broadcast(&s->wake);
+     pthread_mutex_unlock(&s->lock);
+
+     for (int i = 0; i < s->num_workers; i++) {
+         pthread_join(s->workers[i].thread, NULL);
+         ws_deque_destroy(&s->workers[i].deque);
+     }
+     pthread_mutex_destroy(&s->lock);
+     pthread_cond_destroy(&s->wake);
+     free(s->workers);
+     free(s);
+ }
+
+ /**
+  * @brief Returns the number of worker threads
+  */
+ static inline int task_scheduler_num_workers(const TaskScheduler* s) {
+     return s->num_workers;
+ }
+
+ /**
+  * @brief Returns the index of the worker running the calling thread
+  *
+  * @return int Worker index in [0, num_workers), or -1 outside the pool
+  */
+ static inline int task_scheduler_worker_id(void) {
+     return ts_current_worker != NULL ? ts_current_worker->id : -1;
+ }
+
+ /**
+  * @brief Initializes an empty task group
+  *
+  * @param g Pointer to the group
+  */
+ static inline void task_group_init(TaskGroup* g) {
+     atomic_init(&g->pending, 0);
+ }
+
+ /**
+  * @brief Schedules fn(arg) to run asynchronously as part of group @p g
+  *
+  * If the task object cannot be allocated the function runs inline, so the
+  * call never fails.
+  *
+  * @param s Scheduler
+  * @param g Group that task_sync() will wait on
+  * @param fn Function to run
+  * @param arg Argument passed to fn
+  */
+ static inline void task_spawn(TaskScheduler* s, TaskGroup* g, TaskFunc fn, void* arg) {
+     TaskWorker* w = ts_current_worker;
+     if (w != NULL && w->scheduler != s) w = NULL;
+
+     Task* t = ts_task_alloc(w);
+     if (t == NULL) {
+         fn(arg);
+         return;
+     }
+     t->fn = fn;
+     t->arg = arg;
+     t->group = g;
+     t->next = NULL;
+     atomic_fetch_add_explicit(&g->pending, 1, memory_order_relaxed);
+
+     if (w != NULL && ws_deque_push(&w->deque, t)) {
+         ts_notify(s);
+         return;
+     }
+     pthread_mutex_lock(&s->lock);
+     if (s->inject_tail != NULL) s->inject_tail->next = t;
+     else s->inject_head = t;
+     s->inject_tail = t;
+     atomic_fetch_add_explicit(&s->injected, 1, memory_order_relaxed);
+     pthread_mutex_unlock(&s->lock);
+     ts_notify(s);
+ }
+
+ /**
+  * @brief Waits until every task spawned into @p g has finished
+  *
+  * While waiting, the calling thread (worker or not) executes pending tasks
+  * from the pool instead of blocking.
+  *
+  * @param s Scheduler
+  * @param g Group to wait on
+  */
+ static inline void task_sync(TaskScheduler* s, TaskGroup* g) {
+     TaskWorker* w = ts_current_worker;
+     if (w != NULL && w->scheduler != s) w = NULL;
+
+     while (atomic_load_explicit(&g->pending, memory_order_acquire) > 0) {
+         Task* t = ts_find_task(s, w);
+         if (t != NULL) {
+             ts_run_task(w, t);
+         } else {
+             sched_yield();
+         }
+     }
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // TASK_SCHEDULER_H
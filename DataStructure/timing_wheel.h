@@ -0,0 +1,292 @@
+// timing_wheel.h
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchical timing wheel (Varghese & Lauck, SOSP 1987)
+// 分层时间轮
+//
+// Time is counted in integer ticks; the length of a tick (the resolution) is
+// chosen by the caller. The wheel has `levels` rings of 2^bits slots. Level 0
+// slots are one tick wide, level l slots are 2^(bits*l) ticks wide, so the
+// wheel covers 2^(bits*levels) ticks ahead. A timer is put in the lowest
+// level whose range contains its deadline, in the slot the deadline falls
+// in. Whenever the lower levels wrap around, the current slot of the next
+// level up is "cascaded": its timers are re-inserted one level lower. A timer
+// is cascaded at most levels - 1 times before it expires.
+// 时间以整数tick计，tick的长度（分辨率）由调用者决定。时间轮有levels层，每层
+// 2^bits个槽。第0层每槽1个tick，第l层每槽2^(bits*l)个tick，因此共覆盖
+// 2^(bits*levels)个tick。定时器放在范围能容纳其到期时间的最低层中对应的槽里。
+// 每当低层转完一圈，高一层的当前槽就会"降级"：其中的定时器被重新插入到更低的
+// 层。每个定时器到期前最多降级levels - 1次。
+//
+// Timers are intrusive: a TimerNode is embedded in the caller's object (or
+// allocated alongside it), so insert and cancel are O(1) list operations and
+// never allocate.
+// 定时器是侵入式的：TimerNode嵌入在调用者的对象中，因此插入和取消都是O(1)的
+// 链表操作，且从不分配内存。
+
+// Default geometry: 4 levels of 256 slots cover 2^32 ticks
+// 默认结构：4层、每层256个槽，覆盖2^32个tick
+#define TIMING_WHEEL_DEFAULT_LEVELS 4
+#define TIMING_WHEEL_DEFAULT_BITS   8
+
+// Get the enclosing object from a pointer to its TimerNode member
+// 由TimerNode成员指针获取外层对象
+#define TIMER_CONTAINER_OF(ptr, type, member) \
+    ((type*)((char*)(ptr) - offsetof(type, member)))
+
+// Timer handle, embedded in the caller's object
+// 定时器句柄，嵌入在调用者的对象中
+typedef struct TimerNode {
+    struct TimerNode *prev;     // Doubly linked list links (双向链表指针)
+    struct TimerNode *next;
+    uint64_t expires;           // Deadline in ticks (到期时间，单位tick)
+    void *data;                 // Optional user data (可选的用户数据)
+    bool in_wheel;              // Scheduled and not yet expired (已调度且尚未到期)
+} TimerNode;
+
+// List of timers, used for wheel slots and for batches of expired timers
+// 定时器链表，用于时间轮的槽和到期定时器批次
+typedef struct {
+    TimerNode head;             // Sentinel of a circular list (循环链表的哨兵)
+} TimerList;
+
+// Timing wheel structure
+// 时间轮结构
+typedef struct {
+    TimerList *slots;           // levels * 2^bits slot lists (各层的槽)
+    TimerList due;              // Timers whose deadline had passed when added (加入时已到期的定时器)
+    uint64_t now;               // Current tick (当前tick)
+    int levels;                 // Number of levels (层数)
+    int bits;                   // log2 of slots per level (每层槽数的对数)
+    size_t count;               // Number of scheduled timers (已调度的定时器数量)
+} TimingWheel;
+
+static inline void timer_list_init(TimerList *list) {
+    list->head.prev = list->head.next = &list->head;
+}
+
+static inline bool timer_list_empty(const TimerList *list) {
+    return list->head.next == &list->head;
+}
+
+// Initialize a timer handle before its first use
+// 首次使用前初始化定时器句柄
+static inline void timer_init(TimerNode *timer, void *data) {
+    timer->prev = timer->next = NULL;
+    timer->expires = 0;
+    timer->data = data;
+    timer->in_wheel = false;
+}
+
+// True if the timer is scheduled in a wheel and has not expired yet
+// 定时器是否已在时间轮中调度且尚未到期
+static inline bool timer_pending(const TimerNode *timer) {
+    return timer->in_wheel;
+}
+
+static inline void timer_list_append(TimerList *list, TimerNode *timer) {
+    timer->prev = list->head.prev;
+    timer->next = &list->head;
+    list->head.prev->next = timer;
+    list->head.prev = timer;
+}
+
+static inline void timer_list_unlink(TimerNode *timer) {
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+}
+
+// Move every timer of src to the end of dst in O(1)
+// O(1)将src中的所有定时器移到dst末尾
+static inline void timer_list_splice(TimerList *dst, TimerList *src) {
+    if (timer_list_empty(src)) return;
+    TimerNode *first = src->head.next;
+    TimerNode *last = src->head.prev;
+    first->prev = dst->head.prev;
+    dst->head.prev->next = first;
+    last->next = &dst->head;
+    dst->head.prev = last;
+    timer_list_init(src);
+}
+
+// Remove and return the first timer of a list, NULL if empty
+// 取出链表中的第一个定时器，空链表返回NULL
+static inline TimerNode* timer_list_pop(TimerList *list) {
+    if (timer_list_empty(list)) return NULL;
+    TimerNode *timer = list->head.next;
+    timer_list_unlink(timer);
+    return timer;
+}
+
+// Create a wheel with `levels` levels of 2^bits slots starting at tick `now`;
+// 0 selects the defaults. NULL on failure or if bits * levels exceeds 64.
+// 创建一个levels层、每层2^bits个槽、从第now个tick开始的时间轮；传0使用默认值。
+// 失败或bits * levels超过64时返回NULL。
+static inline TimingWheel* timing_wheel_create(int levels, int bits, uint64_t now) {
+    if (levels <= 0) levels = TIMING_WHEEL_DEFAULT_LEVELS;
+    if (bits <= 0) bits = TIMING_WHEEL_DEFAULT_BITS;
+    if (bits > 16 || levels * bits > 64) return NULL;
+    TimingWheel *tw = (TimingWheel*)malloc(sizeof(TimingWheel));
+    if (!tw) return NULL;
+    size_t num_slots = (size_t)levels << bits;
+    tw->slots = (TimerList*)malloc(num_slots * sizeof(TimerList));
+    if (!tw->slots) {
+        free(tw);
+        return NULL;
+    }
+    for (size_t i = 0; i < num_slots; i++) timer_list_init(&tw->slots[i]);
+    timer_list_init(&tw->due);
+    tw->now = now;
+    tw->levels = levels;
+    tw->bits = bits;
+    tw->count = 0;
+    return tw;
+}
+
+// Free the wheel; scheduled timers are simply forgotten
+// 释放时间轮，已调度的定时器直接被丢弃
+static inline void timing_wheel_free(TimingWheel *tw) {
+    if (!tw) return;
+    free(tw->slots);
+    free(tw);
+}
+
+static inline uint64_t timing_wheel_now(const TimingWheel *tw) {
+    return tw->now;
+}
+
+static inline size_t timing_wheel_size(const TimingWheel *tw) {
+    return tw->count;
+}
+
+// Link a timer into the slot matching its deadline
+// 将定时器链入与其到期时间对应的槽
+static inline void timing_wheel_place(TimingWheel *tw, TimerNode *timer) {
+    if (timer->expires <= tw->now) {
+        timer_list_append(&tw->due, timer);
+        return;
+    }
+    uint64_t delta = timer->expires - tw->now;
+    uint64_t mask = ((uint64_t)1 << tw->bits) - 1;
+    int level = 0;
+    while (level < tw->levels - 1 && (delta >> (tw->bits * (level + 1))) != 0) level++;
+    // Beyond the top level's range: park at the farthest reachable slot,
+    // it will be re-placed when that slot is cascaded
+    // 超出最高层的范围：放到能到达的最远的槽，该槽降级时再重新放置
+    uint64_t target = timer->expires;
+    int top_shift = tw->bits * tw->levels;
+    if (top_shift < 64 && (delta >> top_shift) != 0) {
+        target = tw->now + (((uint64_t)1 << top_shift) - 1);
+    }
+    size_t slot = (size_t)((target >> (tw->bits * level)) & mask);
+    timer_list_append(&tw->slots[((size_t)level << tw->bits) + slot], timer);
+}
+
+// Schedule a timer to expire at absolute tick `expires`, O(1). A pending
+// timer is rescheduled. Deadlines not after the current tick fire on the
+// next advance.
+// 调度定时器在绝对tick expires到期，O(1)。已调度的定时器会被重新调度。
+// 不晚于当前tick的到期时间会在下一次推进时触发。
+static inline void timing_wheel_add(TimingWheel *tw, TimerNode *timer, uint64_t expires) {
+    if (timer->in_wheel) {
+        timer_list_unlink(timer);
+    } else {
+        tw->count++;
+    }
+    timer->expires = expires;
+    timer->in_wheel = true;
+    timing_wheel_place(tw, timer);
+}
+
+// Schedule a timer `ticks` ticks from now (相对当前时刻调度定时器)
+static inline void timing_wheel_add_after(TimingWheel *tw, TimerNode *timer, uint64_t ticks) {
+    timing_wheel_add(tw, timer, tw->now + ticks);
+}
+
+// Cancel a timer in O(1); false if it was not pending
+// O(1)取消定时器；未在调度中时返回false
+static inline bool timing_wheel_cancel(TimingWheel *tw, TimerNode *timer) {
+    if (!timer->in_wheel) return false;
+    timer_list_unlink(timer);
+    timer->in_wheel = false;
+    tw->count--;
+    return true;
+}
+
+// Re-insert the timers of one higher-level slot (将高层某槽中的定时器重新插入)
+static inline void timing_wheel_cascade(TimingWheel *tw, int level) {
+    uint64_t mask = ((uint64_t)1 << tw->bits) - 1;
+    size_t slot = (size_t)((tw->now >> (tw->bits * level)) & mask);
+    TimerList pending;
+    timer_list_init(&pending);
+    timer_list_splice(&pending, &tw->slots[((size_t)level << tw->bits) + slot]);
+    TimerNode *timer;
+    while ((timer = timer_list_pop(&pending)) != NULL) {
+        timing_wheel_place(tw, timer);
+    }
+}
+
+// Move the due timers of a list to the expired batch. Timers parked there
+// beyond the wheel's range (only possible with a single level) are re-placed.
+// 将链表中已到期的定时器移入到期批次。超出范围而暂存于此的定时器（仅在只有
+// 一层时可能出现）会被重新放置。
+static inline size_t timing_wheel_collect(TimingWheel *tw, TimerList *src, TimerList *expired) {
+    size_t n = 0;
+    TimerList pending;
+    timer_list_init(&pending);
+    timer_list_splice(&pending, src);
+    TimerNode *timer;
+    while ((timer = timer_list_pop(&pending)) != NULL) {
+        if (timer->expires > tw->now) {
+            timing_wheel_place(tw, timer);
+            continue;
+        }
+        timer->in_wheel = false;
+        timer_list_append(expired, timer);
+        n++;
+    }
+    tw->count -= n;
+    return n;
+}
+
+// Advance the wheel by `ticks` ticks and append every timer that expired to
+// `expired`, in deadline order up to the tick. Returns the number of expired
+// timers. Expired timers are no longer pending; take them out of the batch
+// with timer_list_pop before re-adding them.
+// 将时间轮推进ticks个tick，并把所有到期的定时器追加到expired中（按tick顺序）。
+// 返回到期定时器的数量。到期的定时器不再处于调度中；重新加入前需先用
+// timer_list_pop将其从批次中取出。
+static inline size_t timing_wheel_advance(TimingWheel *tw, uint64_t ticks, TimerList *expired) {
+    size_t n = timing_wheel_collect(tw, &tw->due, expired);
+    uint64_t mask = ((uint64_t)1 << tw->bits) - 1;
+    for (uint64_t i = 0; i < ticks; i++) {
+        if (tw->count == 0) {
+            // Nothing left to expire: jump straight to the target tick
+            // 没有待到期的定时器：直接跳到目标tick
+            tw->now += ticks - i;
+            break;
+        }
+        tw->now++;
+        // Cascade from the top so timers can fall through several levels
+        // 从最高层开始降级，使定时器可以连续下降多层
+        int wrapped = 0;
+        while (wrapped < tw->levels - 1 && ((tw->now >> (tw->bits * (wrapped + 1))) << (tw->bits * (wrapped + 1))) == tw->now) {
+            wrapped++;
+        }
+        for (int level = wrapped; level >= 1; level--) {
+            timing_wheel_cascade(tw, level);
+        }
+        n += timing_wheel_collect(tw, &tw->slots[tw->now & mask], expired);
+        n += timing_wheel_collect(tw, &tw->due, expired);
+    }
+    return n;
+}
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,208 @@
+/**
+ * @file work_stealing_deque.h
+ * @brief Chase-Lev work-stealing deque of void pointers
+ *
+ * One owner thread pushes and pops at the bottom in LIFO order without any
+ * atomic read-modify-write in the common case; any number of thief threads
+ * steal from the top in FIFO order with a single CAS. The circular buffer
+ * grows on demand. Retired buffers are kept until the deque is destroyed
+ * because a thief may still be reading one.
+ *
+ * Memory orderings follow Le, Pop, Cohen, Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ *
+ * Requires C11 <stdatomic.h>.
+ */
+
+ #ifndef WORK_STEALING_DEQUE_H
+ #define WORK_STEALING_DEQUE_H
+
+ #include <stdlib.h>
+ #include <stdint.h>
+ #include <stdbool.h>
+ #include <stdatomic.h>
+
+ #ifdef __cplusplus
+ extern "C" {
+ #endif
+
+ /// Initial buffer capacity (power of two)
+ #define WS_DEQUE_INITIAL_CAPACITY 64
+
+ /**
+  * @brief Circular buffer backing a deque
+  */
+ typedef struct WsDequeBuffer {
+     int64_t mask;                  ///< capacity - 1
+     struct WsDequeBuffer* retired; ///< Previously used (smaller) buffer
+     _Atomic(void*) items[];        ///< Slots, indexed by position & mask
+ } WsDequeBuffer;
+
+ /**
+  * @brief Chase-Lev deque structure
+  *
+  * @c top and @c bottom are kept on separate cache lines because thieves
+  * hammer the former while the owner updates the latter.
+  */
+ typedef struct {
+     _Atomic int64_t top;           ///< Next position to steal from
+     char pad0[64 - sizeof(int64_t)];
+     _Atomic int64_t bottom;        ///< Next position the owner pushes to
+     _Atomic(WsDequeBuffer*) buffer;///< Current buffer
+     char pad1[64 - sizeof(int64_t) - sizeof(void*)];
+ } WsDeque;
+
+ /**
+  * @brief Result of a steal attempt
+  */
+ typedef enum {
+     WS_STEAL_SUCCESS = 0, ///< An item was stolen
+     WS_STEAL_EMPTY,       ///< The deque was empty
+     WS_STEAL_ABORT        ///< Lost a race with the owner or another thief; retry later
+ } WsStealResult;
+
+ /* ====================== Internal Helpers ====================== */
+
+ static inline WsDequeBuffer* ws_buffer_create(int64_t capacity) {
+     WsDequeBuffer* buf = (WsDequeBuffer*)malloc(sizeof(WsDequeBuffer) + (size_t)capacity * sizeof(_Atomic(void*)));
+     if (buf == NULL) return NULL;
+     buf->mask = capacity - 1;
+     buf->retired = NULL;
+     return buf;
+ }
+
+ static inline WsDequeBuffer* ws_buffer_grow(WsDequeBuffer* old, int64_t top, int64_t bottom) {
+     WsDequeBuffer* buf = ws_buffer_create((old->mask + 1) * 2);
+     if (buf == NULL) return NULL;
+     for (int64_t i = top; i < bottom; i++) {
+         void* item = atomic_load_explicit(&old->items[i & old->mask], memory_order_relaxed);
+         atomic_store_explicit(&buf->items[i & buf->mask], item, memory_order_relaxed);
+     }
+     buf->retired = old;
+     return buf;
+ }
+
+ /* ====================== Basic Operations ====================== */
+
+ /**
+  * @brief Initializes an empty deque
+  *
+  * @param q Pointer to the deque
+  * @return true on success, false on allocation failure
+  */
+ static inline bool ws_deque_init(WsDeque* q) {
+     WsDequeBuffer* buf = ws_buffer_create(WS_DEQUE_INITIAL_CAPACITY);
+     if (buf == NULL) return false;
+     atomic_init(&q->top, 0);
+     atomic_init(&q->bottom, 0);
+     atomic_init(&q->buffer, buf);
+     return true;
+ }
+
+ /**
+  * @brief Releases the deque's buffers (not the stored items)
+  *
+  * @param q Pointer to the deque
+  * @warning No thread may access the deque concurrently
+  */
+ static inline void ws_deque_destroy(WsDeque* q) {
+     WsDequeBuffer* buf = atomic_load_explicit(&q->buffer, memory_order_relaxed);
+     while (buf != NULL) {
+         WsDequeBuffer* retired = buf->retired;
+         free(buf);
+         buf = retired;
+     }
+     atomic_store_explicit(&q->buffer, NULL, memory_order_relaxed);
+ }
+
+ /**
+  * @brief Pushes an item at the bottom (owner thread only)
+  *
+  * @param q Pointer to the deque
+  * @param item Item to push
+  * @return true on success, false if the buffer could not grow
+  */
+ static inline bool ws_deque_push(WsDeque* q, void* item) {
+     int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+     int64_t t = atomic_load_explicit(&q->top, memory_order_acquire);
+     WsDequeBuffer* buf = atomic_load_explicit(&q->buffer, memory_order_relaxed);
+     if (b - t > buf->mask) {
+         buf = ws_buffer_grow(buf, t, b);
+         if (buf == NULL) return false;
+         atomic_store_explicit(&q->buffer, buf, memory_order_release);
+     }
+     atomic_store_explicit(&buf->items[b & buf->mask], item, memory_order_relaxed);
+     atomic_store_explicit(&q->bottom, b + 1, memory_order_release);
+     return true;
+ }
+
+ /**
+  * @brief Pops the most recently pushed item (owner thread only)
+  *
+  * @param q Pointer to the deque
+  * @param out Receives the item
+  * @return true on success, false if the deque is empty
+  */
+ static inline bool ws_deque_pop(WsDeque* q, void** out) {
+     int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed) - 1;
+     WsDequeBuffer* buf = atomic_load_explicit(&q->buffer, memory_order_relaxed);
+     atomic_store_explicit(&q->bottom, b, memory_order_relaxed);
+     atomic_thread_fence(memory_order_seq_cst);
+     int64_t t = atomic_load_explicit(&q->top, memory_order_relaxed);
+
+     if (t > b) {
+         // Deque was empty
+         atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+         return false;
+     }
+     *out = atomic_load_explicit(&buf->items[b & buf->mask], memory_order_relaxed);
+     if (t == b) {
+         // Last item: race against thieves for it
+         bool won = atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                                                            memory_order_seq_cst, memory_order_relaxed);
+         atomic_store_explicit(&q->bottom, b + 1, memory_order_relaxed);
+         return won;
+     }
+     return true;
+ }
+
+ /**
+  * @brief Steals the oldest item from the top (any thread)
+  *
+  * @param q Pointer to the deque
+  * @param out Receives the item on WS_STEAL_SUCCESS
+  * @return WsStealResult Outcome of the attempt
+  */
+ static inline WsStealResult ws_deque_steal(WsDeque* q, void** out) {
+     int64_t t = atomic_load_explicit(&q->top, memory_order_acquire);
+     atomic_thread_fence(memory_order_seq_cst);
+     int64_t b = atomic_load_explicit(&q->bottom, memory_order_acquire);
+     if (t >= b) return WS_STEAL_EMPTY;
+
+     WsDequeBuffer* buf = atomic_load_explicit(&q->buffer, memory_order_acquire);
+     void* item = atomic_load_explicit(&buf->items[t & buf->mask], memory_order_relaxed);
+     if (!atomic_compare_exchange_strong_explicit(&q->top, &t, t + 1,
+                                                  memory_order_seq_cst, memory_order_relaxed)) {
+         return WS_STEAL_ABORT;
+     }
+     *out = item;
+     return WS_STEAL_SUCCESS;
+ }
+
+ /**
+  * @brief Returns an estimate of the number of items
+  *
+  * @param q Pointer to the deque
+  * @return int64_t Approximate size (exact when called by the owner with no thieves)
+  */
+ static inline int64_t ws_deque_size(WsDeque* q) {
+     int64_t b = atomic_load_explicit(&q->bottom, memory_order_relaxed);
+     int64_t t = atomic_load_explicit(&q->top, memory_order_relaxed);
+     return b > t ? b - t : 0;
+ }
+
+ #ifdef __cplusplus
+ }
+ #endif
+
+ #endif // WORK_STEALING_DEQUE_H
@@ -1,4 +1,4 @@
-#include "stack.h"  // 使用之前定义的栈实现
+#include "array_stack.h"  // 使用数组栈实现，元素按值存储
 #include <stdio.h>
 
 #define MAX_VERTICES 100
@@ -28,29 +28,32 @@ void graph_addEdge(Graph* g, int src, int dest) {
 // 使用栈实现的DFS
 void dfs_stack(Graph* g, int startVertex) {
     int visited[MAX_VERTICES] = {0};
-    Stack* s = stack_create();
+    ArrayStack s;
+    if (!array_stack_init(&s, sizeof(int), MAX_VERTICES)) {
+        fprintf(stderr, "Error: Memory allocation failed for stack\n");
+        return;
+    }
     
     // 标记起始顶点为已访问并压入栈
     visited[startVertex] = 1;
-    stack_push(s, startVertex);
+    array_stack_push(&s, &startVertex);
     
     printf("DFS traversal starting from vertex %d: ", startVertex);
     
-    while (!stack_isEmpty(s)) {
-        int currentVertex = stack_top(s);
-        stack_pop(s);
+    int currentVertex;
+    while (array_stack_pop(&s, &currentVertex)) {
         printf("%d ", currentVertex);
         
         // 访问所有邻接顶点
         for (int i = 0; i < g->numVertices; i++) {
             if (g->matrix[currentVertex][i] == 1 && !visited[i]) {
                 visited[i] = 1;
-                stack_push(s, i);
+                array_stack_push(&s, &i);
             }
         }
     }
     
-    stack_free(s);
+    array_stack_destroy(&s);
     printf("\n");
 }
 
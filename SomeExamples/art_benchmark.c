@@ -0,0 +1,188 @@
+#include "art.h"
+#include "hashmap.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 字符串键：自适应基数树 vs HashMap
+// 内存、插入、命中与不命中查询，以及 ART 独有的有序遍历、前缀扫描与最长前缀匹配
+// String keys: adaptive radix tree vs HashMap, for memory, inserts, hit and
+// miss lookups, plus what only the tree offers: ordered iteration, prefix
+// scans and longest-prefix match
+// Build: cc -O2 -I../DataStructure art_benchmark.c
+// Usage: ./a.out [keys.txt]   (one key per line, e.g. find /usr > keys.txt;
+//        default: 10^6 synthetic URLs)
+
+#define SYNTHETIC_KEYS 1000000
+#define MAX_KEY 4096
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+static char* copy_string(const char* s) {
+    size_t len = strlen(s) + 1;
+    char* p = (char*)malloc(len);
+    memcpy(p, s, len);
+    return p;
+}
+
+static char** read_keys(const char* path, size_t* n) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) return NULL;
+    size_t cap = 1024;
+    char** keys = (char**)malloc(cap * sizeof(char*));
+    char line[MAX_KEY];
+    *n = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') continue;
+        if (*n == cap) keys = (char**)realloc(keys, (cap *= 2) * sizeof(char*));
+        keys[(*n)++] = copy_string(line);
+    }
+    fclose(f);
+    return keys;
+}
+
+// 少量主机与目录，共享长前缀 / a few hosts and directories, so keys share long prefixes
+static char** synthetic_keys(size_t n) {
+    static const char* hosts[] = { "www.example.com", "docs.example.com", "shop.example.org",
+                                   "news.example.net", "cdn.static-example.com" };
+    static const char* dirs[] = { "articles", "products/category", "images/2024/thumbnails",
+                                  "api/v2/users", "blog/posts", "search/results" };
+    char** keys = (char**)malloc(n * sizeof(char*));
+    char line[MAX_KEY];
+    for (size_t i = 0; i < n; i++) {
+        snprintf(line, sizeof(line), "https://%s/%s/%llu/item-%llu.html", hosts[next_rand() % 5],
+                 dirs[next_rand() % 6], (unsigned long long)(next_rand() % 1000),
+                 (unsigned long long)(next_rand() % 100000));
+        keys[i] = copy_string(line);
+    }
+    return keys;
+}
+
+// 与 hashmap.h 的分配一致 / what hashmap.h allocates
+static size_t hashmap_bytes(const HashMap* map) {
+    size_t bytes = sizeof(HashMap) + (size_t)map->capacity * sizeof(HashMapEntry*);
+    for (int i = 0; i < map->capacity; i++) {
+        for (const HashMapEntry* e = map->buckets[i]; e != NULL; e = e->next) {
+            bytes += sizeof(HashMapEntry) + strlen(e->key) + 1;
+        }
+    }
+    return bytes;
+}
+
+static bool count_visit(const char* key, void* value, void* ctx) {
+    (void)key;
+    *(uint64_t*)ctx += (uintptr_t)value;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t n;
+    char** keys = argc > 1 ? read_keys(argv[1], &n) : synthetic_keys(n = SYNTHETIC_KEYS);
+    if (keys == NULL || n == 0) {
+        fprintf(stderr, "no keys in %s\n", argc > 1 ? argv[1] : "(synthetic)");
+        return 1;
+    }
+    size_t key_bytes = 0;
+    for (size_t i = 0; i < n; i++) key_bytes += strlen(keys[i]) + 1;
+    printf("%zu keys, %.1f bytes on average\n\n", n, (double)key_bytes / n);
+
+    printf("%-36s %9s\n", "insert all keys", "time(s)");
+    double start = now_seconds();
+    HashMap* map = hashmap_create(HASHMAP_DEFAULT_CAPACITY);
+    for (size_t i = 0; i < n; i++) hashmap_put(map, keys[i], (void*)(uintptr_t)(i + 1));
+    printf("%-36s %9.3f\n", "HashMap, hashmap_put", now_seconds() - start);
+    start = now_seconds();
+    ArtTree* t = art_create();
+    for (size_t i = 0; i < n; i++) art_put(t, keys[i], (void*)(uintptr_t)(i + 1));
+    printf("%-36s %9.3f\n", "ART, art_put", now_seconds() - start);
+    printf("memory for %zu distinct keys: key bytes %.1f MB, HashMap %.1f MB, ART %.1f MB\n\n",
+           art_size(t), key_bytes / 1e6, hashmap_bytes(map) / 1e6, art_memory_usage(t) / 1e6);
+
+    // 随机顺序的命中查询 / hits in random order
+    const char** probes = (const char**)malloc(n * sizeof(char*));
+    for (size_t i = 0; i < n; i++) probes[i] = keys[next_rand() % n];
+    printf("%-36s %9s %20s\n", "lookups (all hits)", "time(s)", "checksum");
+    uint64_t sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += (uintptr_t)hashmap_get(map, probes[i]);
+    printf("%-36s %9.3f %20llu\n", "HashMap, hashmap_get", now_seconds() - start, (unsigned long long)sum);
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += (uintptr_t)art_get(t, probes[i]);
+    printf("%-36s %9.3f %20llu\n\n", "ART, art_get", now_seconds() - start, (unsigned long long)sum);
+
+    // 在中间改一个字节的不命中查询 / misses: one byte changed in the middle
+    char** misses = (char**)malloc(n * sizeof(char*));
+    for (size_t i = 0; i < n; i++) {
+        misses[i] = copy_string(probes[i]);
+        misses[i][strlen(misses[i]) / 2] ^= 0x40;
+    }
+    printf("%-36s %9s %20s\n", "lookups (mostly misses)", "time(s)", "checksum");
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += (uintptr_t)hashmap_get(map, misses[i]);
+    printf("%-36s %9.3f %20llu\n", "HashMap, hashmap_get", now_seconds() - start, (unsigned long long)sum);
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += (uintptr_t)art_get(t, misses[i]);
+    printf("%-36s %9.3f %20llu\n\n", "ART, art_get", now_seconds() - start, (unsigned long long)sum);
+
+    // HashMap 没有以下操作 / HashMap has none of these
+    printf("%-36s %9s %20s\n", "ART only", "time(s)", "checksum");
+    sum = 0;
+    start = now_seconds();
+    art_iterate(t, count_visit, &sum);
+    printf("%-36s %9.3f %20llu\n", "art_iterate (all keys, sorted)", now_seconds() - start,
+           (unsigned long long)sum);
+    // 键的目录 (到最后一个 '/') 作为前缀 / the key's directory (up to the last '/') as the prefix
+    size_t scans = n / 10 > 0 ? n / 10 : 1;
+    char prefix[MAX_KEY + 8];
+    size_t visited = 0;
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < scans; i++) {
+        const char* slash = strrchr(probes[i], '/');
+        size_t len = slash != NULL ? (size_t)(slash - probes[i]) + 1 : 0;
+        memcpy(prefix, probes[i], len);
+        prefix[len] = '\0';
+        visited += art_scan_prefix(t, prefix, count_visit, &sum);
+    }
+    printf("%-36s %9.3f %20llu\n", "art_scan_prefix (directories)", now_seconds() - start,
+           (unsigned long long)sum);
+    printf("  %zu scans, %.1f keys each\n", scans, (double)visited / scans);
+    // 在键后追加字节，最长前缀是该键本身 / bytes appended to a key, whose longest prefix is the key
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) {
+        size_t len = strlen(probes[i]);
+        memcpy(prefix, probes[i], len);
+        memcpy(prefix + len, "?q=1", 5);
+        size_t match;
+        void* value;
+        if (art_longest_prefix(t, prefix, &match, &value)) sum += match;
+    }
+    printf("%-36s %9.3f %20llu\n", "art_longest_prefix", now_seconds() - start, (unsigned long long)sum);
+
+    hashmap_destroy(map);
+    art_free(t);
+    for (size_t i = 0; i < n; i++) {
+        free(keys[i]);
+        free(misses[i]);
+    }
+    free(keys);
+    free(misses);
+    free((void*)probes);
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "bitset.h"
+#include "hashset.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 稠密小整数集合：Bitset vs HashSet(int) 的插入、查询与内存；
+// 整体集合运算、popcount 与 rank/select 的 AVX2 vs 逐字实现
+// Dense small-integer sets: Bitset vs HashSet(int) for insertion, queries and
+// memory; AVX2 vs word-by-word set operations and popcount; rank/select
+// Build: cc -O2 -I../DataStructure bitset_benchmark.c
+// Usage: ./a.out [universe]   (default 10^7)
+
+#define SET_OP_ROUNDS 20
+#define RANK_QUERIES 10000000
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+int main(int argc, char **argv) {
+    size_t universe = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 10000000;
+    if (universe == 0 || universe > INT32_MAX) universe = 10000000;
+    size_t n = universe / 4;
+    int *keys = (int*)malloc(n * sizeof(int));
+    int *queries = (int*)malloc(universe * sizeof(int));
+    for (size_t i = 0; i < n; i++) keys[i] = (int)(next_rand() % universe);
+    for (size_t i = 0; i < universe; i++) queries[i] = (int)(next_rand() % universe);
+
+    printf("universe [0, %zu), %zu random insertions, %zu random queries\n\n", universe, n, universe);
+    printf("%-30s %9s %9s %12s\n", "", "insert(s)", "query(s)", "memory(MB)");
+
+    // HashSet: 每个元素一个节点加一份数据拷贝，不计分配器开销
+    // HashSet: one node plus one data copy per element, allocator overhead not counted
+    double start = now_seconds();
+    HashSet *hs = HASHSET_INT();
+    for (size_t i = 0; i < n; i++) hashset_add(hs, &keys[i]);
+    double t_insert = now_seconds() - start;
+    start = now_seconds();
+    size_t hits_hash = 0;
+    for (size_t i = 0; i < universe; i++) hits_hash += hashset_contains(hs, &queries[i]);
+    double t_query = now_seconds() - start;
+    double mb = (hs->size * (sizeof(SetNode) + sizeof(int)) + hs->capacity * sizeof(SetNode*)) / 1e6;
+    printf("%-30s %9.3f %9.3f %12.1f\n", "HashSet(int)", t_insert, t_query, mb);
+
+    start = now_seconds();
+    Bitset *a = bitset_create(universe);
+    for (size_t i = 0; i < n; i++) bitset_set(a, (size_t)keys[i]);
+    t_insert = now_seconds() - start;
+    start = now_seconds();
+    size_t hits_bits = 0;
+    for (size_t i = 0; i < universe; i++) hits_bits += bitset_test(a, (size_t)queries[i]);
+    t_query = now_seconds() - start;
+    mb = a->num_words * sizeof(uint64_t) / 1e6;
+    printf("%-30s %9.3f %9.3f %12.1f\n", "Bitset", t_insert, t_query, mb);
+    printf("elements %zu / %llu, hits %zu / %zu\n\n", hs->size, (unsigned long long)bitset_count(a),
+           hits_hash, hits_bits);
+    hashset_free(hs);
+
+    // 第二个集合，用于整体运算 / a second set for whole-set operations
+    Bitset *b = bitset_create(universe);
+    Bitset *c = bitset_create(universe);
+    for (size_t i = 0; i < n; i++) bitset_set(b, (size_t)queries[i]);
+
+    printf("whole-set operations, %d rounds      time(s)   result\n", SET_OP_ROUNDS);
+    uint64_t check = 0;
+    start = now_seconds();
+    for (int r = 0; r < SET_OP_ROUNDS; r++) {
+        bitset_apply_scalar(c->words, a->words, b->words, a->num_words, BITSET_OP_AND);
+        check += c->words[r];
+    }
+    printf("%-30s %9.3f\n", "and, word loop", now_seconds() - start);
+    start = now_seconds();
+    for (int r = 0; r < SET_OP_ROUNDS; r++) {
+        bitset_and(c, a, b);
+        check += c->words[r];
+    }
+    printf("%-30s %9.3f\n", "and, bitset_and", now_seconds() - start);
+
+    uint64_t count = 0;
+    start = now_seconds();
+    for (int r = 0; r < SET_OP_ROUNDS; r++) count += bitset_count_scalar(a->words, NULL, a->num_words);
+    printf("%-30s %9.3f %8llu\n", "count, portable popcount", now_seconds() - start,
+           (unsigned long long)(count / SET_OP_ROUNDS));
+    count = 0;
+    start = now_seconds();
+    for (int r = 0; r < SET_OP_ROUNDS; r++) count += bitset_count(a);
+    printf("%-30s %9.3f %8llu\n", "count, bitset_count", now_seconds() - start,
+           (unsigned long long)(count / SET_OP_ROUNDS));
+    count = 0;
+    start = now_seconds();
+    for (int r = 0; r < SET_OP_ROUNDS; r++) count += bitset_count_and(a, b);
+    printf("%-30s %9.3f %8llu\n", "|a & b|, bitset_count_and", now_seconds() - start,
+           (unsigned long long)(count / SET_OP_ROUNDS));
+
+    // 遍历集合元素：逐位测试 vs find-next
+    // Visiting the elements: test every bit vs find-next
+    count = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < universe; i++) {
+        if (bitset_test(a, i)) count += i;
+    }
+    printf("%-30s %9.3f\n", "iterate, test every bit", now_seconds() - start);
+    uint64_t count_next = 0;
+    start = now_seconds();
+    BITSET_FOREACH(a, i) count_next += i;
+    printf("%-30s %9.3f%s\n\n", "iterate, BITSET_FOREACH", now_seconds() - start,
+           count == count_next ? "" : "  (MISMATCH)");
+
+    printf("rank/select, %d queries each           time(s)\n", RANK_QUERIES);
+    start = now_seconds();
+    bitset_build_rank(a);
+    printf("%-30s %9.3f\n", "bitset_build_rank", now_seconds() - start);
+    uint64_t total = bitset_count(a);
+    start = now_seconds();
+    for (int q = 0; q < RANK_QUERIES; q++) check += bitset_rank(a, (size_t)(next_rand() % universe));
+    printf("%-30s %9.3f\n", "bitset_rank", now_seconds() - start);
+    start = now_seconds();
+    size_t bad = 0;
+    for (int q = 0; q < RANK_QUERIES; q++) {
+        uint64_t k = next_rand() % total;
+        size_t pos = bitset_select(a, k);
+        if (q % 1024 == 0 && bitset_rank(a, pos) != k) bad++;
+    }
+    printf("%-30s %9.3f%s\n", "bitset_select", now_seconds() - start, bad ? "  (MISMATCH)" : "");
+    if (check == 42) printf(" ");
+
+    bitset_free(a);
+    bitset_free(b);
+    bitset_free(c);
+    free(keys);
+    free(queries);
+    return 0;
+}
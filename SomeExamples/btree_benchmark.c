@@ -0,0 +1,202 @@
+#include "btree.h"
+#include "dynamic_array.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 有序映射：B+ 树 vs 排序后的 DynamicArray + 二分查找
+// 构建、点查询、lower_bound、范围扫描与增量插入
+// Ordered map: B+-tree vs a sorted DynamicArray with binary search, for
+// building, point lookups, lower_bound, range scans and incremental inserts
+// Build: cc -O2 -I../DataStructure btree_benchmark.c
+// Usage: ./a.out [n]   (default 4 * 10^6 keys)
+
+#define RANGE_LENGTH 100
+#define ARRAY_NEW_KEYS 1000
+#define TREE_NEW_KEYS 100000
+
+typedef struct {
+    uint64_t key;
+    uint64_t value;
+} Entry;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+static int compare_entry(const void *a, const void *b) {
+    uint64_t x = ((const Entry*)a)->key, y = ((const Entry*)b)->key;
+    return (x > y) - (x < y);
+}
+
+// 第一个 >= key 的位置 / index of the first entry >= key
+static size_t array_lower_bound(const Entry *e, size_t n, uint64_t key) {
+    size_t lo = 0;
+    while (n > 0) {
+        size_t half = n / 2;
+        if (e[lo + half].key < key) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+static bool sum_visit(uint64_t key, uint64_t value, void *ctx) {
+    (void)key;
+    *(uint64_t*)ctx += value;
+    return true;
+}
+
+static size_t tree_bytes(void *node, uint32_t height) {
+    if (height == 0) return (sizeof(BTreeLeaf) + 63) & ~(size_t)63;
+    BTreeInner *in = (BTreeInner*)node;
+    size_t bytes = (sizeof(BTreeInner) + 63) & ~(size_t)63;
+    for (uint32_t i = 0; i <= in->count; i++) bytes += tree_bytes(in->children[i], height - 1);
+    return bytes;
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 4000000;
+    if (n < 2) n = 2;
+    uint64_t *keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t *probes = (uint64_t*)malloc(n * sizeof(uint64_t));
+    // 偶数键，奇数探测值必然不命中 / even keys, so odd probes always miss
+    for (size_t i = 0; i < n; i++) keys[i] = next_rand() & ~(uint64_t)1;
+
+    printf("%zu random 64-bit keys\n\n", n);
+    printf("%-36s %9s\n", "build", "time(s)");
+
+    double start = now_seconds();
+    DynamicArray da;
+    dynamic_array_init(&da, sizeof(Entry), 16);
+    for (size_t i = 0; i < n; i++) {
+        Entry e = { keys[i], i };
+        dynamic_array_push_back(&da, &e);
+    }
+    dynamic_array_sort(&da, compare_entry);
+    printf("%-36s %9.3f\n", "DynamicArray, push_back + sort", now_seconds() - start);
+    Entry *sorted = (Entry*)da.data;
+
+    start = now_seconds();
+    BTree *t = btree_create();
+    for (size_t i = 0; i < n; i++) btree_put(t, keys[i], i);
+    printf("%-36s %9.3f\n", "BTree, btree_put in random order", now_seconds() - start);
+    size_t random_bytes = tree_bytes(t->root, t->height);
+
+    // 去重后批量加载 / bulk load after dropping duplicates
+    uint64_t *sorted_keys = (uint64_t*)malloc(n * sizeof(uint64_t));
+    uint64_t *sorted_values = (uint64_t*)malloc(n * sizeof(uint64_t));
+    size_t unique = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (unique > 0 && sorted_keys[unique - 1] == sorted[i].key) continue;
+        sorted_keys[unique] = sorted[i].key;
+        sorted_values[unique++] = sorted[i].value;
+    }
+    start = now_seconds();
+    BTree *bulk = btree_bulk_load(sorted_keys, sorted_values, unique);
+    printf("%-36s %9.3f\n", "BTree, btree_bulk_load (sorted)", now_seconds() - start);
+    printf("memory: array %.1f MB, tree by inserts %.1f MB, bulk-loaded tree %.1f MB, %u levels\n\n",
+           n * sizeof(Entry) / 1e6, random_bytes / 1e6, tree_bytes(bulk->root, bulk->height) / 1e6,
+           btree_height(bulk) + 1);
+
+    // 随机顺序的命中查询 / hits in random order
+    for (size_t i = 0; i < n; i++) probes[i] = keys[next_rand() % n];
+    printf("%-36s %9s %20s\n", "point lookups (all hits)", "time(s)", "checksum");
+    uint64_t sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) {
+        Entry e = { probes[i], 0 };
+        const Entry *found = (const Entry*)bsearch(&e, sorted, da.size, sizeof(Entry), compare_entry);
+        sum += found->key;
+    }
+    printf("%-36s %9.3f %20llu\n", "array, bsearch", now_seconds() - start, (unsigned long long)sum);
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += sorted[array_lower_bound(sorted, da.size, probes[i])].key;
+    printf("%-36s %9.3f %20llu\n", "array, inlined binary search", now_seconds() - start, (unsigned long long)sum);
+    bool simd = bulk->simd;
+    bulk->simd = false;
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += btree_get(bulk, probes[i], NULL) ? probes[i] : 0;
+    printf("%-36s %9.3f %20llu\n", "BTree, btree_get (binary search)", now_seconds() - start,
+           (unsigned long long)sum);
+    bulk->simd = simd;
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) sum += btree_get(bulk, probes[i], NULL) ? probes[i] : 0;
+    printf("%-36s %9.3f %20llu%s\n\n", "BTree, btree_get", now_seconds() - start, (unsigned long long)sum,
+           simd ? "" : "  (no AVX2)");
+
+    // 不命中的 lower_bound / lower_bound of absent keys
+    for (size_t i = 0; i < n; i++) probes[i] = next_rand() | 1;
+    printf("%-36s %9s %20s\n", "lower_bound (all misses)", "time(s)", "checksum");
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) {
+        size_t pos = array_lower_bound(sorted, da.size, probes[i]);
+        if (pos < da.size) sum += sorted[pos].key;
+    }
+    printf("%-36s %9.3f %20llu\n", "array", now_seconds() - start, (unsigned long long)sum);
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < n; i++) {
+        BTreeIter it = btree_lower_bound(bulk, probes[i]);
+        if (btree_iter_valid(it)) sum += btree_iter_key(it);
+    }
+    printf("%-36s %9.3f %20llu\n\n", "BTree", now_seconds() - start, (unsigned long long)sum);
+
+    size_t scans = n / 10;
+    uint64_t span = UINT64_MAX / unique * RANGE_LENGTH;
+    printf("%-36s %9s %20s\n", "range scans (~100 keys each)", "time(s)", "checksum");
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < scans; i++) {
+        uint64_t lo = probes[i], hi = lo + span < lo ? UINT64_MAX : lo + span;
+        for (size_t pos = array_lower_bound(sorted, da.size, lo); pos < da.size && sorted[pos].key <= hi; pos++) {
+            sum += sorted[pos].value;
+        }
+    }
+    printf("%-36s %9.3f %20llu\n", "array", now_seconds() - start, (unsigned long long)sum);
+    sum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < scans; i++) {
+        uint64_t lo = probes[i], hi = lo + span < lo ? UINT64_MAX : lo + span;
+        btree_scan(bulk, lo, hi, sum_visit, &sum);
+    }
+    printf("%-36s %9.3f %20llu\n\n", "BTree, btree_scan", now_seconds() - start, (unsigned long long)sum);
+
+    // 数组每次插入移动一半元素，只插入少量键
+    // Each array insert moves half the entries, so it gets fewer keys
+    printf("%-36s %9s\n", "inserting new keys", "us/key");
+    start = now_seconds();
+    for (size_t i = 0; i < ARRAY_NEW_KEYS; i++) {
+        Entry e = { probes[i], i };
+        dynamic_array_insert(&da, array_lower_bound((const Entry*)da.data, da.size, e.key), &e);
+    }
+    printf("%-36s %9.3f\n", "array, dynamic_array_insert", (now_seconds() - start) * 1e6 / ARRAY_NEW_KEYS);
+    start = now_seconds();
+    for (size_t i = 0; i < TREE_NEW_KEYS; i++) btree_put(bulk, probes[i], i);
+    printf("%-36s %9.3f\n", "BTree, btree_put", (now_seconds() - start) * 1e6 / TREE_NEW_KEYS);
+
+    btree_free(t);
+    btree_free(bulk);
+    dynamic_array_destroy(&da);
+    free(keys);
+    free(probes);
+    free(sorted_keys);
+    free(sorted_values);
+    return 0;
+}
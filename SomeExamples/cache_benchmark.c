@@ -0,0 +1,233 @@
+#include "cache.h"
+#include "hashmap.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+
+// 有界缓存：HashMap + 手写链表 vs cache.h 的 LRU 与 CLOCK，以及分片的线程安全版本
+// 在 Zipf 分布的访问序列上比较命中率与吞吐量，未命中时插入 (read-through)
+// Bounded caches: HashMap plus a hand-rolled list vs the LRU and CLOCK caches
+// of cache.h, and the sharded thread-safe cache, on Zipf-distributed
+// read-through traces (a miss inserts the key), for hit ratio and throughput
+// Build: cc -O2 -pthread -I../DataStructure cache_benchmark.c -lm
+// Usage: ./a.out [zipf exponent] [threads]   (default 0.99, 4 threads)
+
+#define UNIVERSE 1000000
+#define TRACE_LENGTH 5000000
+#define SHARDS 16
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+static char* keys[UNIVERSE];
+static uint32_t* trace;
+
+// 排名 i 的概率正比于 1 / (i + 1)^s；用累积分布表与二分查找采样
+// Rank i has probability proportional to 1 / (i + 1)^s, sampled by binary
+// search in the cumulative distribution
+static void make_trace(double s) {
+    double* cdf = (double*)malloc(UNIVERSE * sizeof(double));
+    double sum = 0;
+    for (size_t i = 0; i < UNIVERSE; i++) cdf[i] = sum += pow((double)(i + 1), -s);
+    // 打乱排名与键的对应关系 / shuffle which key has which rank
+    uint32_t* key_of_rank = (uint32_t*)malloc(UNIVERSE * sizeof(uint32_t));
+    for (uint32_t i = 0; i < UNIVERSE; i++) key_of_rank[i] = i;
+    for (size_t i = UNIVERSE - 1; i > 0; i--) {
+        size_t j = next_rand() % (i + 1);
+        uint32_t t = key_of_rank[i];
+        key_of_rank[i] = key_of_rank[j];
+        key_of_rank[j] = t;
+    }
+    for (size_t i = 0; i < TRACE_LENGTH; i++) {
+        double u = (next_rand() >> 11) * (1.0 / 9007199254740992.0) * sum;
+        size_t lo = 0, hi = UNIVERSE - 1;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (cdf[mid] < u) lo = mid + 1; else hi = mid;
+        }
+        trace[i] = key_of_rank[lo];
+    }
+    free(key_of_rank);
+    free(cdf);
+}
+
+/* ---- Baseline: HashMap from key to a node of a separate LRU list ---- */
+
+typedef struct ListNode {
+    struct ListNode* prev;
+    struct ListNode* next;
+    char* key;                  // own copy, to remove the HashMap entry on eviction
+    void* value;
+} ListNode;
+
+typedef struct {
+    HashMap* map;
+    ListNode head;
+    size_t capacity;
+    size_t count;
+} HashMapLru;
+
+static void list_unlink(ListNode* n) {
+    n->prev->next = n->next;
+    n->next->prev = n->prev;
+}
+
+static void list_push_front(ListNode* head, ListNode* n) {
+    n->prev = head;
+    n->next = head->next;
+    head->next->prev = n;
+    head->next = n;
+}
+
+static void* baseline_get(HashMapLru* b, const char* key) {
+    ListNode* n = (ListNode*)hashmap_get(b->map, key);
+    if (n == NULL) return NULL;
+    list_unlink(n);
+    list_push_front(&b->head, n);
+    return n->value;
+}
+
+static void baseline_put(HashMapLru* b, const char* key, void* value) {
+    ListNode* n = (ListNode*)malloc(sizeof(ListNode));
+    n->key = strdup(key);
+    n->value = value;
+    list_push_front(&b->head, n);
+    hashmap_put(b->map, key, n);
+    if (++b->count > b->capacity) {
+        ListNode* last = b->head.prev;
+        list_unlink(last);
+        hashmap_remove(b->map, last->key);
+        free(last->key);
+        free(last);
+        b->count--;
+    }
+}
+
+static size_t baseline_bytes(const HashMapLru* b) {
+    size_t bytes = (size_t)b->map->capacity * sizeof(HashMapEntry*);
+    for (const ListNode* n = b->head.next; n != &b->head; n = n->next) {
+        bytes += sizeof(HashMapEntry) + sizeof(ListNode) + 2 * (strlen(n->key) + 1);
+    }
+    return bytes;
+}
+
+static size_t cache_bytes(const Cache* c) {
+    size_t bytes = c->num_buckets * sizeof(CacheEntry*);
+    for (const CacheLink* l = c->list.next; l != &c->list; l = l->next) {
+        bytes += sizeof(CacheEntry) + ((const CacheEntry*)l)->key_len + 1;
+    }
+    return bytes;
+}
+
+static void report(const char* name, double seconds, uint64_t hits, size_t bytes) {
+    printf("%-28s %8.1f %10.3f %9.1f\n", name, 100.0 * hits / TRACE_LENGTH, TRACE_LENGTH / seconds / 1e6,
+           bytes / 1e6);
+}
+
+/* ---- Threads on the sharded cache ---- */
+
+typedef struct {
+    ShardedCache* cache;
+    size_t begin;
+    size_t end;
+} Worker;
+
+static void* run_worker(void* arg) {
+    Worker* w = (Worker*)arg;
+    for (size_t i = w->begin; i < w->end; i++) {
+        const char* key = keys[trace[i]];
+        if (sharded_cache_get(w->cache, key) == NULL) sharded_cache_put(w->cache, key, (void*)key, 1);
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    double s = argc > 1 ? atof(argv[1]) : 0.99;
+    int threads = argc > 2 ? atoi(argv[2]) : 4;
+    if (threads < 1) threads = 1;
+    char buffer[32];
+    for (size_t i = 0; i < UNIVERSE; i++) {
+        snprintf(buffer, sizeof(buffer), "item:%08zu", i);
+        keys[i] = strdup(buffer);
+    }
+    trace = (uint32_t*)malloc(TRACE_LENGTH * sizeof(uint32_t));
+    make_trace(s);
+    printf("%d requests over %d keys, Zipf exponent %.2f\n", TRACE_LENGTH, UNIVERSE, s);
+
+    static const double fractions[] = { 0.001, 0.01, 0.1 };
+    for (size_t f = 0; f < sizeof(fractions) / sizeof(fractions[0]); f++) {
+        size_t capacity = (size_t)(UNIVERSE * fractions[f]);
+        printf("\ncapacity %zu entries (%.1f%% of the keys)\n", capacity, fractions[f] * 100);
+        printf("%-28s %8s %10s %9s\n", "", "hits(%)", "Mops/s", "MB");
+
+        HashMapLru b;
+        b.map = hashmap_create(HASHMAP_DEFAULT_CAPACITY);
+        b.head.prev = b.head.next = &b.head;
+        b.capacity = capacity;
+        b.count = 0;
+        uint64_t hits = 0;
+        double start = now_seconds();
+        for (size_t i = 0; i < TRACE_LENGTH; i++) {
+            const char* key = keys[trace[i]];
+            if (baseline_get(&b, key) != NULL) hits++;
+            else baseline_put(&b, key, (void*)key);
+        }
+        report("HashMap + list, LRU", now_seconds() - start, hits, baseline_bytes(&b));
+        for (ListNode* n = b.head.next; n != &b.head;) {
+            ListNode* next = n->next;
+            free(n->key);
+            free(n);
+            n = next;
+        }
+        hashmap_destroy(b.map);
+
+        for (int policy = CACHE_LRU; policy <= CACHE_CLOCK; policy++) {
+            Cache* c = cache_create((CachePolicy)policy, capacity, NULL, NULL);
+            start = now_seconds();
+            for (size_t i = 0; i < TRACE_LENGTH; i++) {
+                const char* key = keys[trace[i]];
+                if (cache_get(c, key) == NULL) cache_put(c, key, (void*)key, 1);
+            }
+            double seconds = now_seconds() - start;
+            report(policy == CACHE_LRU ? "Cache, LRU" : "Cache, CLOCK", seconds, cache_stats(c).hits, cache_bytes(c));
+            cache_free(c);
+        }
+
+        for (int policy = CACHE_LRU; policy <= CACHE_CLOCK; policy++) {
+            ShardedCache* sc = sharded_cache_create(SHARDS, (CachePolicy)policy, capacity, NULL, NULL, NULL);
+            pthread_t tids[64];
+            Worker workers[64];
+            int n = threads < 64 ? threads : 64;
+            start = now_seconds();
+            for (int t = 0; t < n; t++) {
+                workers[t].cache = sc;
+                workers[t].begin = (size_t)TRACE_LENGTH * t / n;
+                workers[t].end = (size_t)TRACE_LENGTH * (t + 1) / n;
+                pthread_create(&tids[t], NULL, run_worker, &workers[t]);
+            }
+            for (int t = 0; t < n; t++) pthread_join(tids[t], NULL);
+            double seconds = now_seconds() - start;
+            size_t bytes = 0;
+            for (size_t i = 0; i < sc->num_shards; i++) bytes += cache_bytes(&sc->shards[i].cache);
+            snprintf(buffer, sizeof(buffer), "Sharded %s, %d threads", policy == CACHE_LRU ? "LRU" : "CLOCK", n);
+            report(buffer, seconds, sharded_cache_stats(sc).hits, bytes);
+            sharded_cache_free(sc);
+        }
+    }
+
+    for (size_t i = 0; i < UNIVERSE; i++) free(keys[i]);
+    free(trace);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "stack.h"
+#include "concurrent_stack.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+// 多线程争用下对比：互斥锁保护的链式栈 vs 无锁栈（有/无线程本地节点缓存）
+// Contention benchmark: mutex-protected Stack vs lock-free ConcurrentStack
+// Build: cc -O2 -pthread -I../DataStructure concurrent_stack_benchmark.c
+
+#define OPS_PER_THREAD 2000000
+#define MAX_THREADS    16
+
+typedef enum { MODE_MUTEX, MODE_LOCKFREE, MODE_LOCKFREE_CACHE } Mode;
+
+typedef struct {
+    Mode mode;
+    int id;
+    long checksum;
+} Worker;
+
+static Stack* locked_stack;
+static pthread_mutex_t stack_lock = PTHREAD_MUTEX_INITIALIZER;
+static ConcurrentStack* lockfree_stack;
+
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    ConcurrentStackCache cache;
+    ConcurrentStackCache* cp = NULL;
+    if (w->mode == MODE_LOCKFREE_CACHE) {
+        concurrent_stack_cache_init(&cache, lockfree_stack, (uint32_t)w->id + 1);
+        cp = &cache;
+    }
+
+    long sum = 0;
+    for (long i = 0; i < OPS_PER_THREAD; i++) {
+        void* item = (void*)(intptr_t)(i + 1);
+        void* out = NULL;
+        if (w->mode == MODE_MUTEX) {
+            pthread_mutex_lock(&stack_lock);
+            stack_push(locked_stack, item);
+            pthread_mutex_unlock(&stack_lock);
+            pthread_mutex_lock(&stack_lock);
+            out = stack_pop(locked_stack);
+            pthread_mutex_unlock(&stack_lock);
+        } else {
+            while (!concurrent_stack_push(lockfree_stack, cp, item)) { }
+            while (!concurrent_stack_pop(lockfree_stack, cp, &out)) { }
+        }
+        sum += (long)(intptr_t)out;
+    }
+    if (cp) concurrent_stack_cache_flush(cp);
+    w->checksum = sum;
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double run(Mode mode, int threads, long* checksum) {
+    pthread_t tid[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    double start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        workers[t].mode = mode;
+        workers[t].id = t;
+        workers[t].checksum = 0;
+        pthread_create(&tid[t], NULL, worker_main, &workers[t]);
+    }
+    *checksum = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+        *checksum += workers[t].checksum;
+    }
+    return now_seconds() - start;
+}
+
+int main() {
+    static const char* names[] = { "mutex + Stack", "lock-free", "lock-free + cache" };
+    int thread_counts[] = { 1, 2, 4, 8, 16 };
+
+    locked_stack = stack_create();
+    // Room for every thread's in-flight element plus a full cache per thread
+    lockfree_stack = concurrent_stack_create(MAX_THREADS * (CONCURRENT_STACK_CACHE_SIZE + 1));
+    if (lockfree_stack == NULL) {
+        fprintf(stderr, "Error: Memory allocation failed for concurrent stack\n");
+        return 1;
+    }
+
+    printf("%-20s %8s %14s\n", "implementation", "threads", "Mops/s");
+    for (size_t c = 0; c < sizeof(thread_counts) / sizeof(thread_counts[0]); c++) {
+        int threads = thread_counts[c];
+        for (int m = MODE_MUTEX; m <= MODE_LOCKFREE_CACHE; m++) {
+            long checksum;
+            double secs = run((Mode)m, threads, &checksum);
+            double mops = 2.0 * OPS_PER_THREAD * threads / secs / 1e6;
+            printf("%-20s %8d %14.2f\n", names[m], threads, mops);
+            long expected = (long)threads * OPS_PER_THREAD / 2 * (OPS_PER_THREAD + 1);
+            if (checksum != expected) {
+                printf("  checksum mismatch: %ld != %ld\n", checksum, expected);
+            }
+        }
+    }
+
+    stack_free(locked_stack);
+    concurrent_stack_free(lockfree_stack);
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include "indexed_priority_queue.h"
+#include "keyed_priority_queue.h"
+#include "radix_heap.h"
+#include "bucket_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 大规模稀疏图上的Dijkstra：索引堆(decrease-key) vs 惰性删除(重复入堆)
+// Dijkstra on a large sparse graph: indexed heap with decrease-key vs lazy deletion
+// 整数权重下再比较单调队列：基数堆与Dial桶队列；最后以单位权重(BFS)重复一遍
+// With integer weights, also compare the monotone queues (radix heap and Dial
+// bucket queue), then repeat everything with unit weights (BFS)
+
+#define NUM_VERTICES 1000000
+#define OUT_DEGREE   6
+#define MAX_WEIGHT   1000
+
+// 压缩稀疏行(CSR)存储的有向带权图
+typedef struct {
+    int n;
+    int *offsets;
+    int *targets;
+    int *weights;
+} WeightedGraph;
+
+KEYED_PQ_DEFINE(LazyHeap, double, int, KEYED_PQ_LESS)
+
+static uint32_t rng_state = 88172645u;
+static uint32_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void graph_build(WeightedGraph *g, int n, int degree) {
+    size_t m = (size_t)n * degree;
+    g->n = n;
+    g->offsets = (int*)malloc((n + 1) * sizeof(int));
+    g->targets = (int*)malloc(m * sizeof(int));
+    g->weights = (int*)malloc(m * sizeof(int));
+    for (int v = 0; v <= n; v++) g->offsets[v] = v * degree;
+    for (int v = 0; v < n; v++) {
+        // One edge to the next vertex keeps the graph connected
+        g->targets[(size_t)v * degree] = (v + 1) % n;
+        g->weights[(size_t)v * degree] = 1 + (int)(next_rand() % MAX_WEIGHT);
+        for (int e = 1; e < degree; e++) {
+            g->targets[(size_t)v * degree + e] = (int)(next_rand() % (uint32_t)n);
+            g->weights[(size_t)v * degree + e] = 1 + (int)(next_rand() % MAX_WEIGHT);
+        }
+    }
+}
+
+static void graph_release(WeightedGraph *g) {
+    free(g->offsets);
+    free(g->targets);
+    free(g->weights);
+}
+
+typedef struct {
+    long pushes;
+    long pops;
+    long peak;
+} HeapStats;
+
+static void dijkstra_indexed(const WeightedGraph *g, int source, double *dist, HeapStats *st) {
+    IndexedPriorityQueue *pq = ipq_create(g->n);
+    for (int v = 0; v < g->n; v++) dist[v] = -1;
+    memset(st, 0, sizeof(*st));
+
+    dist[source] = 0;
+    ipq_push(pq, source, 0);
+    st->pushes++;
+    int u;
+    double d;
+    while (ipq_pop(pq, &u, &d)) {
+        st->pops++;
+        for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            int v = g->targets[e];
+            double nd = d + g->weights[e];
+            if (dist[v] < 0 || nd < dist[v]) {
+                dist[v] = nd;
+                ipq_push_or_decrease(pq, v, nd);
+                st->pushes++;
+            }
+        }
+        if (ipq_size(pq) > st->peak) st->peak = ipq_size(pq);
+    }
+    ipq_free(pq);
+}
+
+static void dijkstra_lazy(const WeightedGraph *g, int source, double *dist, HeapStats *st) {
+    LazyHeap pq;
+    LazyHeap_init(&pq, 1024);
+    char *done = (char*)calloc(g->n, 1);
+    for (int v = 0; v < g->n; v++) dist[v] = -1;
+    memset(st, 0, sizeof(*st));
+
+    dist[source] = 0;
+    LazyHeap_push(&pq, 0, source);
+    st->pushes++;
+    int u;
+    double d;
+    while (LazyHeap_pop(&pq, &d, &u)) {
+        st->pops++;
+        if (done[u]) continue;           // Stale duplicate (过期的重复元素)
+        done[u] = 1;
+        for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            int v = g->targets[e];
+            double nd = d + g->weights[e];
+            if (dist[v] < 0 || nd < dist[v]) {
+                dist[v] = nd;
+                LazyHeap_push(&pq, nd, v);
+                st->pushes++;
+            }
+        }
+        if ((long)LazyHeap_size(&pq) > st->peak) st->peak = (long)LazyHeap_size(&pq);
+    }
+    free(done);
+    LazyHeap_destroy(&pq);
+}
+
+// Monotone queues: stale entries are skipped exactly as in the lazy version
+// 单调队列：与惰性删除版本一样跳过过期元素
+static void dijkstra_radix(const WeightedGraph *g, int source, double *dist, HeapStats *st) {
+    RadixHeap *pq = rh_create();
+    uint32_t *best = (uint32_t*)malloc(g->n * sizeof(uint32_t));
+    for (int v = 0; v < g->n; v++) best[v] = UINT32_MAX;
+    memset(st, 0, sizeof(*st));
+
+    best[source] = 0;
+    rh_push(pq, 0, source);
+    st->pushes++;
+    uint32_t d;
+    int u;
+    while (rh_pop(pq, &d, &u)) {
+        st->pops++;
+        if (d != best[u]) continue;      // Stale duplicate (过期的重复元素)
+        for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            int v = g->targets[e];
+            uint32_t nd = d + (uint32_t)g->weights[e];
+            if (nd < best[v]) {
+                best[v] = nd;
+                rh_push(pq, nd, v);
+                st->pushes++;
+            }
+        }
+        if (rh_size(pq) > st->peak) st->peak = rh_size(pq);
+    }
+    for (int v = 0; v < g->n; v++) dist[v] = best[v] == UINT32_MAX ? -1 : (double)best[v];
+    free(best);
+    rh_free(pq);
+}
+
+static void dijkstra_bucket(const WeightedGraph *g, int source, uint32_t max_weight, double *dist, HeapStats *st) {
+    BucketQueue *pq = bq_create(max_weight);
+    uint32_t *best = (uint32_t*)malloc(g->n * sizeof(uint32_t));
+    for (int v = 0; v < g->n; v++) best[v] = UINT32_MAX;
+    memset(st, 0, sizeof(*st));
+
+    best[source] = 0;
+    bq_push(pq, 0, source);
+    st->pushes++;
+    uint32_t d;
+    int u;
+    while (bq_pop(pq, &d, &u)) {
+        st->pops++;
+        if (d != best[u]) continue;      // Stale duplicate (过期的重复元素)
+        for (int e = g->offsets[u]; e < g->offsets[u + 1]; e++) {
+            int v = g->targets[e];
+            uint32_t nd = d + (uint32_t)g->weights[e];
+            if (nd < best[v]) {
+                best[v] = nd;
+                bq_push(pq, nd, v);
+                st->pushes++;
+            }
+        }
+        if (bq_size(pq) > st->peak) st->peak = bq_size(pq);
+    }
+    for (int v = 0; v < g->n; v++) dist[v] = best[v] == UINT32_MAX ? -1 : (double)best[v];
+    free(best);
+    bq_free(pq);
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int count_mismatches(const double *a, const double *b, int n) {
+    int mismatches = 0;
+    for (int v = 0; v < n; v++) {
+        if (a[v] != b[v]) mismatches++;
+    }
+    return mismatches;
+}
+
+static void print_row(const char *method, double seconds, const HeapStats *st, int mismatches) {
+    printf("%-22s %9.3f %12ld %12ld %12ld %11d\n", method, seconds, st->pushes, st->pops, st->peak, mismatches);
+}
+
+// Run every queue on g and compare distances with the indexed heap
+// 在g上运行所有队列，并与索引堆的结果比对
+static void run_all(const WeightedGraph *g, uint32_t max_weight) {
+    int n = g->n;
+    double *reference = (double*)malloc(n * sizeof(double));
+    double *dist = (double*)malloc(n * sizeof(double));
+    HeapStats st;
+
+    printf("%-22s %9s %12s %12s %12s %11s\n", "method", "time(s)", "heap ops in", "pops", "peak size", "mismatches");
+
+    clock_t start = clock();
+    dijkstra_indexed(g, 0, reference, &st);
+    print_row("indexed decrease-key", seconds_since(start), &st, 0);
+
+    start = clock();
+    dijkstra_lazy(g, 0, dist, &st);
+    print_row("lazy deletion", seconds_since(start), &st, count_mismatches(reference, dist, n));
+
+    start = clock();
+    dijkstra_radix(g, 0, dist, &st);
+    print_row("radix heap", seconds_since(start), &st, count_mismatches(reference, dist, n));
+
+    start = clock();
+    dijkstra_bucket(g, 0, max_weight, dist, &st);
+    print_row("bucket queue", seconds_since(start), &st, count_mismatches(reference, dist, n));
+
+    free(reference);
+    free(dist);
+}
+
+int main() {
+    WeightedGraph g;
+    printf("Graph: %d vertices, %d edges\n", NUM_VERTICES, NUM_VERTICES * OUT_DEGREE);
+    graph_build(&g, NUM_VERTICES, OUT_DEGREE);
+
+    printf("\nWeights 1..%d (Dijkstra):\n", MAX_WEIGHT);
+    run_all(&g, MAX_WEIGHT);
+
+    // 所有边权设为1，相当于BFS
+    // Unit weights: the same search becomes a BFS
+    for (int e = 0; e < NUM_VERTICES * OUT_DEGREE; e++) g.weights[e] = 1;
+    printf("\nUnit weights (BFS):\n");
+    run_all(&g, 1);
+
+    graph_release(&g);
+    return 0;
+}
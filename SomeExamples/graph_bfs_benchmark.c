@@ -0,0 +1,207 @@
+#include "graph.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// RMAT 合成图上的 CSR 构建、广度优先搜索与连通分量：串行 vs 并行构建，
+// 自顶向下 vs 方向优化 vs 并行 BFS，串行 vs 并行 Afforest
+// CSR build, BFS and connected components on synthetic RMAT graphs: sequential
+// vs parallel build, top-down vs direction-optimizing vs parallel BFS,
+// sequential vs parallel Afforest
+// Build: cc -O2 -pthread -I../DataStructure graph_bfs_benchmark.c
+// Usage: ./a.out [scale] [edge factor]   (2^scale vertices, default 20 and 16)
+
+#define SOURCES 8
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+// Graph500 RMAT 参数 a=0.57, b=0.19, c=0.19, d=0.05，顶点编号随机打乱
+// Graph500 RMAT parameters a=0.57, b=0.19, c=0.19, d=0.05, vertex ids shuffled
+static GraphEdge *rmat_edges(int scale, size_t num_edges) {
+    uint32_t n = (uint32_t)1 << scale;
+    uint32_t *label = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    GraphEdge *edges = (GraphEdge*)malloc(num_edges * sizeof(GraphEdge));
+    if (!label || !edges) {
+        free(label);
+        free(edges);
+        return NULL;
+    }
+    for (uint32_t v = 0; v < n; v++) label[v] = v;
+    for (uint32_t v = n - 1; v > 0; v--) {
+        uint32_t j = (uint32_t)(next_rand() % (v + 1));
+        uint32_t t = label[v]; label[v] = label[j]; label[j] = t;
+    }
+    const uint32_t a = 57 * 10486, ab = 76 * 10486, abc = 95 * 10486;  // out of 2^20
+    for (size_t i = 0; i < num_edges; i++) {
+        uint32_t src = 0, dst = 0;
+        for (int bit = 0; bit < scale; bit++) {
+            uint32_t r = (uint32_t)(next_rand() >> 44);
+            src <<= 1; dst <<= 1;
+            if (r >= abc) { src |= 1; dst |= 1; }
+            else if (r >= ab) src |= 1;
+            else if (r >= a) dst |= 1;
+        }
+        edges[i].src = label[src];
+        edges[i].dst = label[dst];
+    }
+    free(label);
+    return edges;
+}
+
+// 参照：按顶点编号顺序逐个做 BFS 标号，标号为分量中最小的顶点
+// Reference: label by BFS from each unlabeled vertex in id order, so the
+// label is the smallest vertex of the component
+static void reference_components(const Graph *g, uint32_t *label, uint32_t *queue) {
+    uint32_t n = graph_num_vertices(g);
+    for (uint32_t v = 0; v < n; v++) label[v] = GRAPH_NO_VERTEX;
+    for (uint32_t s = 0; s < n; s++) {
+        if (label[s] != GRAPH_NO_VERTEX) continue;
+        size_t head = 0, tail = 0;
+        queue[tail++] = s;
+        label[s] = s;
+        while (head < tail) {
+            uint64_t count;
+            const uint32_t *nb = graph_neighbors(g, queue[head++], &count);
+            for (uint64_t i = 0; i < count; i++) {
+                if (label[nb[i]] == GRAPH_NO_VERTEX) {
+                    label[nb[i]] = s;
+                    queue[tail++] = nb[i];
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int scale = argc > 1 ? atoi(argv[1]) : 20;
+    int edge_factor = argc > 2 ? atoi(argv[2]) : 16;
+    if (scale < 1 || scale > 31 || edge_factor < 1) {
+        fprintf(stderr, "Usage: %s [scale 1..31] [edge factor]\n", argv[0]);
+        return 1;
+    }
+    uint32_t n = (uint32_t)1 << scale;
+    size_t m = (size_t)n * (size_t)edge_factor;
+
+    double start = now_seconds();
+    GraphEdge *edges = rmat_edges(scale, m);
+    if (!edges) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    printf("RMAT scale %d: %u vertices, %zu undirected edges (generated in %.2f s)\n\n",
+           scale, n, m, now_seconds() - start);
+
+    start = now_seconds();
+    Graph *g = graph_create(n, edges, m, true, NULL);
+    double t_seq = now_seconds() - start;
+    if (!g) {
+        fprintf(stderr, "Failed to build graph\n");
+        return 1;
+    }
+    graph_free(g);
+
+    TaskScheduler *sched = task_scheduler_create(0);
+    if (!sched) {
+        fprintf(stderr, "Failed to create scheduler\n");
+        return 1;
+    }
+    start = now_seconds();
+    g = graph_create(n, edges, m, true, sched);
+    double t_par = now_seconds() - start;
+    free(edges);
+    if (!g) {
+        fprintf(stderr, "Failed to build graph\n");
+        return 1;
+    }
+    printf("CSR build, sequential           : %8.3f s\n", t_seq);
+    printf("CSR build, %2d workers           : %8.3f s (speedup %.2fx)\n\n",
+           task_scheduler_num_workers(sched), t_par, t_seq / t_par);
+
+    int32_t *dist_td = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+    int32_t *dist_do = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+    uint32_t *parent = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    int32_t *dist_par = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+    double t_td = 0, t_do = 0, t_par_bfs = 0;
+    uint64_t traversed = 0;
+    int runs = 0, mismatches = 0;
+    for (int r = 0; runs < SOURCES && r < 64 * SOURCES; r++) {
+        // 跳过孤立顶点 / skip isolated vertices
+        uint32_t source = (uint32_t)(next_rand() % n);
+        if (graph_out_degree(g, source) == 0) continue;
+
+        start = now_seconds();
+        graph_bfs_top_down(g, source, dist_td, NULL);
+        t_td += now_seconds() - start;
+
+        start = now_seconds();
+        graph_bfs(g, source, dist_do, parent);
+        t_do += now_seconds() - start;
+
+        start = now_seconds();
+        graph_bfs_parallel(g, source, dist_par, parent, sched);
+        t_par_bfs += now_seconds() - start;
+
+        // TEPS 按 Graph500 计：所到达连通分量的无向边数
+        // TEPS as in Graph500: undirected edges in the reached component
+        uint64_t arcs = 0;
+        for (uint32_t v = 0; v < n; v++) {
+            if (dist_td[v] >= 0) arcs += graph_out_degree(g, v);
+            if (dist_td[v] != dist_do[v] || dist_td[v] != dist_par[v]) mismatches++;
+        }
+        traversed += arcs / 2;
+        runs++;
+    }
+
+    printf("BFS from %d sources             time/search   MTEPS\n", runs);
+    printf("top-down (queue)                : %8.3f s  %8.1f\n", t_td / runs, traversed / t_td * 1e-6);
+    printf("direction-optimizing            : %8.3f s  %8.1f (speedup %.2fx)\n",
+           t_do / runs, traversed / t_do * 1e-6, t_td / t_do);
+    printf("parallel, %2d workers            : %8.3f s  %8.1f (speedup %.2fx)\n",
+           task_scheduler_num_workers(sched), t_par_bfs / runs, traversed / t_par_bfs * 1e-6, t_td / t_par_bfs);
+    printf("distances %s\n\n", mismatches ? "DIFFER" : "match");
+
+    uint32_t *label_ref = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    uint32_t *label = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    start = now_seconds();
+    reference_components(g, label_ref, parent);
+    double t_ref = now_seconds() - start;
+    uint32_t components = 0;
+    for (uint32_t v = 0; v < n; v++) components += label_ref[v] == v;
+    printf("connected components: %u\n", components);
+    printf("BFS labeling                    : %8.3f s\n", t_ref);
+
+    start = now_seconds();
+    graph_connected_components(g, label, NULL);
+    double t_cc = now_seconds() - start;
+    mismatches = memcmp(label, label_ref, (size_t)n * sizeof(uint32_t)) != 0;
+    printf("Afforest, sequential            : %8.3f s (speedup %.2fx)\n", t_cc, t_ref / t_cc);
+
+    start = now_seconds();
+    graph_connected_components(g, label, sched);
+    t_cc = now_seconds() - start;
+    mismatches |= memcmp(label, label_ref, (size_t)n * sizeof(uint32_t)) != 0;
+    printf("Afforest, %2d workers            : %8.3f s (speedup %.2fx)\n",
+           task_scheduler_num_workers(sched), t_cc, t_ref / t_cc);
+    printf("labels %s\n", mismatches ? "DIFFER" : "match");
+
+    free(label_ref);
+    free(label);
+    free(dist_td);
+    free(dist_do);
+    free(dist_par);
+    free(parent);
+    graph_free(g);
+    task_scheduler_destroy(sched);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include "keyed_priority_queue.h"
+#include <stdio.h>
+
+// 按截止时间调度任务：键为截止时间，负载为任务结构体本身
+// Schedule jobs by deadline: the key is the deadline, the payload is the job itself
+
+typedef struct {
+    int id;
+    const char *name;
+} Job;
+
+// 最小堆：截止时间越早越先执行
+KEYED_PQ_DEFINE(JobQueue, double, Job, KEYED_PQ_LESS)
+
+// 最大堆：按整型优先级，值越大越先处理
+KEYED_PQ_DEFINE(MaxIntQueue, int, const char*, KEYED_PQ_GREATER)
+
+int main() {
+    JobQueue queue;
+    if (!JobQueue_init(&queue, 8)) {
+        fprintf(stderr, "Memory allocation failed!\n");
+        return 1;
+    }
+
+    Job jobs[] = {
+        { 1, "backup" }, { 2, "send report" }, { 3, "rotate logs" }, { 4, "renew cert" }
+    };
+    double deadlines[] = { 30.0, 5.5, 12.0, 1.0 };
+    for (int i = 0; i < 4; i++) {
+        if (!JobQueue_push(&queue, deadlines[i], jobs[i])) {
+            fprintf(stderr, "Memory allocation failed!\n");
+        }
+    }
+
+    printf("Next deadline: %.1f (%s)\n", JobQueue_top(&queue)->key, JobQueue_top(&queue)->payload.name);
+
+    double deadline;
+    Job job;
+    while (JobQueue_pop(&queue, &deadline, &job)) {
+        printf("t=%5.1f  job %d: %s\n", deadline, job.id, job.name);
+    }
+
+    // 空队列不会返回哨兵值，而是返回false
+    if (!JobQueue_pop(&queue, &deadline, &job)) {
+        printf("Queue is empty\n");
+    }
+    JobQueue_destroy(&queue);
+
+    MaxIntQueue *levels = MaxIntQueue_create(0);
+    MaxIntQueue_push(levels, 2, "warning");
+    MaxIntQueue_push(levels, 5, "fatal");
+    MaxIntQueue_push(levels, 1, "info");
+    int level;
+    const char *label;
+    while (MaxIntQueue_pop(levels, &level, &label)) {
+        printf("level %d: %s\n", level, label);
+    }
+    MaxIntQueue_free(levels);
+    return 0;
+}
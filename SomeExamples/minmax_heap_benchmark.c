@@ -0,0 +1,108 @@
+#include "minmax_heap.h"
+#include "priority_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 有界Top-K缓冲区：保留数据流中最小的K个值
+// Bounded top-K buffer: keep the K smallest values of a stream
+//
+// PriorityQueue: pq_back (O(n) leaf scan) rejects values that are not better
+//   than the current worst; accepted values are pushed, and when the queue
+//   reaches 2K the K best are popped into a fresh queue (amortized eviction).
+// MinMaxHeap: mmh_push_bounded compares against the O(1) maximum and replaces
+//   it in O(log K).
+
+#define N 5000000
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+// Top-K with PriorityQueue; leaves the K smallest sorted in out
+// 使用PriorityQueue的Top-K，结果按升序写入out
+static void topk_pq(const int *values, int n, int k, int *out) {
+    PriorityQueue *pq = pq_create();
+    for (int i = 0; i < n; i++) {
+        if (pq_size(pq) >= k && values[i] >= pq_back(pq)) continue;
+        pq_push(pq, values[i]);
+        if (pq_size(pq) >= 2 * k) {
+            PriorityQueue *kept = pq_create();
+            for (int j = 0; j < k; j++) pq_push(kept, pq_pop(pq));
+            pq_free(pq);
+            pq = kept;
+        }
+    }
+    for (int j = 0; j < k && !pq_empty(pq); j++) out[j] = pq_pop(pq);
+    pq_free(pq);
+}
+
+// Top-K with MinMaxHeap; leaves the K smallest sorted in out
+// 使用MinMaxHeap的Top-K，结果按升序写入out
+static void topk_mmh(const int *values, int n, int k, int *out) {
+    MinMaxHeap *h = mmh_create(k);
+    for (int i = 0; i < n; i++) {
+        mmh_push_bounded(h, values[i], k, NULL);
+    }
+    for (int j = 0; j < k && mmh_pop_min(h, &out[j]); j++) {}
+    mmh_free(h);
+}
+
+int main() {
+    int *values = (int*)malloc(N * sizeof(int));
+    uint32_t x = 2463534242u;
+    for (int i = 0; i < N; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        // Slowly decreasing trend so the buffer keeps churning
+        // 整体缓慢下降的数据，使缓冲区持续更新
+        values[i] = (int)(x % 1000000) + (N - i) * 4;
+    }
+
+    int ks[] = { 64, 1024, 4096 };
+    printf("%8s %16s %16s %10s\n", "K", "PriorityQueue", "MinMaxHeap", "speedup");
+    for (size_t t = 0; t < sizeof(ks) / sizeof(ks[0]); t++) {
+        int k = ks[t];
+        int *a = (int*)malloc((size_t)k * sizeof(int));
+        int *b = (int*)malloc((size_t)k * sizeof(int));
+
+        clock_t start = clock();
+        topk_pq(values, N, k, a);
+        double t_pq = seconds_since(start);
+
+        start = clock();
+        topk_mmh(values, N, k, b);
+        double t_mmh = seconds_since(start);
+
+        int same = memcmp(a, b, (size_t)k * sizeof(int)) == 0;
+        printf("%8d %14.3f s %14.3f s %9.1fx%s\n", k, t_pq, t_mmh, t_pq / t_mmh,
+               same ? "" : "  (MISMATCH)");
+        free(a);
+        free(b);
+    }
+
+    // 双端使用：交替弹出最小值和最大值
+    // Double-ended use: alternately pop the minimum and the maximum
+    MinMaxHeap *h = mmh_create(0);
+    for (int i = 0; i < N; i++) mmh_push(h, values[i]);
+    int *sorted = (int*)malloc(N * sizeof(int));
+    memcpy(sorted, values, N * sizeof(int));
+    qsort(sorted, N, sizeof(int), cmp_int);
+    int lo = 0, hi = N - 1, ok = 1, v;
+    clock_t start = clock();
+    while (!mmh_empty(h)) {
+        if (mmh_pop_min(h, &v) && v != sorted[lo++]) ok = 0;
+        if (mmh_pop_max(h, &v) && v != sorted[hi--]) ok = 0;
+    }
+    printf("\nAlternating pop_min/pop_max of %d elements: %.3f s%s\n",
+           N, seconds_since(start), ok ? "" : "  (ORDER ERROR)");
+    mmh_free(h);
+    free(sorted);
+    free(values);
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include "keyed_priority_queue.h"
+#include "multi_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+
+// 吞吐量与质量：互斥锁保护的单个堆 vs MultiQueue（每线程c个堆）
+// Throughput vs quality: one mutex-protected heap vs MultiQueue (c heaps per thread)
+// Build: cc -O2 -pthread -I../DataStructure multi_queue_benchmark.c
+//
+// Throughput: the queue is prefilled, then every thread alternates push/pop.
+// Quality: pops are replayed from p handles in turn and the rank of every
+// popped key among the keys still queued is measured exactly (0 = true min).
+
+#define PREFILL        1000000
+#define OPS_PER_THREAD 1000000
+#define MAX_THREADS    16
+#define QUALITY_KEYS   1000000
+
+KEYED_PQ_DEFINE(LockedHeap, uint64_t, void*, KEYED_PQ_LESS)
+
+typedef struct {
+    int mode;           // 0 = mutex heap, otherwise the MultiQueue factor c
+    int id;
+    uint64_t popped;    // Sum of popped keys, checked against pushed keys
+    uint64_t pushed;
+} Worker;
+
+static LockedHeap locked_heap;
+static pthread_mutex_t heap_lock = PTHREAD_MUTEX_INITIALIZER;
+static MultiQueue* mq;
+
+static uint32_t next_rand(uint32_t* s) {
+    uint32_t x = *s;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    return *s = x;
+}
+
+static void* worker_main(void* arg) {
+    Worker* w = (Worker*)arg;
+    MultiQueueHandle h;
+    if (w->mode) multi_queue_handle_init(&h, mq, (uint32_t)w->id + 1);
+    uint32_t seed = 2463534242u + (uint32_t)w->id * 7919u;
+    uint64_t key;
+    for (long i = 0; i < OPS_PER_THREAD; i++) {
+        uint64_t k = next_rand(&seed) % 100000000u;
+        w->pushed += k;
+        if (w->mode == 0) {
+            pthread_mutex_lock(&heap_lock);
+            LockedHeap_push(&locked_heap, k, NULL);
+            LockedHeap_pop(&locked_heap, &key, NULL);
+            pthread_mutex_unlock(&heap_lock);
+        } else {
+            multi_queue_push(&h, k, NULL);
+            multi_queue_pop(&h, &key, NULL);
+        }
+        w->popped += key;
+    }
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Returns seconds; *balanced is set if every key pushed was popped exactly once
+// 返回耗时；所有键恰好被弹出一次时*balanced为1
+static double run(int mode, int threads, int* balanced) {
+    pthread_t tid[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    uint32_t seed = 88172645u;
+    uint64_t prefill_sum = 0;
+
+    if (mode == 0) {
+        LockedHeap_init(&locked_heap, PREFILL + 1024);
+    } else {
+        mq = multi_queue_create((uint32_t)threads, (uint32_t)mode);
+    }
+    MultiQueueHandle h;
+    if (mode) multi_queue_handle_init(&h, mq, 12345);
+    for (int i = 0; i < PREFILL; i++) {
+        uint64_t k = next_rand(&seed) % 100000000u;
+        prefill_sum += k;
+        if (mode == 0) LockedHeap_push(&locked_heap, k, NULL);
+        else multi_queue_push(&h, k, NULL);
+    }
+
+    double start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        memset(&workers[t], 0, sizeof(Worker));
+        workers[t].mode = mode;
+        workers[t].id = t;
+        pthread_create(&tid[t], NULL, worker_main, &workers[t]);
+    }
+    uint64_t pushed = prefill_sum, popped = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(tid[t], NULL);
+        pushed += workers[t].pushed;
+        popped += workers[t].popped;
+    }
+    double elapsed = now_seconds() - start;
+
+    uint64_t key;
+    if (mode == 0) {
+        while (LockedHeap_pop(&locked_heap, &key, NULL)) popped += key;
+        LockedHeap_destroy(&locked_heap);
+    } else {
+        while (multi_queue_pop(&h, &key, NULL)) popped += key;
+        multi_queue_free(mq);
+    }
+    *balanced = pushed == popped;
+    return elapsed;
+}
+
+/* ---- Quality: exact rank error with a Fenwick tree over the key space ---- */
+
+static int fenwick[QUALITY_KEYS + 1];
+
+static void fenwick_add(int i, int delta) {
+    for (i++; i <= QUALITY_KEYS; i += i & -i) fenwick[i] += delta;
+}
+
+// Number of present keys < i (当前存在的小于i的键的数量)
+static int fenwick_prefix(int i) {
+    int s = 0;
+    for (; i > 0; i -= i & -i) s += fenwick[i];
+    return s;
+}
+
+static void measure_quality(int threads, int factor, double* mean, int* max) {
+    MultiQueue* q = multi_queue_create((uint32_t)threads, (uint32_t)factor);
+    MultiQueueHandle handles[64];
+    for (int t = 0; t < threads; t++) multi_queue_handle_init(&handles[t], q, (uint32_t)t + 1);
+    memset(fenwick, 0, sizeof(fenwick));
+
+    // Distinct keys 0..QUALITY_KEYS-1 in random order (随机顺序的不同键)
+    int* keys = (int*)malloc(QUALITY_KEYS * sizeof(int));
+    uint32_t seed = 2463534242u;
+    for (int i = 0; i < QUALITY_KEYS; i++) keys[i] = i;
+    for (int i = QUALITY_KEYS - 1; i > 0; i--) {
+        int j = (int)(next_rand(&seed) % (uint32_t)(i + 1));
+        int tmp = keys[i]; keys[i] = keys[j]; keys[j] = tmp;
+    }
+    for (int i = 0; i < QUALITY_KEYS; i++) {
+        multi_queue_push(&handles[i % threads], (uint64_t)keys[i], NULL);
+        fenwick_add(keys[i], 1);
+    }
+
+    // Pop half of the keys, the handles taking turns (各句柄轮流弹出一半的键)
+    long long total = 0;
+    *max = 0;
+    int pops = QUALITY_KEYS / 2;
+    for (int i = 0; i < pops; i++) {
+        uint64_t k;
+        multi_queue_pop(&handles[i % threads], &k, NULL);
+        int rank = fenwick_prefix((int)k);
+        fenwick_add((int)k, -1);
+        total += rank;
+        if (rank > *max) *max = rank;
+    }
+    *mean = (double)total / pops;
+    free(keys);
+    multi_queue_free(q);
+}
+
+int main() {
+    int thread_counts[] = { 1, 2, 4, 8 };
+    int modes[] = { 0, 2, 4 };
+
+    printf("Throughput (push+pop pairs, %d per thread, %d prefilled):\n", OPS_PER_THREAD, PREFILL);
+    printf("%-18s %8s %10s %12s\n", "queue", "threads", "time(s)", "Mops/s");
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+            int threads = thread_counts[t];
+            int balanced;
+            double s = run(modes[m], threads, &balanced);
+            char name[32];
+            if (modes[m] == 0) snprintf(name, sizeof(name), "mutex heap");
+            else snprintf(name, sizeof(name), "MultiQueue c=%d", modes[m]);
+            printf("%-18s %8d %10.3f %12.2f%s\n", name, threads, s,
+                   2.0 * OPS_PER_THREAD * threads / s / 1e6, balanced ? "" : "  (LOST ELEMENTS)");
+        }
+    }
+
+    printf("\nQuality (rank of popped key among queued keys, %d keys):\n", QUALITY_KEYS);
+    printf("%8s %4s %8s %12s %10s\n", "threads", "c", "heaps", "mean rank", "max rank");
+    int quality_threads[] = { 1, 4, 16, 64 };
+    for (size_t t = 0; t < sizeof(quality_threads) / sizeof(quality_threads[0]); t++) {
+        for (int c = 2; c <= 4; c += 2) {
+            double mean;
+            int max;
+            measure_quality(quality_threads[t], c, &mean, &max);
+            printf("%8d %4d %8d %12.2f %10d\n", quality_threads[t], c, quality_threads[t] * c, mean, max);
+        }
+    }
+    return 0;
+}
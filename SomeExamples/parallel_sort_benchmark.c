@@ -0,0 +1,63 @@
+#include "parallel_sort.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 工作窃取调度器上的并行快速排序 vs 串行quicksort
+// Parallel quicksort on the work-stealing scheduler vs sequential quicksort
+// Build: cc -O2 -pthread -I../DataStructure -I../Algorithm parallel_sort_benchmark.c
+
+#define N 10000000
+
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static int is_sorted(const int *a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        if (a[i - 1] > a[i]) return 0;
+    }
+    return 1;
+}
+
+int main() {
+    int *data = (int*)malloc(N * sizeof(int));
+    int *copy = (int*)malloc(N * sizeof(int));
+    uint32_t x = 2463534242u;
+    for (size_t i = 0; i < N; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        data[i] = (int)(x & 0x7fffffff);
+    }
+
+    memcpy(copy, data, N * sizeof(int));
+    double start = now_seconds();
+    quicksort(copy, N, sizeof(int), compare_int);
+    double t_seq = now_seconds() - start;
+    printf("quicksort            : %8.3f s (%s)\n", t_seq, is_sorted(copy, N) ? "sorted" : "NOT sorted");
+
+    TaskScheduler *sched = task_scheduler_create(0);
+    if (!sched) {
+        fprintf(stderr, "Failed to create scheduler\n");
+        return 1;
+    }
+    memcpy(copy, data, N * sizeof(int));
+    start = now_seconds();
+    parallel_quicksort(sched, copy, N, sizeof(int), compare_int);
+    double t_par = now_seconds() - start;
+    printf("parallel_quicksort   : %8.3f s (%s, %d workers)\n", t_par,
+           is_sorted(copy, N) ? "sorted" : "NOT sorted", task_scheduler_num_workers(sched));
+    printf("speedup              : %8.2fx\n", t_seq / t_par);
+
+    task_scheduler_destroy(sched);
+    free(data);
+    free(copy);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "priority_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// 比较不同分支数(2/4/8/16)的堆在10^7级元素下的插入与弹出吞吐量
+// Compare push/pop throughput of 2-, 4-, 8- and 16-ary heaps with 10^7 elements
+// Build with -O2 -march=native (or -mavx2) to enable the SIMD min-of-children path
+
+#define N 10000000
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main() {
+    int arities[] = { 2, 4, 8, 16 };
+    int *values = (int*)malloc(N * sizeof(int));
+    uint32_t x = 2463534242u;
+    for (int i = 0; i < N; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        values[i] = (int)(x & 0x7fffffff);
+    }
+
+#if defined(__AVX2__)
+    printf("SIMD child selection: AVX2\n");
+#elif defined(__SSE4_1__)
+    printf("SIMD child selection: SSE4.1 (4-ary only)\n");
+#else
+    printf("SIMD child selection: none (scalar)\n");
+#endif
+    printf("%6s %12s %12s %14s\n", "arity", "push (s)", "pop (s)", "pop Mops/s");
+
+    for (size_t a = 0; a < sizeof(arities) / sizeof(arities[0]); a++) {
+        PriorityQueue *pq = pq_create_with_arity(arities[a]);
+        if (!pq) return 1;
+
+        clock_t start = clock();
+        for (int i = 0; i < N; i++) pq_push(pq, values[i]);
+        double t_push = seconds_since(start);
+
+        start = clock();
+        int prev = INT_MIN, ordered = 1;
+        while (!pq_empty(pq)) {
+            int v = pq_pop(pq);
+            if (v < prev) ordered = 0;
+            prev = v;
+        }
+        double t_pop = seconds_since(start);
+
+        printf("%6d %12.3f %12.3f %14.2f%s\n", arities[a], t_push, t_pop,
+               N / t_pop / 1e6, ordered ? "" : "  (ORDER ERROR)");
+        pq_free(pq);
+    }
+
+    // 构建：N次pq_push vs Floyd自底向上建堆
+    // Construction: N calls to pq_push vs Floyd bottom-up heapify
+    clock_t start = clock();
+    PriorityQueue *pq = pq_create();
+    for (int i = 0; i < N; i++) pq_push(pq, values[i]);
+    double t_push = seconds_since(start);
+    pq_free(pq);
+
+    start = clock();
+    pq = pq_create_from_array(values, N);
+    double t_heapify = seconds_since(start);
+    int front = pq ? pq_front(pq) : 0;
+    pq_free(pq);
+
+    printf("\nBuild %d elements:\n", N);
+    printf("  repeated pq_push     : %8.3f s\n", t_push);
+    printf("  pq_create_from_array : %8.3f s (front %d)\n", t_heapify, front);
+
+    // 小队列在空与两个元素之间反复：下限为1时每轮缩容一次、扩容一次（旧行为）
+    // A small queue going between empty and two elements: with a floor of 1
+    // every round shrinks once and grows once (the old behaviour)
+    const int rounds = 20000000;
+    const char *modes[] = { "floor 1 (old)", "floor PQ_MIN_CAPACITY", "shrink off" };
+    printf("\nSmall-queue oscillation, %d rounds of push, push, pop, pop:\n", rounds);
+    for (int m = 0; m < 3; m++) {
+        pq = pq_create();
+        if (m == 0) pq->min_capacity = 1;
+        if (m == 2) pq_set_shrink(pq, false);
+        int resizes = 0, last_capacity = pq->capacity;
+        start = clock();
+        for (int r = 0; r < rounds; r++) {
+            for (int op = 0; op < 4; op++) {
+                if (op < 2) pq_push(pq, values[(r + op) % N]);
+                else pq_pop(pq);
+                if (pq->capacity != last_capacity) resizes++;
+                last_capacity = pq->capacity;
+            }
+        }
+        printf("  %-22s: %8.3f s (%d resizes)\n", modes[m], seconds_since(start), resizes);
+        pq_free(pq);
+    }
+
+    free(values);
+    return 0;
+}
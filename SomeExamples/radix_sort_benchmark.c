@@ -0,0 +1,122 @@
+#include "radix_sort.h"
+#include "sort.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 基数排序 vs 比较排序（quicksort / qsort）
+// Radix sort vs comparison sorts (quicksort from sort.h and the C library qsort)
+// Build: cc -O2 -I../Algorithm radix_sort_benchmark.c
+// Usage: ./a.out [n]   (default 10^7; 10^8 needs about 2.5 GB)
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_string(const void *a, const void *b) {
+    return strcmp(*(char *const*)a, *(char *const*)b);
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+typedef bool (*radix_fn)(void*, size_t);
+
+static bool radix_u32(void *a, size_t n) { return radix_sort_u32((uint32_t*)a, n); }
+static bool radix_u64(void *a, size_t n) { return radix_sort_u64((uint64_t*)a, n); }
+static bool radix_f64(void *a, size_t n) { return radix_sort_f64((double*)a, n); }
+static bool radix_str(void *a, size_t n) { return radix_sort_strings((char**)a, n); }
+
+// Times radix sort, quicksort and qsort on copies of `data` and checks that
+// all three agree
+static void run(const char *name, const void *data, size_t n, size_t size,
+                radix_fn radix, int (*compar)(const void*, const void*)) {
+    char *copy = (char*)malloc(n * size);
+    char *expect = (char*)malloc(n * size);
+    if (!copy || !expect) {
+        printf("%-16s out of memory\n", name);
+        free(copy);
+        free(expect);
+        return;
+    }
+
+    memcpy(copy, data, n * size);
+    clock_t start = clock();
+    radix(copy, n);
+    double t_radix = seconds_since(start);
+
+    memcpy(expect, data, n * size);
+    start = clock();
+    quicksort(expect, n, size, compar);
+    double t_quick = seconds_since(start);
+    int ok = 1;
+    for (size_t i = 0; i < n && ok; i++) ok = compar(copy + i * size, expect + i * size) == 0;
+
+    memcpy(expect, data, n * size);
+    start = clock();
+    qsort(expect, n, size, compar);
+    double t_qsort = seconds_since(start);
+
+    printf("%-16s %9.3f s %9.3f s %9.3f s %7.1fx%s\n", name, t_radix, t_quick, t_qsort,
+           t_quick / (t_radix > 0 ? t_radix : 1e-9), ok ? "" : "  (MISMATCH)");
+    free(copy);
+    free(expect);
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 10000000;
+    printf("%zu keys\n", n);
+    printf("%-16s %11s %11s %11s %8s\n", "keys", "radix", "quicksort", "qsort", "speedup");
+
+    uint32_t *u32 = (uint32_t*)malloc(n * sizeof(uint32_t));
+    for (size_t i = 0; i < n; i++) u32[i] = (uint32_t)next_rand();
+    run("u32 random", u32, n, sizeof(uint32_t), radix_u32, compare_u32);
+    free(u32);
+
+    uint64_t *u64 = (uint64_t*)malloc(n * sizeof(uint64_t));
+    for (size_t i = 0; i < n; i++) u64[i] = next_rand();
+    run("u64 random", u64, n, sizeof(uint64_t), radix_u64, compare_u64);
+    // 只有低 3 字节不同的键：常量位被跳过
+    // Keys that differ only in their low 3 bytes: constant digits are skipped
+    for (size_t i = 0; i < n; i++) u64[i] = 0x5a00000000000000ull | (next_rand() & 0xffffff);
+    run("u64 24-bit", u64, n, sizeof(uint64_t), radix_u64, compare_u64);
+    free(u64);
+
+    double *f64 = (double*)malloc(n * sizeof(double));
+    for (size_t i = 0; i < n; i++) f64[i] = ((double)(next_rand() >> 11) / 9007199254740992.0 - 0.5) * 1e6;
+    run("double", f64, n, sizeof(double), radix_f64, compare_double);
+    free(f64);
+
+    // 字符串数量较少：比较排序每次比较都要从头扫描公共前缀
+    // Fewer strings: every comparison rescans the common prefix
+    size_t ns = n / 10;
+    char **strs = (char**)malloc(ns * sizeof(char*));
+    char *pool = (char*)malloc(ns * 32);
+    for (size_t i = 0; i < ns; i++) {
+        strs[i] = pool + i * 32;
+        snprintf(strs[i], 32, "user/%08llu/item", (unsigned long long)(next_rand() % (ns * 4)));
+    }
+    run("strings (n/10)", strs, ns, sizeof(char*), radix_str, compare_string);
+    free(strs);
+    free(pool);
+    return 0;
+}
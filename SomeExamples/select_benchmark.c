@@ -0,0 +1,110 @@
+#include "select.h"
+#include "priority_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 只需要前 K 个或中位数：选择算法 vs 全排序 / PriorityQueue
+// Only the top K or the median is needed: selection vs full sort / PriorityQueue
+// Build: cc -O2 -I../DataStructure -I../Algorithm select_benchmark.c -lm
+// Usage: ./a.out [n]   (default 10^7)
+
+#define K 100
+
+static int compare_float(const void *a, const void *b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+// 降序，用于取最大的 K 个 / descending, for the K largest
+static int compare_float_desc(const void *a, const void *b) {
+    return compare_float(b, a);
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng;
+}
+
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)strtoull(argv[1], NULL, 10) : 10000000;
+    float *data = (float*)malloc(n * sizeof(float));
+    float *copy = (float*)malloc(n * sizeof(float));
+    // 整数值的浮点数，以便 PriorityQueue(int) 给出相同答案
+    // Integer-valued floats, so the int PriorityQueue gives the same answer
+    for (size_t i = 0; i < n; i++) data[i] = (float)(next_rand() >> 8);
+
+    printf("%zu float keys\n\n", n);
+    printf("top %d (checksum = sum of the K largest keys)\n", K);
+    printf("%-28s %9s %16s\n", "method", "time(s)", "checksum");
+
+    memcpy(copy, data, n * sizeof(float));
+    clock_t start = clock();
+    quicksort(copy, n, sizeof(float), compare_float_desc);
+    double t = seconds_since(start);
+    double expected = 0;
+    for (int i = 0; i < K; i++) expected += copy[i];
+    printf("%-28s %9.3f %16.0f\n", "quicksort (full sort)", t, expected);
+
+    start = clock();
+    PriorityQueue *pq = pq_create();
+    for (size_t i = 0; i < n; i++) pq_push(pq, -(int)data[i]);
+    double sum = 0;
+    for (int i = 0; i < K; i++) sum -= pq_pop(pq);
+    t = seconds_since(start);
+    pq_free(pq);
+    printf("%-28s %9.3f %16.0f\n", "PriorityQueue (push all)", t, sum);
+
+    memcpy(copy, data, n * sizeof(float));
+    start = clock();
+    partial_sort(copy, n, K, sizeof(float), compare_float_desc);
+    t = seconds_since(start);
+    sum = 0;
+    for (int i = 0; i < K; i++) sum += copy[i];
+    printf("%-28s %9.3f %16.0f\n", "partial_sort", t, sum);
+
+    TopK *tk = topk_create(K);
+    TopKItem items[K];
+    start = clock();
+    for (size_t i = 0; i < n; i++) topk_push(tk, data[i], i);
+    t = seconds_since(start);
+    sum = 0;
+    size_t got = topk_extract(tk, items);
+    for (size_t i = 0; i < got; i++) sum += items[i].key;
+    printf("%-28s %9.3f %16.0f\n", "TopK, topk_push per key", t, sum);
+
+    // 分块输入，模拟数据流 / fed in chunks, as a stream would arrive
+    start = clock();
+    for (size_t i = 0; i < n; i += 4096) topk_push_array(tk, data + i, n - i < 4096 ? n - i : 4096, i);
+    t = seconds_since(start);
+    sum = 0;
+    got = topk_extract(tk, items);
+    for (size_t i = 0; i < got; i++) sum += items[i].key;
+    printf("%-28s %9.3f %16.0f\n", "TopK, topk_push_array (SIMD)", t, sum);
+    topk_free(tk);
+
+    printf("\nmedian\n");
+    memcpy(copy, data, n * sizeof(float));
+    start = clock();
+    quicksort(copy, n, sizeof(float), compare_float);
+    t = seconds_since(start);
+    float median = copy[n / 2];
+    printf("%-28s %9.3f %16.0f\n", "quicksort", t, (double)median);
+
+    memcpy(copy, data, n * sizeof(float));
+    start = clock();
+    nth_element(copy, n, n / 2, sizeof(float), compare_float);
+    t = seconds_since(start);
+    printf("%-28s %9.3f %16.0f%s\n", "nth_element", t, (double)copy[n / 2],
+           copy[n / 2] == median ? "" : "  (MISMATCH)");
+
+    free(data);
+    free(copy);
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "shortest_path.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// 类道路网络合成图上的最短路径：Dijkstra(索引堆/基数堆)、delta-stepping、A*
+// Shortest paths on a synthetic road-like network: Dijkstra (indexed heap /
+// radix heap), delta-stepping and A*
+// Build: cc -O2 -pthread -I../DataStructure -I../Algorithm shortest_path_benchmark.c -lm
+// Usage: ./a.out [side]   (side x side intersections, default 1000)
+
+#define QUERIES 20
+#define HIGHWAY_SPACING 50
+
+// 每个路口的平面坐标(米)，供A*的直线距离下界使用
+// Planar coordinates of each intersection (meters), for the A* straight-line bound
+typedef struct {
+    int32_t *x;
+    int32_t *y;
+} Coordinates;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint64_t rng = 88172645463325252ull;
+static uint64_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+    return rng;
+}
+
+static double straight_line(const Coordinates *c, uint32_t u, uint32_t v) {
+    double dx = c->x[u] - c->x[v], dy = c->y[u] - c->y[v];
+    return sqrt(dx * dx + dy * dy);
+}
+
+// 抖动的网格：约5%的路段缺失，每隔50行/列是一条快速路(代价=长度)，
+// 其余道路代价为长度的2~4倍，因此直线距离永远不会高估
+// Jittered grid: about 5% of the road segments are missing, every 50th row
+// and column is a highway (cost = length), other roads cost 2-4x their
+// length, so the straight-line distance never overestimates
+static WeightedEdge *road_network(uint32_t side, Coordinates *c, size_t *num_edges) {
+    uint32_t n = side * side;
+    c->x = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+    c->y = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+    WeightedEdge *edges = (WeightedEdge*)malloc((size_t)n * 2 * sizeof(WeightedEdge));
+    if (!c->x || !c->y || !edges) return NULL;
+    for (uint32_t v = 0; v < n; v++) {
+        c->x[v] = (int32_t)(v % side) * 100 + (int32_t)(next_rand() % 60);
+        c->y[v] = (int32_t)(v / side) * 100 + (int32_t)(next_rand() % 60);
+    }
+    size_t m = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        uint32_t row = v / side, col = v % side;
+        for (int dir = 0; dir < 2; dir++) {
+            if (dir == 0 ? col + 1 == side : row + 1 == side) continue;
+            bool highway = dir == 0 ? row % HIGHWAY_SPACING == 0 : col % HIGHWAY_SPACING == 0;
+            if (!highway && next_rand() % 100 < 5) continue;
+            uint32_t u = dir == 0 ? v + 1 : v + side;
+            double factor = highway ? 1.0 : 2.0 + (double)(next_rand() % 3);
+            edges[m].src = v;
+            edges[m].dst = u;
+            edges[m].weight = (uint32_t)ceil(straight_line(c, v, u) * factor);
+            m++;
+        }
+    }
+    *num_edges = m;
+    return edges;
+}
+
+static uint64_t straight_line_bound(uint32_t v, uint32_t target, void *ctx) {
+    return (uint64_t)straight_line((const Coordinates*)ctx, v, target);
+}
+
+static int count_mismatches(const uint64_t *a, const uint64_t *b, uint32_t n) {
+    int mismatches = 0;
+    for (uint32_t v = 0; v < n; v++) mismatches += a[v] != b[v];
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    uint32_t side = argc > 1 ? (uint32_t)atoi(argv[1]) : 1000;
+    if (side < 2 || side > 40000) {
+        fprintf(stderr, "Usage: %s [side 2..40000]\n", argv[0]);
+        return 1;
+    }
+    uint32_t n = side * side;
+    Coordinates coords;
+    size_t m = 0;
+    WeightedEdge *edges = road_network(side, &coords, &m);
+    TaskScheduler *sched = task_scheduler_create(0);
+    WeightedGraph *g = edges && sched ? weighted_graph_create(n, edges, m, true, sched) : NULL;
+    free(edges);
+    if (!g) {
+        fprintf(stderr, "Failed to build graph\n");
+        return 1;
+    }
+    printf("Road network: %u intersections, %zu road segments\n\n", n, m);
+
+    uint64_t *reference = (uint64_t*)malloc((size_t)n * sizeof(uint64_t));
+    uint64_t *dist = (uint64_t*)malloc((size_t)n * sizeof(uint64_t));
+    uint32_t *parent = (uint32_t*)malloc((size_t)n * sizeof(uint32_t));
+    uint32_t source = n / 2 + side / 2;
+
+    printf("single source, all distances       time(s)  mismatches\n");
+    double start = now_seconds();
+    sssp_dijkstra(g, source, reference, parent);
+    printf("Dijkstra, indexed heap            %9.3f\n", now_seconds() - start);
+
+    start = now_seconds();
+    bool ok = sssp_dijkstra_radix(g, source, dist, parent);
+    printf("Dijkstra, radix heap              %9.3f %11d\n", now_seconds() - start,
+           ok ? count_mismatches(reference, dist, n) : -1);
+
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < g->num_arcs; i++) total += g->arcs[i].weight;
+    uint64_t average = total / g->num_arcs;
+    uint64_t deltas[] = { average, average * 8, average * 64 };
+    for (int i = 0; i < 3; i++) {
+        start = now_seconds();
+        sssp_delta_stepping(g, source, deltas[i], dist, NULL);
+        double t_seq = now_seconds() - start;
+        int mismatches = count_mismatches(reference, dist, n);
+        start = now_seconds();
+        sssp_delta_stepping(g, source, deltas[i], dist, sched);
+        double t_par = now_seconds() - start;
+        mismatches += count_mismatches(reference, dist, n);
+        printf("delta-stepping, delta %-6llu      %9.3f %11d   (%d workers: %.3f s)\n",
+               (unsigned long long)deltas[i], t_seq, mismatches, task_scheduler_num_workers(sched), t_par);
+    }
+
+    // 点到点查询：A*(直线距离下界) vs 到达目标即停止的Dijkstra
+    // Point-to-point queries: A* (straight-line bound) vs Dijkstra stopped at the target
+    double t_dijkstra = 0, t_astar = 0;
+    int mismatches = 0;
+    for (int q = 0; q < QUERIES; q++) {
+        uint32_t s = (uint32_t)(next_rand() % n), t = (uint32_t)(next_rand() % n);
+        uint64_t len_dijkstra, len_astar;
+        start = now_seconds();
+        sssp_astar(g, s, t, NULL, NULL, &len_dijkstra, parent);
+        t_dijkstra += now_seconds() - start;
+        start = now_seconds();
+        sssp_astar(g, s, t, straight_line_bound, &coords, &len_astar, parent);
+        t_astar += now_seconds() - start;
+        mismatches += len_dijkstra != len_astar;
+    }
+    printf("\n%d point-to-point queries          time/query  mismatches\n", QUERIES);
+    printf("Dijkstra, stop at target          %9.4f\n", t_dijkstra / QUERIES);
+    printf("A*, straight-line bound           %9.4f %11d   (speedup %.2fx)\n",
+           t_astar / QUERIES, mismatches, t_dijkstra / t_astar);
+
+    free(reference);
+    free(dist);
+    free(parent);
+    free(coords.x);
+    free(coords.y);
+    weighted_graph_free(g);
+    task_scheduler_destroy(sched);
+    return 0;
+}
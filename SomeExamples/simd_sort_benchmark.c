@@ -0,0 +1,113 @@
+#include "simd_sort.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// SIMD 排序（AVX2 / SSE4.1）vs 标量 SORT_DEFINE、quicksort 与 qsort
+// SIMD sorts (AVX2 / SSE4.1) vs the scalar SORT_DEFINE sort, quicksort and qsort
+// quicksort 使用 sort_compare_i32 / sort_compare_f32 时也走 SIMD 内核
+// quicksort with sort_compare_i32 / sort_compare_f32 runs on the SIMD kernels too
+// Build: cc -O2 -I../Algorithm simd_sort_benchmark.c   (no -mavx2 needed)
+
+#define N 10000000
+#define SMALL 48   // 小数组只走排序网络 / small arrays only use the sorting network
+
+enum { AVX2, SSE41, SCALAR, ENGINE, QUICKSORT, QSORT, METHODS };
+
+static const char *method_names[METHODS] = { "AVX2", "SSE4.1", "SORT_DEFINE", "typed cmp", "quicksort", "qsort" };
+
+static int compare_i32(const void *a, const void *b) {
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_f32(const void *a, const void *b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng;
+}
+
+// Sorts every `block`-element chunk of a[0..n) with the given method
+static void sort_i32(int method, int32_t *a, size_t n, size_t block) {
+    for (size_t i = 0; i < n; i += block) {
+        size_t m = n - i < block ? n - i : block;
+        switch (method) {
+        case AVX2: simd_sort_i32_isa(a + i, m, SIMD_SORT_ISA_AVX2); break;
+        case SSE41: simd_sort_i32_isa(a + i, m, SIMD_SORT_ISA_SSE41); break;
+        case SCALAR: simd_sort_scalar_i32_sort(a + i, m); break;
+        case ENGINE: quicksort(a + i, m, sizeof(int32_t), sort_compare_i32); break;
+        case QUICKSORT: quicksort(a + i, m, sizeof(int32_t), compare_i32); break;
+        default: qsort(a + i, m, sizeof(int32_t), compare_i32);
+        }
+    }
+}
+
+static void sort_f32(int method, float *a, size_t n, size_t block) {
+    for (size_t i = 0; i < n; i += block) {
+        size_t m = n - i < block ? n - i : block;
+        switch (method) {
+        case AVX2: simd_sort_f32_isa(a + i, m, SIMD_SORT_ISA_AVX2); break;
+        case SSE41: simd_sort_f32_isa(a + i, m, SIMD_SORT_ISA_SSE41); break;
+        case SCALAR: simd_sort_scalar_f32_sort(a + i, m); break;
+        case ENGINE: quicksort(a + i, m, sizeof(float), sort_compare_f32); break;
+        case QUICKSORT: quicksort(a + i, m, sizeof(float), compare_f32); break;
+        default: qsort(a + i, m, sizeof(float), compare_f32);
+        }
+    }
+}
+
+// Runs every method on a copy of `data` and compares each result with qsort's
+static void run(const char *name, const void *data, void *copy, void *expect, size_t block, int is_float) {
+    memcpy(expect, data, N * sizeof(int32_t));
+    if (is_float) sort_f32(QSORT, (float*)expect, N, block);
+    else sort_i32(QSORT, (int32_t*)expect, N, block);
+
+    printf("%-16s", name);
+    for (int m = 0; m < METHODS; m++) {
+        memcpy(copy, data, N * sizeof(int32_t));
+        clock_t start = clock();
+        if (is_float) sort_f32(m, (float*)copy, N, block);
+        else sort_i32(m, (int32_t*)copy, N, block);
+        double t = seconds_since(start);
+        int ok = memcmp(copy, expect, N * sizeof(int32_t)) == 0;
+        printf(" %9.3f s%s", t, ok ? " " : "!");
+    }
+    printf("\n");
+}
+
+int main() {
+    int32_t *ints = (int32_t*)malloc(N * sizeof(int32_t));
+    float *floats = (float*)malloc(N * sizeof(float));
+    void *copy = malloc(N * sizeof(int32_t));
+    void *expect = malloc(N * sizeof(int32_t));
+    for (size_t i = 0; i < N; i++) {
+        ints[i] = (int32_t)next_rand();
+        floats[i] = (float)(int32_t)next_rand() / 65536.0f;
+    }
+
+    const char *isa_names[] = { "scalar", "SSE4.1", "AVX2" };
+    printf("%d keys, CPU supports %s (! = result differs from qsort)\n", N, isa_names[simd_sort_detect()]);
+    printf("%-16s", "input");
+    for (int m = 0; m < METHODS; m++) printf(" %11s", method_names[m]);
+    printf("\n");
+    run("int32", ints, copy, expect, N, 0);
+    run("float", floats, copy, expect, N, 1);
+    run("int32 x48", ints, copy, expect, SMALL, 0);
+    run("float x48", floats, copy, expect, SMALL, 1);
+
+    free(ints);
+    free(floats);
+    free(copy);
+    free(expect);
+    return 0;
+}
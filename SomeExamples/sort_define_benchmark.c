@@ -0,0 +1,141 @@
+#include "sort.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// SORT_DEFINE 生成的类型专用排序 vs SORT_ARRAY(quicksort) 与 C 库 qsort
+// Type-specialized sorts from SORT_DEFINE vs SORT_ARRAY (quicksort) and qsort
+// Build: cc -O2 -I../Algorithm sort_define_benchmark.c
+
+#define N 2000000
+
+typedef struct {
+    uint32_t key;
+    uint32_t id;
+    double weight;
+} Item;
+
+#define ITEM_LESS(a, b) ((a).key < (b).key)
+
+SORT_DEFINE(int_array, int, SORT_NATURAL_LESS)
+SORT_DEFINE(double_array, double, SORT_NATURAL_LESS)
+SORT_DEFINE(item_array, Item, ITEM_LESS)
+
+static int compare_int(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_item(const void *a, const void *b) {
+    uint32_t x = ((const Item*)a)->key, y = ((const Item*)b)->key;
+    return (x > y) - (x < y);
+}
+
+// SORT_ARRAY 需要真正的数组类型
+// SORT_ARRAY needs real array types
+static int ints[N], int_input[N];
+static double doubles[N], double_input[N];
+static Item items[N], item_input[N];
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng;
+}
+
+static void print_row(const char *name, double t_typed, double t_stable, double t_array, double t_qsort, int ok) {
+    printf("%-14s %9.3f s %9.3f s %9.3f s %9.3f s%s\n", name, t_typed, t_stable, t_array, t_qsort,
+           ok ? "" : "  (MISMATCH)");
+}
+
+int main() {
+    for (int i = 0; i < N; i++) {
+        int_input[i] = (int)(next_rand() & 0x7fffffff);
+        double_input[i] = (double)next_rand() / 4294967296.0 - 0.5;
+        item_input[i].key = next_rand() % (N / 4);   // duplicates make stability visible
+        item_input[i].id = (uint32_t)i;
+        item_input[i].weight = (double)i;
+    }
+    printf("%d elements, random keys\n", N);
+    printf("%-14s %11s %11s %11s %11s\n", "type", "SORT_DEFINE", "stable", "SORT_ARRAY", "qsort");
+
+    clock_t start;
+    double t_typed, t_stable, t_array, t_qsort;
+    int ok = 1;
+
+    memcpy(ints, int_input, sizeof(ints));
+    start = clock();
+    int_array_sort(ints, N);
+    t_typed = seconds_since(start);
+    for (int i = 1; i < N; i++) ok &= ints[i - 1] <= ints[i];
+    memcpy(ints, int_input, sizeof(ints));
+    start = clock();
+    ok &= int_array_stable_sort(ints, N);
+    t_stable = seconds_since(start);
+    for (int i = 1; i < N; i++) ok &= ints[i - 1] <= ints[i];
+    memcpy(ints, int_input, sizeof(ints));
+    start = clock();
+    SORT_ARRAY(ints, compare_int);
+    t_array = seconds_since(start);
+    memcpy(ints, int_input, sizeof(ints));
+    start = clock();
+    qsort(ints, N, sizeof(int), compare_int);
+    t_qsort = seconds_since(start);
+    print_row("int", t_typed, t_stable, t_array, t_qsort, ok);
+
+    memcpy(doubles, double_input, sizeof(doubles));
+    start = clock();
+    double_array_sort(doubles, N);
+    t_typed = seconds_since(start);
+    for (int i = 1; i < N; i++) ok &= doubles[i - 1] <= doubles[i];
+    memcpy(doubles, double_input, sizeof(doubles));
+    start = clock();
+    ok &= double_array_stable_sort(doubles, N);
+    t_stable = seconds_since(start);
+    for (int i = 1; i < N; i++) ok &= doubles[i - 1] <= doubles[i];
+    memcpy(doubles, double_input, sizeof(doubles));
+    start = clock();
+    SORT_ARRAY(doubles, compare_double);
+    t_array = seconds_since(start);
+    memcpy(doubles, double_input, sizeof(doubles));
+    start = clock();
+    qsort(doubles, N, sizeof(double), compare_double);
+    t_qsort = seconds_since(start);
+    print_row("double", t_typed, t_stable, t_array, t_qsort, ok);
+
+    memcpy(items, item_input, sizeof(items));
+    start = clock();
+    item_array_sort(items, N);
+    t_typed = seconds_since(start);
+    for (int i = 1; i < N; i++) ok &= items[i - 1].key <= items[i].key;
+    memcpy(items, item_input, sizeof(items));
+    start = clock();
+    ok &= item_array_stable_sort(items, N);
+    t_stable = seconds_since(start);
+    // 稳定排序：相同键保持原有顺序
+    // Stable: equal keys keep their input order
+    for (int i = 1; i < N; i++) {
+        ok &= items[i - 1].key < items[i].key ||
+              (items[i - 1].key == items[i].key && items[i - 1].id < items[i].id);
+    }
+    memcpy(items, item_input, sizeof(items));
+    start = clock();
+    SORT_ARRAY(items, compare_item);
+    t_array = seconds_since(start);
+    memcpy(items, item_input, sizeof(items));
+    start = clock();
+    qsort(items, N, sizeof(Item), compare_item);
+    t_qsort = seconds_since(start);
+    print_row("16-byte struct", t_typed, t_stable, t_array, t_qsort, ok);
+    return 0;
+}
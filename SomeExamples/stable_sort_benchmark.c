@@ -0,0 +1,101 @@
+#include "stable_sort.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+// 自适应稳定排序(powersort) vs quicksort 与 qsort，重点是接近有序的输入
+// Adaptive stable sort (powersort) vs quicksort and qsort, mostly on nearly sorted input
+// Build: cc -O2 -I../Algorithm stable_sort_benchmark.c
+
+#define N 2000000
+
+typedef struct {
+    int key;
+    int seq;                    // 输入位置，用于检验稳定性 / input position, checks stability
+} Record;
+
+static long comparisons;
+
+static int compare_record(const void *a, const void *b) {
+    int x = ((const Record*)a)->key, y = ((const Record*)b)->key;
+    comparisons++;
+    return (x > y) - (x < y);
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static uint32_t rng = 2463534242u;
+static uint32_t next_rand(void) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    return rng;
+}
+
+static void fill(Record *a, int pattern) {
+    for (int i = 0; i < N; i++) {
+        int key;
+        switch (pattern) {
+        case 0: key = (int)(next_rand() & 0x7fffffff); break;                    // random
+        case 1: key = i; break;                                                  // sorted
+        case 2: key = N - i; break;                                              // reversed
+        case 3: key = (next_rand() % 100 == 0) ? (int)(next_rand() % N) : i; break; // 1% updated
+        case 4: key = i < N - N / 100 ? i : (int)(next_rand() % N); break;       // 1% appended
+        case 5: key = (i / 1000) * 1000 + (int)(next_rand() % 1000); break;      // sorted blocks
+        default: key = (int)(next_rand() % 16);                                  // 16 distinct keys
+        }
+        a[i].key = key;
+        a[i].seq = i;
+    }
+}
+
+static int is_stable_sorted(const Record *a) {
+    for (int i = 1; i < N; i++) {
+        if (a[i - 1].key > a[i].key) return 0;
+        if (a[i - 1].key == a[i].key && a[i - 1].seq > a[i].seq) return 0;
+    }
+    return 1;
+}
+
+int main() {
+    const char *names[] = { "random", "sorted", "reversed", "1% updated",
+                            "1% appended", "sorted blocks", "16 distinct" };
+    Record *data = (Record*)malloc(N * sizeof(Record));
+    Record *copy = (Record*)malloc(N * sizeof(Record));
+    void *scratch = malloc(STABLE_SORT_SCRATCH_SIZE(N, sizeof(Record)));
+
+    printf("%d 8-byte records (time, comparisons per element)\n", N);
+    printf("%-14s %20s %20s %20s\n", "pattern", "stable_sort", "quicksort", "qsort");
+    for (int p = 0; p < 7; p++) {
+        fill(data, p);
+        printf("%-14s", names[p]);
+
+        memcpy(copy, data, N * sizeof(Record));
+        comparisons = 0;
+        clock_t start = clock();
+        stable_sort(copy, N, sizeof(Record), compare_record, scratch);
+        double t = seconds_since(start);
+        int stable = is_stable_sorted(copy);
+        printf(" %9.3f s %7.2f", t, (double)comparisons / N);
+
+        memcpy(copy, data, N * sizeof(Record));
+        comparisons = 0;
+        start = clock();
+        quicksort(copy, N, sizeof(Record), compare_record);
+        t = seconds_since(start);
+        printf(" %9.3f s %7.2f", t, (double)comparisons / N);
+
+        memcpy(copy, data, N * sizeof(Record));
+        comparisons = 0;
+        start = clock();
+        qsort(copy, N, sizeof(Record), compare_record);
+        t = seconds_since(start);
+        printf(" %9.3f s %7.2f%s\n", t, (double)comparisons / N, stable ? "" : "  (NOT STABLE)");
+    }
+
+    free(scratch);
+    free(data);
+    free(copy);
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "stack.h"
+#include "array_stack.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// 对比链式栈(stack.h)与数组栈(array_stack.h)在DFS类负载下的性能
+// Compare the linked Stack with ArrayStack on DFS-style workloads
+
+#define NUM_VERTICES 2000000
+#define AVG_DEGREE   8
+#define PUSH_POP_OPS 20000000
+
+// 稀疏随机图（邻接表以压缩数组存储）
+typedef struct {
+    int numVertices;
+    int* offsets;   // 顶点i的邻居位于 neighbors[offsets[i] .. offsets[i+1])
+    int* neighbors;
+} SparseGraph;
+
+static uint32_t rng_state = 12345u;
+static uint32_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static SparseGraph* graph_random(int numVertices, int degree) {
+    SparseGraph* g = (SparseGraph*)malloc(sizeof(SparseGraph));
+    g->numVertices = numVertices;
+    g->offsets = (int*)malloc((numVertices + 1) * sizeof(int));
+    g->neighbors = (int*)malloc((size_t)numVertices * degree * sizeof(int));
+    for (int i = 0; i <= numVertices; i++) g->offsets[i] = i * degree;
+    for (size_t e = 0; e < (size_t)numVertices * degree; e++) {
+        g->neighbors[e] = (int)(next_rand() % (uint32_t)numVertices);
+    }
+    return g;
+}
+
+static void graph_release(SparseGraph* g) {
+    free(g->offsets);
+    free(g->neighbors);
+    free(g);
+}
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+// 链式栈DFS：每次压栈都要malloc一个节点，并把int转换成指针
+static long dfs_linked(const SparseGraph* g, char* visited, int startVertex) {
+    long order = 0;
+    Stack* s = stack_create();
+    visited[startVertex] = 1;
+    stack_push(s, (void*)(intptr_t)startVertex);
+    while (!stack_isEmpty(s)) {
+        int v = (int)(intptr_t)stack_pop(s);
+        order += v;
+        for (int e = g->offsets[v]; e < g->offsets[v + 1]; e++) {
+            int w = g->neighbors[e];
+            if (!visited[w]) {
+                visited[w] = 1;
+                stack_push(s, (void*)(intptr_t)w);
+            }
+        }
+    }
+    stack_free(s);
+    return order;
+}
+
+// 数组栈DFS：元素按值内联存储，无需逐元素分配
+static long dfs_array(const SparseGraph* g, char* visited, int startVertex) {
+    long order = 0;
+    ArrayStack s;
+    if (!array_stack_init(&s, sizeof(int), 1024)) return -1;
+    visited[startVertex] = 1;
+    array_stack_push(&s, &startVertex);
+    int v;
+    while (array_stack_pop(&s, &v)) {
+        order += v;
+        for (int e = g->offsets[v]; e < g->offsets[v + 1]; e++) {
+            int w = g->neighbors[e];
+            if (!visited[w]) {
+                visited[w] = 1;
+                if (!array_stack_push(&s, &w)) {
+                    array_stack_destroy(&s);
+                    return -1;
+                }
+            }
+        }
+    }
+    array_stack_destroy(&s);
+    return order;
+}
+
+int main() {
+    printf("Building random graph: %d vertices, degree %d\n", NUM_VERTICES, AVG_DEGREE);
+    SparseGraph* g = graph_random(NUM_VERTICES, AVG_DEGREE);
+    char* visited = (char*)malloc(NUM_VERTICES);
+
+    memset(visited, 0, NUM_VERTICES);
+    clock_t start = clock();
+    long linked = dfs_linked(g, visited, 0);
+    double t_linked = seconds_since(start);
+
+    memset(visited, 0, NUM_VERTICES);
+    start = clock();
+    long array = dfs_array(g, visited, 0);
+    double t_array = seconds_since(start);
+
+    printf("DFS   linked Stack : %8.3f s (checksum %ld)\n", t_linked, linked);
+    printf("DFS   ArrayStack   : %8.3f s (checksum %ld)\n", t_array, array);
+    printf("DFS   speedup      : %8.2fx\n", t_array > 0 ? t_linked / t_array : 0.0);
+
+    // 纯压栈/出栈循环
+    start = clock();
+    Stack* ls = stack_create();
+    for (long i = 0; i < PUSH_POP_OPS; i++) {
+        stack_push(ls, (void*)(intptr_t)i);
+        if (i & 1) stack_pop(ls);
+    }
+    stack_free(ls);
+    t_linked = seconds_since(start);
+
+    start = clock();
+    ArrayStack* as = array_stack_create(sizeof(long), 0);
+    for (long i = 0; i < PUSH_POP_OPS; i++) {
+        array_stack_push(as, &i);
+        if (i & 1) array_stack_pop(as, NULL);
+    }
+    array_stack_free(as);
+    t_array = seconds_since(start);
+
+    printf("Churn linked Stack : %8.3f s\n", t_linked);
+    printf("Churn ArrayStack   : %8.3f s\n", t_array);
+    printf("Churn speedup      : %8.2fx\n", t_array > 0 ? t_linked / t_array : 0.0);
+
+    free(visited);
+    graph_release(g);
+    return 0;
+}
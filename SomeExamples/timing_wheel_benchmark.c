@@ -0,0 +1,135 @@
+#include "timing_wheel.h"
+#include "indexed_priority_queue.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+// 定时器频繁变动的负载：分层时间轮 vs 索引最小堆
+// Timer churn workload: hierarchical timing wheel vs indexed min-heap
+//
+// One timeout per connection (1 tick = 1 ms, timeouts 0.1..10 s). Every tick a
+// batch of connections sees activity and pushes its timeout back (cancel +
+// insert), a few close and reopen (cancel + insert), then the clock advances
+// and expired timers fire and are re-armed. As in real servers, most timers
+// are cancelled long before they fire.
+
+#define CONNECTIONS  1000000
+#define TICKS        10000
+#define ACTIVITY     2000
+#define CHURN        200
+
+typedef struct {
+    TimerNode timer;
+    int id;
+} Connection;
+
+static uint32_t rng_state;
+static uint32_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint64_t timeout_ticks(void) {
+    return 100 + next_rand() % 9900;
+}
+
+typedef struct {
+    long fired;
+    uint64_t checksum;
+} Result;
+
+static double seconds_since(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static Result run_wheel(double *seconds) {
+    Result r = { 0, 0 };
+    Connection *conns = (Connection*)malloc(CONNECTIONS * sizeof(Connection));
+    TimingWheel *tw = timing_wheel_create(0, 0, 0);
+    rng_state = 2463534242u;
+
+    clock_t start = clock();
+    for (int i = 0; i < CONNECTIONS; i++) {
+        conns[i].id = i;
+        timer_init(&conns[i].timer, NULL);
+        timing_wheel_add_after(tw, &conns[i].timer, timeout_ticks());
+    }
+    for (int tick = 0; tick < TICKS; tick++) {
+        for (int a = 0; a < ACTIVITY; a++) {
+            Connection *c = &conns[next_rand() % CONNECTIONS];
+            timing_wheel_add_after(tw, &c->timer, timeout_ticks());
+        }
+        for (int a = 0; a < CHURN; a++) {
+            Connection *c = &conns[next_rand() % CONNECTIONS];
+            timing_wheel_cancel(tw, &c->timer);
+            timing_wheel_add_after(tw, &c->timer, timeout_ticks());
+        }
+        TimerList expired;
+        timer_list_init(&expired);
+        timing_wheel_advance(tw, 1, &expired);
+        TimerNode *t;
+        while ((t = timer_list_pop(&expired)) != NULL) {
+            Connection *c = TIMER_CONTAINER_OF(t, Connection, timer);
+            r.fired++;
+            r.checksum += (uint64_t)c->id * (uint64_t)(tick + 1);
+            timing_wheel_add_after(tw, &c->timer, 10000);
+        }
+    }
+    *seconds = seconds_since(start);
+    timing_wheel_free(tw);
+    free(conns);
+    return r;
+}
+
+static Result run_heap(double *seconds) {
+    Result r = { 0, 0 };
+    IndexedPriorityQueue *pq = ipq_create(CONNECTIONS);
+    rng_state = 2463534242u;
+    uint64_t now = 0;
+
+    clock_t start = clock();
+    for (int i = 0; i < CONNECTIONS; i++) {
+        ipq_push(pq, i, (double)(now + timeout_ticks()));
+    }
+    for (int tick = 0; tick < TICKS; tick++) {
+        for (int a = 0; a < ACTIVITY; a++) {
+            int id = (int)(next_rand() % CONNECTIONS);
+            double expires = (double)(now + timeout_ticks());
+            if (!ipq_update(pq, id, expires)) ipq_push(pq, id, expires);
+        }
+        for (int a = 0; a < CHURN; a++) {
+            int id = (int)(next_rand() % CONNECTIONS);
+            ipq_remove_id(pq, id);
+            ipq_push(pq, id, (double)(now + timeout_ticks()));
+        }
+        now++;
+        int id;
+        ipq_key_t key;
+        while (ipq_top(pq, &id, &key) && key <= (double)now) {
+            ipq_pop(pq, NULL, NULL);
+            r.fired++;
+            r.checksum += (uint64_t)id * (uint64_t)(tick + 1);
+            ipq_push(pq, id, (double)(now + 10000));
+        }
+    }
+    *seconds = seconds_since(start);
+    ipq_free(pq);
+    return r;
+}
+
+int main() {
+    double t_wheel, t_heap;
+    Result wheel = run_wheel(&t_wheel);
+    Result heap = run_heap(&t_heap);
+
+    long updates = (long)TICKS * (ACTIVITY + CHURN);
+    printf("%d timers, %d ticks, %ld reschedules/cancellations\n", CONNECTIONS, TICKS, updates);
+    printf("%-22s %9s %10s %20s\n", "method", "time(s)", "fired", "checksum");
+    printf("%-22s %9.3f %10ld %20llu\n", "timing wheel", t_wheel, wheel.fired, (unsigned long long)wheel.checksum);
+    printf("%-22s %9.3f %10ld %20llu\n", "indexed min-heap", t_heap, heap.fired, (unsigned long long)heap.checksum);
+    printf("%s\n", wheel.fired == heap.fired && wheel.checksum == heap.checksum
+                   ? "same timers fired at the same ticks" : "MISMATCH");
+    return 0;
+}